@@ -62,6 +62,12 @@ constexpr System::Clock XARMLIB_SYSTEM_CLOCK { System::Clock::OSC_24MHZ };
 // Uncomment the next line to disable Heap memory allocation functionality
 //#define CPP_NO_HEAP
 
+// Uncomment one of the next lines to serve operator new / delete from the
+// fixed-size block pools or from the init-time bump arena defined below
+// (instead of the newlib malloc)
+//#define XARMLIB_HEAP_POOLS
+//#define XARMLIB_HEAP_ARENA
+
 
 
 
@@ -78,6 +84,17 @@ constexpr Pin::Name   XARMLIB_CONFIG_FAIM_ISP_UART0_RX_PIN { Pin::Name::NC
 
 constexpr Faim::PinConfigArray<0> XARMLIB_CONFIG_FAIM_GPIO_PINS;                     // Use all IOs with pull-up by default
 
+// Maximum number of input handlers registered at run-time in the InputScanner (statically allocated)
+constexpr std::size_t XARMLIB_CONFIG_INPUT_SCANNER_SOURCE_COUNT { 8 };
+
+// Heap size classes used with XARMLIB_HEAP_POOLS (block size in bytes and block count, by increasing block size)
+using XARMLIB_CONFIG_HEAP_POOLS = MemoryPoolSet<MemoryPool< 16, 32>,
+                                                MemoryPool< 64, 16>,
+                                                MemoryPool<256,  4>>;
+
+// Heap arena size in bytes used with XARMLIB_HEAP_ARENA (operator delete doesn't release memory)
+constexpr std::size_t XARMLIB_CONFIG_HEAP_ARENA_SIZE { 4096 };
+
 
 
 
@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+// @file    host_checks.hpp
+// @brief   Host simulation checks (check groups run by the example).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __HOST_CHECKS_HPP
+#define __HOST_CHECKS_HPP
+
+#include <cstdio>
+
+
+
+
+// Print the result of a check (returns the condition)
+inline bool check(const bool condition, const char* description)
+{
+    std::printf("[%s] %s\n", (condition == true) ? " OK " : "FAIL", description);
+    return condition;
+}
+
+// Print the title of a check group
+inline void check_group(const char* title)
+{
+    std::printf("\n-------- %s\n", title);
+}
+
+
+
+
+// Check groups (each one returns true when all its checks pass)
+bool run_driver_checks();
+bool run_dma_checks();
+bool run_vector_table_checks();
+bool run_pin_interrupt_checks();
+bool run_input_scanner_checks();
+bool run_port_debouncer_checks();
+bool run_buffered_usart_checks();
+bool run_timer_wheel_checks();
+bool run_frame_usart_checks();
+bool run_multidrop_usart_checks();
+bool run_tick_converter_checks();
+bool run_memory_pool_checks();
+bool run_crc_checks();
+bool run_flash_kv_store_checks();
+bool run_us_ticker_checks();
+
+
+
+
+#endif // __HOST_CHECKS_HPP
@@ -0,0 +1,180 @@
+// ----------------------------------------------------------------------------
+// @file    check_buffered_usart.cpp
+// @brief   Host simulation checks of the ring buffer and the buffered USART.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// Producer and consumer on two host threads (the ring must deliver every
+// element once and in order without any lock)
+static bool run_ring_buffer_stress(const uint32_t element_count)
+{
+    static RingBuffer<uint32_t, 64> ring;
+
+    std::thread producer([element_count]()
+    {
+        for(uint32_t value = 0; value < element_count;)
+        {
+            if(ring.push(value) == true)
+            {
+                value++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool     in_order = true;
+    uint32_t expected = 0;
+
+    while(expected < element_count)
+    {
+        uint32_t value;
+
+        if(ring.pop(value) == true)
+        {
+            in_order &= (value == expected);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+
+    return in_order == true && ring.is_empty() == true;
+}
+
+
+
+
+bool run_buffered_usart_checks()
+{
+    check_group("BUFFERED USART");
+
+    bool passed = true;
+
+    // -------- RING BUFFER ---------------------------------------------------
+
+    RingBuffer<uint8_t, 8> ring;
+
+    bool filled = true;
+
+    for(uint8_t value = 0; value < 8; ++value)
+    {
+        filled &= ring.push(value);
+    }
+
+    passed &= check(filled == true && ring.is_full() == true && ring.push(8) == false, "Ring buffer full at its capacity");
+
+    // Several laps around the storage (the free running indexes wrap the mask)
+    bool lapped = true;
+
+    for(uint32_t lap = 0; lap < 100; ++lap)
+    {
+        uint8_t value = 0;
+
+        lapped &= ring.pop(value) && value == static_cast<uint8_t>(lap);
+        lapped &= ring.push(static_cast<uint8_t>(lap + 8));
+    }
+
+    passed &= check(lapped == true && ring.size() == 8, "Ring buffer FIFO order across laps");
+
+    ring.clear();
+
+    uint8_t value = 0;
+
+    passed &= check(ring.is_empty() == true && ring.available() == 8 && ring.pop(value) == false, "Ring buffer cleared");
+
+    passed &= check(run_ring_buffer_stress(1000000) == true, "Lock-free producer / consumer threads (1000000 elements)");
+
+    // -------- BUFFERED USART ------------------------------------------------
+
+    BufferedUsart<16, 32> port(Pin::Name::P0_25, Pin::Name::P0_24, 115200, 1);
+
+    port.enable();
+
+    // The write returns at once: the IRQ handler feeds the transmitter
+    const uint8_t tx_message[] = "buffered usart xarmlib";
+    const int32_t tx_size      = sizeof(tx_message) - 1;
+
+    passed &= check(port.write(gsl::span<const uint8_t>(tx_message, tx_size)) == tx_size && port.is_tx_complete() == false,
+                    "Write queued without waiting");
+
+    // 22 characters of 10 bits @ 115200 bps take 1910 us
+    HostSimulator::run_for(2ms);
+
+    uint8_t line[32] {};
+
+    passed &= check(port.is_tx_complete() == true && HostSimulator::read_usart_transmitted(0, line) == tx_size
+                    && std::equal(tx_message, tx_message + tx_size, line), "Queued characters shifted out by the IRQ handler");
+
+    // Write beyond the transmit buffer size
+    uint8_t large[40];
+
+    std::fill(std::begin(large), std::end(large), 'x');
+
+    passed &= check(port.write(large) == 32, "Write limited to the free transmit buffer");
+
+    HostSimulator::run_for(3ms);
+
+    passed &= check(HostSimulator::read_usart_transmitted(0, line) == 32 && port.get_tx_free() == 32, "Transmit buffer drained");
+
+    // Receive beyond the receive buffer size (the excess is dropped and counted)
+    const uint8_t rx_message[] = "received by the usart";
+    const int32_t rx_size      = sizeof(rx_message) - 1;
+
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(rx_message, rx_size));
+    HostSimulator::run_for(2ms);
+
+    uint8_t rx_buffer[32] {};
+
+    passed &= check(port.get_rx_count() == 16 && port.get_rx_dropped_count() == static_cast<uint32_t>(rx_size - 16),
+                    "Received bytes beyond the receive buffer dropped");
+
+    passed &= check(port.read(rx_buffer) == 16 && std::equal(rx_message, rx_message + 16, rx_buffer), "Received bytes read in order");
+
+    return passed;
+}
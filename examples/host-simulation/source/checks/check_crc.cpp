@@ -0,0 +1,265 @@
+// ----------------------------------------------------------------------------
+// @file    check_crc.cpp
+// @brief   Host simulation checks and benchmark of the CRC classes.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <type_traits>
+#include <vector>
+
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+using TableStrategy = CrcTableStrategy;
+
+
+
+
+// The polynomials of the CRC engine resolve to the hardware path, the others
+// fall back to the table path
+static_assert(std::is_same<Crc32,       CrcHardware<uint32_t, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true>>::value, "CRC-32 not on the CRC engine.");
+static_assert(std::is_same<Crc16Modbus, CrcHardware<uint16_t, 0x8005, 0xFFFF, 0x0000, true, true>>::value, "CRC-16/MODBUS not on the CRC engine.");
+static_assert(std::is_same<Crc16Xmodem, CrcHardware<uint16_t, 0x1021, 0x0000, 0x0000, false, false>>::value, "CRC-16/XMODEM not on the CRC engine.");
+static_assert(std::is_same<Crc8,        Crc8Strategy<>>::value, "CRC-8 not on the table path.");
+
+
+
+
+// Standard check input of the CRC catalogue
+static const uint8_t check_input[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525UL + 1013904223UL;
+    return seed >> 8;
+}
+
+static int64_t get_host_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Random test data
+static std::vector<uint8_t> make_buffer(const std::size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> buffer(size);
+
+    for(auto& value : buffer)
+    {
+        value = static_cast<uint8_t>(next_random(seed));
+    }
+
+    return buffer;
+}
+
+// Streaming calculation in random chunks (any alignment and size)
+template <class CrcType>
+static auto calculate_in_chunks(const std::vector<uint8_t>& buffer, uint32_t seed)
+{
+    CrcType crc;
+
+    std::size_t offset = 0;
+
+    while(offset < buffer.size())
+    {
+        std::size_t size = 1 + next_random(seed) % 67;
+
+        size = (offset + size > buffer.size()) ? buffer.size() - offset : size;
+
+        crc.update(gsl::span<const uint8_t>(buffer.data() + offset, size));
+
+        offset += size;
+    }
+
+    return crc.finalize();
+}
+
+// Check value and streaming result of every table strategy
+template <template <TableStrategy> class CrcType, typename Type>
+static bool check_strategies(const Type check_value, const std::vector<uint8_t>& buffer)
+{
+    const Type single = CrcType<TableStrategy::BYTE>::calculate(buffer);
+
+    bool passed = true;
+
+    passed &= CrcType<TableStrategy::NIBBLE>::calculate(check_input)       == check_value;
+    passed &= CrcType<TableStrategy::BYTE>::calculate(check_input)         == check_value;
+    passed &= CrcType<TableStrategy::SLICING_BY_4>::calculate(check_input) == check_value;
+    passed &= CrcType<TableStrategy::SLICING_BY_8>::calculate(check_input) == check_value;
+
+    passed &= CrcType<TableStrategy::NIBBLE>::calculate(buffer)       == single;
+    passed &= CrcType<TableStrategy::SLICING_BY_4>::calculate(buffer) == single;
+    passed &= CrcType<TableStrategy::SLICING_BY_8>::calculate(buffer) == single;
+
+    passed &= calculate_in_chunks<CrcType<TableStrategy::NIBBLE>>(buffer, 1)       == single;
+    passed &= calculate_in_chunks<CrcType<TableStrategy::BYTE>>(buffer, 2)         == single;
+    passed &= calculate_in_chunks<CrcType<TableStrategy::SLICING_BY_4>>(buffer, 3) == single;
+    passed &= calculate_in_chunks<CrcType<TableStrategy::SLICING_BY_8>>(buffer, 4) == single;
+
+    return passed;
+}
+
+
+
+
+// Hardware path equal to the table path: single calls on every size and
+// alignment up to 64 bytes, streaming in random chunks and two calculations
+// interleaved on the engine (reconfigured on every owner change)
+template <class HardwareType, class TableType>
+static bool check_hardware(const std::vector<uint8_t>& buffer)
+{
+    bool passed = true;
+
+    for(std::size_t offset = 0; offset < 4; ++offset)
+    {
+        for(std::size_t size = 0; size <= 64; ++size)
+        {
+            const gsl::span<const uint8_t> data(buffer.data() + offset, size);
+
+            passed &= HardwareType::calculate(data) == TableType::calculate(data);
+        }
+    }
+
+    const auto expected = TableType::calculate(buffer);
+
+    passed &= calculate_in_chunks<HardwareType>(buffer, 5) == expected;
+
+    HardwareType first;
+    HardwareType second;
+
+    for(std::size_t offset = 0; offset < buffer.size(); offset += 100)
+    {
+        const std::size_t size = (offset + 100 > buffer.size()) ? buffer.size() - offset : 100;
+
+        first.update(gsl::span<const uint8_t>(buffer.data() + offset, size));
+        second.update(gsl::span<const uint8_t>(buffer.data() + offset, size));
+    }
+
+    passed &= first.finalize() == expected && second.finalize() == expected;
+
+    return passed;
+}
+
+
+
+
+// Throughput (host MB/s) of a CRC class
+template <class CrcType>
+static void print_throughput(const char* name, const std::vector<uint8_t>& buffer)
+{
+    constexpr int32_t REPEAT_COUNT { 8 };
+
+    CrcType crc;
+
+    const int64_t start_ns = get_host_ns();
+
+    for(int32_t repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+    {
+        crc.update(buffer);
+    }
+
+    const int64_t elapsed_ns = get_host_ns() - start_ns;
+
+    // Keep the result alive
+    volatile auto result = crc.finalize();
+    (void)result;
+
+    const double megabytes_per_second = (elapsed_ns > 0) ? (1000.0 * REPEAT_COUNT * buffer.size()) / elapsed_ns : 0.0;
+
+    std::printf("       %-28s table %5u bytes, %8.1f MB/s\n", name, static_cast<unsigned>(CrcType::get_table_size()), megabytes_per_second);
+}
+
+template <template <TableStrategy> class CrcType>
+static void print_strategies_throughput(const char* name, const std::vector<uint8_t>& buffer)
+{
+    char label[48];
+
+    std::snprintf(label, sizeof(label), "%s nibble", name);
+    print_throughput<CrcType<TableStrategy::NIBBLE>>(label, buffer);
+
+    std::snprintf(label, sizeof(label), "%s byte", name);
+    print_throughput<CrcType<TableStrategy::BYTE>>(label, buffer);
+
+    std::snprintf(label, sizeof(label), "%s slicing-by-4", name);
+    print_throughput<CrcType<TableStrategy::SLICING_BY_4>>(label, buffer);
+
+    std::snprintf(label, sizeof(label), "%s slicing-by-8", name);
+    print_throughput<CrcType<TableStrategy::SLICING_BY_8>>(label, buffer);
+}
+
+
+
+
+bool run_crc_checks()
+{
+    check_group("CRC");
+
+    bool passed = true;
+
+    // -------- TABLE STRATEGIES ----------------------------------------------
+
+    const auto buffer = make_buffer(4099, 2018);
+
+    passed &= check(check_strategies<Crc32Strategy>(uint32_t { 0xCBF43926 }, buffer), "CRC-32: check value and streaming of all the table strategies");
+    passed &= check(check_strategies<Crc16ModbusStrategy>(uint16_t { 0x4B37 }, buffer), "CRC-16/MODBUS: check value and streaming of all the table strategies");
+    passed &= check(check_strategies<Crc16XmodemStrategy>(uint16_t { 0x31C3 }, buffer), "CRC-16/XMODEM: check value and streaming of all the table strategies");
+    passed &= check(check_strategies<Crc8Strategy>(uint8_t { 0xF4 }, buffer), "CRC-8: check value and streaming of all the table strategies");
+    passed &= check(check_strategies<Crc8ItuStrategy>(uint8_t { 0xA1 }, buffer), "CRC-8/ITU: check value and streaming of all the table strategies");
+
+    // -------- HARDWARE CRC ENGINE -------------------------------------------
+
+    passed &= check(check_hardware<Crc32, Crc32Strategy<>>(buffer), "CRC-32: CRC engine equal to the table");
+    passed &= check(check_hardware<Crc16Modbus, Crc16ModbusStrategy<>>(buffer), "CRC-16/MODBUS: CRC engine equal to the table");
+    passed &= check(check_hardware<Crc16Xmodem, Crc16XmodemStrategy<>>(buffer), "CRC-16/XMODEM: CRC engine equal to the table");
+
+    // -------- BENCHMARK -----------------------------------------------------
+
+    // Host throughput (only the relative values matter for the target)
+    const auto large = make_buffer(64 * 1024, 1);
+
+    print_strategies_throughput<Crc32Strategy>("CRC-32", large);
+    print_strategies_throughput<Crc16ModbusStrategy>("CRC-16/MODBUS", large);
+    print_strategies_throughput<Crc16XmodemStrategy>("CRC-16/XMODEM", large);
+    print_strategies_throughput<Crc8Strategy>("CRC-8", large);
+    print_strategies_throughput<Crc8ItuStrategy>("CRC-8/ITU", large);
+
+    // CRC engine feed: simulated register access cycles (word writes)
+    const int64_t start_cycles = HostSimulator::get_cycles();
+
+    Crc32::calculate(large);
+
+    const int64_t engine_cycles = HostSimulator::get_cycles() - start_cycles;
+
+    std::printf("       CRC-32 engine: %lld register access cycles / KB\n", static_cast<long long>(engine_cycles / 64));
+
+    return passed;
+}
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+// @file    check_dma.cpp
+// @brief   Host simulation checks of the DMA transfers (SpiMasterDma, UsartDma).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+#include <optional>
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+namespace
+{
+
+
+
+
+// SPI slave recording the frames sent by the master (answers with a counter)
+class SpiRecorder
+{
+    public:
+
+        uint32_t respond(const uint32_t value)
+        {
+            if(m_count < static_cast<int32_t>(sizeof(m_frames)))
+            {
+                m_frames[m_count] = static_cast<uint8_t>(value);
+            }
+
+            return static_cast<uint32_t>(0x40 + m_count++);
+        }
+
+        void clear() { m_count = 0; }
+
+        int32_t        get_count()  const { return m_count; }
+        const uint8_t* get_frames() const { return m_frames; }
+
+    private:
+
+        uint8_t m_frames[32] {};
+        int32_t m_count      { 0 };
+};
+
+// DMA completion handler counting the calls
+class DmaCompletion
+{
+    public:
+
+        int32_t complete(const DmaChannel::IrqFlags& irq_flags)
+        {
+            m_count++;
+            m_int_a = irq_flags.is_interrupt_a();
+
+            return 0;
+        }
+
+        DmaChannel::IrqHandler get_handler() { return DmaChannel::IrqHandler::create<DmaCompletion, &DmaCompletion::complete>(this); }
+
+        int32_t get_count()       const { return m_count; }
+        bool    is_interrupt_a()  const { return m_int_a; }
+
+    private:
+
+        int32_t m_count { 0 };
+        bool    m_int_a { false };
+};
+
+// NOTE: The DMA descriptors (also inside the drivers) and buffers hold
+//       32-bit addresses, so everything the DMA touches is static.
+std::optional<SpiMasterDma> g_spi;
+std::optional<UsartDma>     g_usart;
+
+SpiRecorder   g_spi_recorder;
+DmaCompletion g_completion;
+
+uint8_t       g_tx_buffer[16];
+uint8_t       g_rx_buffer[16];
+
+
+
+
+} // namespace
+
+
+
+
+bool run_dma_checks()
+{
+    check_group("DMA");
+
+    bool passed = true;
+
+    // -------- SPI MASTER ----------------------------------------------------
+
+    g_spi.emplace(Pin::Name::P0_26, Pin::Name::P0_27, Pin::Name::P0_28, Pin::Name::P0_29, 1000000);
+
+    HostSimulator::set_spi_responder(0, HostSimulator::SpiResponder::create<SpiRecorder, &SpiRecorder::respond>(&g_spi_recorder));
+
+    g_spi->enable();
+
+    for(std::size_t index = 0; index < sizeof(g_tx_buffer); ++index)
+    {
+        g_tx_buffer[index] = static_cast<uint8_t>(0xA0 + index);
+    }
+
+    passed &= check(g_spi->write_async(g_tx_buffer, g_completion.get_handler()) == true, "SPI asynchronous write started");
+
+    // 16 frames of 8 bits @ 1 MHz take 128 us
+    HostSimulator::run_for(50us);
+
+    passed &= check(HostSimulator::is_spi_selected(0) == true && g_spi->is_async_busy() == true, "SPI slave selected while the write is in progress");
+    passed &= check(g_spi->write_async(g_tx_buffer, g_completion.get_handler()) == false, "SPI asynchronous write refused while busy");
+
+    HostSimulator::run_for(150us);
+
+    passed &= check(g_completion.get_count() == 1 && g_completion.is_interrupt_a() == true, "SPI write handler called once (interrupt A)");
+    passed &= check(g_spi_recorder.get_count() == 16 && std::equal(std::begin(g_tx_buffer), std::end(g_tx_buffer), g_spi_recorder.get_frames()), "SPI written frames in order");
+    passed &= check(HostSimulator::is_spi_selected(0) == false, "SPI slave deselected after the last written frame (end of transfer)");
+    passed &= check(g_spi->is_async_busy() == false, "SPI DMA channels idle after the write");
+
+    // Single frame write (the end of transfer descriptor alone)
+    g_spi_recorder.clear();
+
+    g_spi->write_async(gsl::span<const uint8_t>(g_tx_buffer, 1), g_completion.get_handler());
+
+    HostSimulator::run_for(50us);
+
+    passed &= check(g_completion.get_count() == 2 && g_spi_recorder.get_count() == 1 && g_spi_recorder.get_frames()[0] == 0xA0, "SPI single frame write");
+    passed &= check(HostSimulator::is_spi_selected(0) == false, "SPI slave deselected after a single frame write");
+
+    // Read (dummy frames clock the slave answers in)
+    g_spi_recorder.clear();
+
+    std::fill(std::begin(g_rx_buffer), std::end(g_rx_buffer), 0);
+
+    g_spi->read_async(g_rx_buffer, g_completion.get_handler());
+
+    HostSimulator::run_for(200us);
+
+    bool rx_ok = (g_completion.get_count() == 3 && g_spi_recorder.get_count() == 16);
+
+    for(std::size_t index = 0; index < sizeof(g_rx_buffer); ++index)
+    {
+        rx_ok &= (g_rx_buffer[index] == 0x40 + index) && (g_spi_recorder.get_frames()[index] == 0xFF);
+    }
+
+    passed &= check(rx_ok == true, "SPI read buffer filled with the slave answers to dummy frames");
+    passed &= check(HostSimulator::is_spi_selected(0) == false, "SPI slave deselected after the last read frame (end of transfer)");
+
+    // The end of transfer and receive ignore controls don't leak into synchronous transfers
+    g_spi_recorder.clear();
+
+    passed &= check(g_spi->transfer(0x5A) == 0x40 && g_spi_recorder.get_frames()[0] == 0x5A, "SPI synchronous transfer after the asynchronous ones");
+
+    g_spi.reset();
+
+    // -------- USART ---------------------------------------------------------
+
+    g_usart.emplace(Pin::Name::P0_25, Pin::Name::P0_24, 115200);
+
+    g_usart->enable();
+
+    g_usart->write_async(g_tx_buffer, g_completion.get_handler());
+
+    // 16 characters of 10 bits @ 115200 bps take 1389 us
+    HostSimulator::run_for(1500us);
+
+    uint8_t line[32] {};
+
+    const int32_t line_count = HostSimulator::read_usart_transmitted(0, line);
+
+    passed &= check(g_completion.get_count() == 4 && line_count == 16 && std::equal(std::begin(g_tx_buffer), std::end(g_tx_buffer), line), "USART characters written through DMA");
+
+    g_usart.reset();
+
+    return passed;
+}
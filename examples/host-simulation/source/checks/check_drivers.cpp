@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------
+// @file    check_drivers.cpp
+// @brief   Host simulation checks of the basic drivers (Timer, GPIO, Usart, Spi...).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+class Blinker : public Timer
+{
+    public:
+
+        Blinker(const Pin::Name pin_name) : m_output(pin_name, DigitalOut::OutputMode::PUSH_PULL_HIGH)
+        {
+            auto handler = Timer::IrqHandler::create<Blinker, &Blinker::toggle>(this);
+            assign_irq_handler(handler);
+
+            enable_irq();
+        }
+
+        int32_t get_toggle_count() const { return m_toggle_count; }
+
+    private:
+
+        int32_t toggle()
+        {
+            m_output = !m_output;
+            m_toggle_count++;
+
+            return 0;
+        }
+
+        DigitalOut m_output;
+        int32_t    m_toggle_count { 0 };
+};
+
+
+
+
+bool run_driver_checks()
+{
+    check_group("DRIVERS");
+
+    bool passed = true;
+
+    // -------- TIMER / GPIO --------------------------------------------------
+
+    Blinker led(Pin::Name::P0_12);
+
+    led.start(100ms, Timer::Mode::FREE_RUNNING);
+
+    HostSimulator::run_for(1050ms);
+
+    passed &= check(led.get_toggle_count() == 10, "Timer IRQ toggles the LED every 100 ms");
+    passed &= check(HostSimulator::get_pin_level(Pin::Name::P0_12) == true, "LED pin level after an even number of toggles");
+
+    led.stop();
+
+    // -------- MICROSECONDS TICKER -------------------------------------------
+
+    const auto start = UsTicker::now();
+
+    UsTicker::wait(2500us);
+
+    const auto elapsed = UsTicker::now() - start;
+
+    passed &= check(elapsed >= 2500us && elapsed < 2600us, "Microseconds ticker wait duration");
+
+    // -------- DIGITAL INPUT -------------------------------------------------
+
+    DigitalIn button(Pin::Name::P0_4, DigitalIn::InputMode::PULL_UP);
+
+    passed &= check(button == 1, "Input pin pulled-up");
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_4, false);
+
+    passed &= check(button == 0, "Input pin driven low");
+
+    // -------- USART ---------------------------------------------------------
+
+    Usart usart(Pin::Name::P0_25, Pin::Name::P0_24, 115200);
+
+    usart.enable();
+
+    const uint8_t tx_message[] = { 'x', 'a', 'r', 'm' };
+
+    usart.write_buffer(tx_message, 10ms);
+
+    while(usart.is_tx_idle() == false)
+    {}
+
+    uint8_t line[8] {};
+
+    const int32_t line_count = HostSimulator::read_usart_transmitted(0, line);
+
+    passed &= check(line_count == 4 && std::equal(std::begin(tx_message), std::end(tx_message), line), "USART characters shifted out on TX");
+
+    const uint8_t rx_message[] = { 'l', 'i', 'b' };
+
+    HostSimulator::receive_usart_data(0, rx_message);
+
+    uint8_t rx_buffer[3] {};
+
+    const auto rx_start = UsTicker::now();
+
+    const int32_t rx_count = usart.read_buffer(rx_buffer, 10ms);
+
+    const auto rx_elapsed = UsTicker::now() - rx_start;
+
+    passed &= check(rx_count == 3 && std::equal(std::begin(rx_message), std::end(rx_message), rx_buffer), "USART characters received on RX");
+
+    // 3 characters of 10 bits @ 115200 bps take 260 us
+    passed &= check(rx_elapsed >= 250us && rx_elapsed < 300us, "USART character time");
+
+    // -------- SPI -----------------------------------------------------------
+
+    SpiMaster spi(Pin::Name::P0_26, Pin::Name::P0_27, Pin::Name::P0_28, 1000000);
+
+    struct Responder
+    {
+        uint32_t respond(const uint32_t value) { return value ^ 0xFF; }
+    } responder;
+
+    HostSimulator::set_spi_responder(0, HostSimulator::SpiResponder::create<Responder, &Responder::respond>(&responder));
+
+    spi.enable();
+
+    passed &= check(spi.transfer(0x5A) == 0xA5, "SPI frame answered by the slave responder");
+
+    return passed;
+}
@@ -0,0 +1,326 @@
+// ----------------------------------------------------------------------------
+// @file    check_flash_kv_store.cpp
+// @brief   Host simulation checks and benchmark of the flash key-value store.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace xarmlib;
+
+using HostFlash = targets::lpc84x::HostFlash;
+
+
+
+
+// Store in the last sectors of the simulated flash
+using KvStore = FlashKvStore<HostFlash, 32>;
+
+constexpr int32_t  STORE_FIRST_SECTOR { 48 };
+constexpr int32_t  STORE_SECTOR_COUNT { 4 };
+constexpr uint16_t KEY_COUNT          { 24 };
+
+// Reference contents (value per key, no entry if removed)
+using Contents = std::map<uint16_t, std::vector<uint8_t>>;
+
+// Values a key may hold after a power failure (std::nullopt if removed)
+using Candidates = std::map<uint16_t, std::vector<std::optional<std::vector<uint8_t>>>>;
+
+constexpr int32_t ENDURANCE_OP_COUNT     { 50000 };
+constexpr int32_t ENDURANCE_VERIFY_EVERY { 2500 };
+constexpr int32_t POWER_FAIL_TRIAL_COUNT { 1000 };
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525UL + 1013904223UL;
+    return seed >> 8;
+}
+
+static int64_t get_host_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::vector<uint8_t> make_value(uint32_t& seed)
+{
+    std::vector<uint8_t> value(next_random(seed) % (KvStore::MAX_VALUE_SIZE + 1));
+
+    for(auto& byte : value)
+    {
+        byte = static_cast<uint8_t>(next_random(seed));
+    }
+
+    return value;
+}
+
+static std::optional<std::vector<uint8_t>> read_value(const KvStore& store, const uint16_t key)
+{
+    std::array<uint8_t, KvStore::MAX_VALUE_SIZE> buffer;
+
+    const int32_t size = store.read(key, buffer);
+
+    if(size < 0)
+    {
+        return std::nullopt;
+    }
+
+    return std::vector<uint8_t>(buffer.begin(), buffer.begin() + size);
+}
+
+static Contents read_contents(const KvStore& store)
+{
+    Contents contents;
+
+    for(uint16_t key = 0; key < KEY_COUNT; ++key)
+    {
+        const auto value = read_value(store, key);
+
+        if(value.has_value() == true)
+        {
+            contents[key] = *value;
+        }
+    }
+
+    return contents;
+}
+
+
+
+
+// Random writes / removes against a reference map, mounting the store again
+// periodically (the committed contents must be found by a fresh open)
+static bool check_endurance()
+{
+    HostFlash::erase_all();
+
+    KvStore store(STORE_FIRST_SECTOR, STORE_SECTOR_COUNT);
+
+    bool passed = store.format();
+
+    Contents reference;
+    uint32_t seed = 1;
+
+    const int64_t start_ns = get_host_ns();
+
+    for(int32_t op = 1; op <= ENDURANCE_OP_COUNT && passed == true; ++op)
+    {
+        const uint16_t key = static_cast<uint16_t>(next_random(seed) % KEY_COUNT);
+
+        if(next_random(seed) % 10 == 0)
+        {
+            passed &= (store.remove(key) == (reference.erase(key) > 0));
+        }
+        else
+        {
+            const auto value = make_value(seed);
+
+            passed &= store.write(key, value);
+            reference[key] = value;
+        }
+
+        if(next_random(seed) % 8 == 0)
+        {
+            passed &= store.commit();
+        }
+
+        if(op % ENDURANCE_VERIFY_EVERY == 0)
+        {
+            passed &= store.commit();
+
+            KvStore reopened(STORE_FIRST_SECTOR, STORE_SECTOR_COUNT);
+
+            passed &= reopened.open() && read_contents(reopened) == reference && read_contents(store) == reference;
+        }
+    }
+
+    const int64_t elapsed_ns = get_host_ns() - start_ns;
+
+    passed &= check(HostFlash::get_page_reprogram_count() == 0, "No page programmed twice without an erase");
+
+    int32_t min_erase_count = HostFlash::get_sector_erase_count(STORE_FIRST_SECTOR);
+    int32_t max_erase_count = min_erase_count;
+    int32_t erase_count     = 0;
+
+    for(int32_t sector = STORE_FIRST_SECTOR; sector < STORE_FIRST_SECTOR + STORE_SECTOR_COUNT; ++sector)
+    {
+        min_erase_count = std::min(min_erase_count, HostFlash::get_sector_erase_count(sector));
+        max_erase_count = std::max(max_erase_count, HostFlash::get_sector_erase_count(sector));
+        erase_count    += HostFlash::get_sector_erase_count(sector);
+    }
+
+    passed &= check(max_erase_count - min_erase_count <= 1, "Sector erases evenly spread (wear levelling)");
+
+    std::printf("       %d operations: %lld page programs, %d sector erases (min %d, max %d per sector)\n",
+                static_cast<int>(ENDURANCE_OP_COUNT), static_cast<long long>(HostFlash::get_page_program_count()),
+                static_cast<int>(erase_count), static_cast<int>(min_erase_count), static_cast<int>(max_erase_count));
+    std::printf("       %.1f operations / sector erase, %.2f us / operation (host)\n",
+                static_cast<double>(ENDURANCE_OP_COUNT) / std::max(erase_count, 1),
+                static_cast<double>(elapsed_ns) / 1000.0 / ENDURANCE_OP_COUNT);
+
+    return passed;
+}
+
+
+
+
+// Random operations interrupted by a power failure: the store must mount
+// again, the keys untouched since the last commit must keep their committed
+// value and the others must hold a value written since then (or the committed one)
+static bool check_power_fail()
+{
+    HostFlash::erase_all();
+
+    {
+        KvStore store(STORE_FIRST_SECTOR, STORE_SECTOR_COUNT);
+
+        store.format();
+    }
+
+    int32_t  open_failures  = 0;
+    int32_t  value_failures = 0;
+    uint32_t seed           = 2;
+
+    for(int32_t trial = 0; trial < POWER_FAIL_TRIAL_COUNT; ++trial)
+    {
+        KvStore store(STORE_FIRST_SECTOR, STORE_SECTOR_COUNT);
+
+        if(store.open() == false)
+        {
+            // Already counted as a failure by the previous trial
+            store.format();
+        }
+
+        Contents   committed = read_contents(store);
+        Candidates candidates;
+
+        HostFlash::set_power_fail(next_random(seed) % 60);
+
+        for(int32_t op = 0; op < 200 && HostFlash::is_power_failed() == false; ++op)
+        {
+            const uint16_t key = static_cast<uint16_t>(next_random(seed) % KEY_COUNT);
+
+            auto& key_candidates = candidates[key];
+
+            if(key_candidates.empty() == true)
+            {
+                const auto value = committed.find(key);
+
+                key_candidates.push_back((value != committed.end()) ? std::optional<std::vector<uint8_t>> { value->second }
+                                                                    : std::nullopt);
+            }
+
+            if(next_random(seed) % 10 == 0)
+            {
+                store.remove(key);
+                key_candidates.push_back(std::nullopt);
+            }
+            else
+            {
+                const auto value = make_value(seed);
+
+                store.write(key, value);
+                key_candidates.push_back(value);
+            }
+
+            if(next_random(seed) % 4 == 0 && store.commit() == true && HostFlash::is_power_failed() == false)
+            {
+                committed = read_contents(store);
+                candidates.clear();
+            }
+        }
+
+        HostFlash::restore_power();
+
+        KvStore reopened(STORE_FIRST_SECTOR, STORE_SECTOR_COUNT);
+
+        if(reopened.open() == false)
+        {
+            open_failures++;
+            continue;
+        }
+
+        for(uint16_t key = 0; key < KEY_COUNT; ++key)
+        {
+            const auto value = read_value(reopened, key);
+            const auto entry = candidates.find(key);
+
+            bool expected;
+
+            if(entry == candidates.end())
+            {
+                const auto committed_value = committed.find(key);
+
+                expected = (committed_value == committed.end()) ? (value.has_value() == false)
+                                                                : (value.has_value() == true && *value == committed_value->second);
+            }
+            else
+            {
+                expected = std::find(entry->second.begin(), entry->second.end(), value) != entry->second.end();
+            }
+
+            if(expected == false)
+            {
+                value_failures++;
+                break;
+            }
+        }
+    }
+
+    bool passed = true;
+
+    passed &= check(open_failures == 0, "Store mounted again after every power failure");
+    passed &= check(value_failures == 0, "Committed values kept, interrupted keys hold a written value");
+    passed &= check(HostFlash::get_page_reprogram_count() == 0, "No page programmed twice without an erase");
+
+    std::printf("       %d power failures: %d mount failures, %d trials with wrong values\n",
+                static_cast<int>(POWER_FAIL_TRIAL_COUNT), static_cast<int>(open_failures), static_cast<int>(value_failures));
+
+    return passed;
+}
+
+
+
+
+bool run_flash_kv_store_checks()
+{
+    check_group("FLASH KEY-VALUE STORE");
+
+    bool passed = true;
+
+    passed &= check(check_endurance() == true, "Random writes / removes equal to the reference after every mount");
+    passed &= check_power_fail();
+
+    return passed;
+}
@@ -0,0 +1,142 @@
+// ----------------------------------------------------------------------------
+// @file    check_frame_usart.cpp
+// @brief   Host simulation checks of the frame gap USART receiver.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// Frames delivered by the frame handler (called from the timer ISR)
+struct FrameRecorder
+{
+    int32_t on_frame(const gsl::span<const uint8_t> frame)
+    {
+        frame_count++;
+        last_size = static_cast<int32_t>(frame.size());
+        last_us   = UsTicker::now().count();
+
+        std::copy(frame.begin(), frame.end(), last_frame);
+
+        return 0;
+    }
+
+    int32_t frame_count { 0 };
+    int32_t last_size   { 0 };
+    int64_t last_us     { 0 };
+    uint8_t last_frame[8] {};
+};
+
+
+
+
+bool run_frame_usart_checks()
+{
+    check_group("FRAME USART");
+
+    bool passed = true;
+
+    FrameRecorder recorder;
+
+    // 10 bit characters @ 19200 bps (521 us) and the Modbus RTU gap (3.5 characters of 11 bits: 2006 us, rounded up)
+    constexpr auto frame_gap = FrameUsart<8>::get_modbus_rtu_frame_gap(19200);
+
+    FrameUsart<8> port(Pin::Name::P0_25, Pin::Name::P0_24, 19200, 1, frame_gap,
+                       FrameUsart<8>::FrameHandler::create<FrameRecorder, &FrameRecorder::on_frame>(&recorder));
+
+    port.enable();
+
+    passed &= check(frame_gap == 2006us, "Modbus RTU frame gap @ 19200 bps");
+
+    // -------- FRAME COMPLETED BY THE GAP ------------------------------------
+
+    const uint8_t data[] = { 0x01, 0x03, 0x00, 0x10, 0x00, 0x02 };
+
+    const int64_t start_us = UsTicker::now().count();
+
+    HostSimulator::receive_usart_data(0, data);
+
+    // Last character received at 6 x 521 = 3125 us
+    HostSimulator::run_for(3125us + 1900us);
+
+    passed &= check(recorder.frame_count == 0, "Frame not delivered before the frame gap");
+
+    HostSimulator::run_for(500us);
+
+    const int64_t delivered_us = recorder.last_us - start_us;
+
+    passed &= check(recorder.frame_count == 1 && recorder.last_size == 6
+                    && std::equal(std::begin(data), std::end(data), recorder.last_frame), "Frame delivered after the frame gap");
+
+    passed &= check(delivered_us >= 3125 + 2006 && delivered_us < 3125 + 2006 + 200, "Frame gap measured from the last character");
+
+    // -------- INTER-CHARACTER SILENCE SHORTER THAN THE GAP ------------------
+
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 3));
+    HostSimulator::run_for(1563us + 1500us);
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data + 3, 3));
+    HostSimulator::run_for(1563us + 2500us);
+
+    passed &= check(recorder.frame_count == 2 && recorder.last_size == 6, "Silence shorter than the gap keeps a single frame");
+
+    // -------- TWO FRAMES SEPARATED BY THE GAP -------------------------------
+
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 2));
+    HostSimulator::run_for(1042us + 2500us);
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 4));
+    HostSimulator::run_for(2084us + 2500us);
+
+    passed &= check(recorder.frame_count == 4 && recorder.last_size == 4, "Frames separated by the gap delivered apart");
+
+    // -------- FRAME LARGER THAN THE BUFFER ----------------------------------
+
+    const uint8_t large[10] {};
+
+    HostSimulator::receive_usart_data(0, large);
+    HostSimulator::run_for(5210us + 2500us);
+
+    passed &= check(recorder.frame_count == 4 && port.get_frame_dropped_count() == 1, "Frame larger than the buffer dropped");
+
+    // Next frame received normally
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 1));
+    HostSimulator::run_for(521us + 2500us);
+
+    passed &= check(recorder.frame_count == 5 && recorder.last_size == 1, "Frame after a dropped one delivered");
+
+    return passed;
+}
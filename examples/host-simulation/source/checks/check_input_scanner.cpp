@@ -0,0 +1,155 @@
+// ----------------------------------------------------------------------------
+// @file    check_input_scanner.cpp
+// @brief   Host simulation checks of the InputScanner and PortDebouncer classes.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// Keys on P0_6 and P0_7 (active low with the default pull-ups), debounced
+// with 4 consecutive samples. The debouncer is registered in the run-time
+// handler table of the scanner, so it must outlive the checks.
+constexpr uint32_t      KEY_A_MASK { 1UL << 6 };
+constexpr uint32_t      KEY_B_MASK { 1UL << 7 };
+constexpr uint32_t      KEYS_MASK  { KEY_A_MASK | KEY_B_MASK };
+static PortDebouncer<3> keys(Port::Name::PORT0, KEYS_MASK, 4, KEYS_MASK);
+
+static int32_t pin_change_count   { 0 };
+static int32_t scan_start_count   { 0 };
+static int32_t scan_end_count     { 0 };
+static int32_t table_first_count  { 0 };
+static int32_t table_second_count { 0 };
+
+static int32_t on_pin_change()
+{
+    pin_change_count++;
+    return 0;
+}
+
+static void on_scan(const bool start)
+{
+    (start == true) ? scan_start_count++ : scan_end_count++;
+}
+
+// Compile-time table handlers (the first one always reports a new input,
+// the second one must be called anyway)
+static bool table_first()
+{
+    table_first_count++;
+    return true;
+}
+
+static bool table_second()
+{
+    table_second_count++;
+    return false;
+}
+
+
+
+
+bool run_input_scanner_checks()
+{
+    check_group("INPUT SCANNER");
+
+    bool passed = true;
+
+    // -------- RUN-TIME HANDLERS (PORT DEBOUNCER) ----------------------------
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_6, true);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_7, true);
+
+    InputScanner::add_port_debouncer(keys);
+    InputScanner::assign_pin_change_handler(InputScanner::PinChangeHandler::create<&on_pin_change>());
+    InputScanner::assign_scan_hook(InputScanner::ScanHook::create<&on_scan>());
+
+    // Scans at 1, 2, 3, 4... ms from the start (16 scans up to the stop)
+    InputScanner::start(1ms);
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_6, false);
+
+    HostSimulator::run_for(2500us);
+
+    passed &= check(keys.get_state() == 0 && pin_change_count == 0, "Key not reported before the debounce depth");
+
+    HostSimulator::run_for(2000us);
+
+    passed &= check(keys.get_state() == KEY_A_MASK && keys.get_pressed() == KEY_A_MASK && pin_change_count == 1,
+                    "Key pressed after 4 consecutive samples");
+
+    // A glitch shorter than the debounce depth is ignored
+    HostSimulator::set_pin_input_level(Pin::Name::P0_7, false);
+    HostSimulator::run_for(2000us);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_7, true);
+    HostSimulator::run_for(5000us);
+
+    passed &= check(keys.get_state() == KEY_A_MASK && pin_change_count == 1, "Glitch shorter than the debounce depth ignored");
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_6, true);
+    HostSimulator::run_for(5000us);
+
+    passed &= check(keys.get_state() == 0 && pin_change_count == 2, "Key released after 4 consecutive samples");
+
+    passed &= check(scan_start_count == 16 && scan_end_count == 16, "Scan hook called at the start and end of every scan");
+
+    InputScanner::stop();
+
+    const int32_t stopped_scan_count = scan_start_count;
+
+    HostSimulator::run_for(5000us);
+
+    passed &= check(InputScanner::is_running() == false && scan_start_count == stopped_scan_count, "No scans after stop");
+
+    InputScanner::remove_scan_hook();
+
+    // -------- COMPILE-TIME HANDLER TABLE ------------------------------------
+
+    pin_change_count = 0;
+
+    InputScanner::start<InputScanner::InputHandlerTable<&table_first, &table_second>>(1ms);
+
+    HostSimulator::run_for(10500us);
+
+    InputScanner::stop();
+
+    passed &= check(table_first_count == 10 && table_second_count == 10, "Every handler of the compile-time table scanned");
+    passed &= check(pin_change_count == 10, "Pin change handler called on every new input");
+
+    InputScanner::remove_pin_change_handler();
+
+    return passed;
+}
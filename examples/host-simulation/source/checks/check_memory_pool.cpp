@@ -0,0 +1,265 @@
+// ----------------------------------------------------------------------------
+// @file    check_memory_pool.cpp
+// @brief   Host simulation checks of the memory pools, arena and allocator.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include "system/dynarray"
+#include "system/memory_pool"
+
+#include <algorithm>
+
+using namespace xarmlib;
+
+
+
+
+namespace
+{
+
+
+
+
+// Element counting its constructions / destructions
+struct Tracked
+{
+    static int32_t constructed;
+    static int32_t destroyed;
+
+    Tracked()                         : value { -1 }            { constructed++; }
+    Tracked(const int32_t init_value) : value { init_value }    { constructed++; }
+    Tracked(const Tracked& other)     : value { other.value }   { constructed++; }
+    ~Tracked()                                                  { destroyed++; }
+
+    Tracked& operator = (const Tracked& other) = default;
+
+    int32_t value;
+};
+
+int32_t Tracked::constructed { 0 };
+int32_t Tracked::destroyed   { 0 };
+
+bool is_aligned(const void* ptr, const std::size_t alignment)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) % alignment) == 0;
+}
+
+
+
+
+} // namespace
+
+
+
+
+bool run_memory_pool_checks()
+{
+    check_group("MEMORY POOLS");
+
+    bool passed = true;
+
+    // -------- FIXED-SIZE BLOCK POOL -----------------------------------------
+
+    using Pool = MemoryPool<24, 4>;
+
+    static Pool pool;
+
+    passed &= check(Pool::BLOCK_SIZE >= 24 && (Pool::BLOCK_SIZE % alignof(std::max_align_t)) == 0, "Pool block size rounded up to the maximum alignment");
+
+    void* blocks[4] {};
+
+    bool blocks_ok = true;
+
+    for(auto& block : blocks)
+    {
+        block = pool.allocate(24);
+
+        blocks_ok &= (block != nullptr && pool.owns(block) == true && is_aligned(block, alignof(std::max_align_t)) == true);
+    }
+
+    std::sort(std::begin(blocks), std::end(blocks));
+
+    passed &= check(blocks_ok == true && std::adjacent_find(std::begin(blocks), std::end(blocks)) == std::end(blocks), "Pool serves distinct aligned blocks until exhausted");
+
+    passed &= check(pool.allocate(1) == nullptr && pool.get_stats().failures == 1, "Exhausted pool fails the allocation (failure counted)");
+    passed &= check(pool.allocate(Pool::BLOCK_SIZE + 1) == nullptr && pool.get_stats().failures == 2, "Oversized request fails (failure counted)");
+
+    const int32_t outside = 0;
+
+    passed &= check(pool.owns(static_cast<uint8_t*>(blocks[0]) + 1) == false && pool.owns(&outside) == false, "Pool doesn't own pointers inside a block or outside the pool");
+
+    // Free list: the last released block is the first one reused
+    pool.deallocate(blocks[2]);
+    pool.deallocate(blocks[1]);
+
+    passed &= check(pool.get_stats().used == 2 * Pool::BLOCK_SIZE, "Released blocks not counted as used");
+
+    void* const reused_first  = pool.allocate(8);
+    void* const reused_second = pool.allocate(8);
+
+    passed &= check(reused_first == blocks[1] && reused_second == blocks[2], "Released blocks reused from the free list (last released first)");
+
+    for(auto block : blocks)
+    {
+        pool.deallocate(block);
+    }
+
+    const MemoryStats pool_stats = pool.get_stats();
+
+    passed &= check(pool_stats.capacity == 4 * Pool::BLOCK_SIZE && pool_stats.used == 0 && pool_stats.high_water_mark == 4 * Pool::BLOCK_SIZE,
+                    "Pool statistics (capacity, used and high-water mark kept after release)");
+
+    // -------- SIZE CLASSES --------------------------------------------------
+
+    using SmallPool = MemoryPool<16, 2>;
+    using LargePool = MemoryPool<64, 2>;
+
+    static MemoryPoolSet<SmallPool, LargePool> pool_set;
+
+    void* const small_a = pool_set.allocate(8);
+    void* const small_b = pool_set.allocate(8);
+
+    passed &= check(pool_set.get_pool<0>().owns(small_a) == true && pool_set.get_pool<0>().owns(small_b) == true, "Small requests served by the smallest class");
+
+    void* const fallback = pool_set.allocate(8);
+
+    passed &= check(pool_set.get_pool<1>().owns(fallback) == true, "Exhausted class falls back to the next larger class");
+
+    void* const large = pool_set.allocate(LargePool::BLOCK_SIZE);
+
+    passed &= check(pool_set.get_pool<1>().owns(large) == true && pool_set.get_stats().failures == 0, "Large request served by the larger class");
+
+    passed &= check(pool_set.allocate(8) == nullptr && pool_set.get_stats().failures == 1, "Request no class can serve fails (failure counted once)");
+    passed &= check(pool_set.allocate(LargePool::BLOCK_SIZE + 1) == nullptr && pool_set.get_stats().failures == 2, "Request larger than every class fails");
+
+    pool_set.deallocate(small_a);
+    pool_set.deallocate(fallback);
+
+    passed &= check(pool_set.get_pool<0>().get_stats().used == SmallPool::BLOCK_SIZE && pool_set.get_pool<1>().get_stats().used == LargePool::BLOCK_SIZE,
+                    "Blocks released to the class they belong to");
+
+    passed &= check(pool_set.allocate(8) == small_a, "Released small block reused before the larger class");
+
+    const MemoryStats set_stats = pool_set.get_stats();
+
+    passed &= check(set_stats.capacity == 2 * SmallPool::BLOCK_SIZE + 2 * LargePool::BLOCK_SIZE
+                    && set_stats.high_water_mark == 2 * SmallPool::BLOCK_SIZE + 2 * LargePool::BLOCK_SIZE,
+                    "Pool set statistics (sum of the classes high-water marks)");
+
+    pool_set.deallocate(small_a);
+    pool_set.deallocate(small_b);
+    pool_set.deallocate(large);
+
+    passed &= check(pool_set.get_stats().used == 0, "Pool set empty after releasing every block");
+
+    // -------- BUMP ARENA ----------------------------------------------------
+
+    static MemoryArena<128> arena;
+
+    void* const byte_ptr  = arena.allocate(1, 1);
+    void* const word_ptr  = arena.allocate(4, 8);
+    void* const line_ptr  = arena.allocate(8, 64);
+    void* const max_ptr   = arena.allocate(2);
+
+    passed &= check(is_aligned(word_ptr, 8) == true && static_cast<uint8_t*>(word_ptr) - static_cast<uint8_t*>(byte_ptr) == 8
+                    && is_aligned(line_ptr, 64) == true && is_aligned(max_ptr, alignof(std::max_align_t)) == true,
+                    "Arena allocations aligned as requested (padding only as needed)");
+
+    const std::size_t arena_used = arena.get_stats().used;
+
+    passed &= check(arena.allocate(128) == nullptr && arena.get_stats().failures == 1 && arena.get_stats().used == arena_used, "Arena overflow fails without consuming space");
+
+    arena.deallocate(word_ptr);
+
+    passed &= check(arena.get_stats().used == arena_used, "Arena ignores individual deallocations");
+
+    arena.reset();
+
+    passed &= check(arena.get_stats().used == 0 && arena.get_stats().high_water_mark == arena_used && arena.allocate(1, 1) == byte_ptr,
+                    "Arena reset releases everything (high-water mark kept)");
+
+    passed &= check(arena.allocate(127, 1) != nullptr && arena.get_stats().used == 128, "Arena fills up to its capacity");
+
+    arena.reset();
+
+    // -------- TYPED ALLOCATOR / DYNARRAY ------------------------------------
+
+    using TrackedPool      = MemoryPool<4 * sizeof(Tracked), 2>;
+    using TrackedAllocator = MemoryAllocator<Tracked, TrackedPool>;
+
+    static TrackedPool tracked_pool;
+
+    const TrackedAllocator allocator { tracked_pool };
+
+    const MemoryAllocator<uint8_t, TrackedPool> rebound { allocator };
+
+    passed &= check(rebound == allocator && (allocator != TrackedAllocator { tracked_pool }) == false, "Rebound allocators of the same resource are equal");
+
+    {
+        dynarray<Tracked> defaults(4, allocator);
+
+        passed &= check(Tracked::constructed == 4 && tracked_pool.owns(defaults.data()) == true && defaults[3].value == -1,
+                        "dynarray elements default constructed in the pool");
+
+        dynarray<Tracked> filled(3, Tracked { 7 }, allocator);
+
+        passed &= check(std::all_of(filled.begin(), filled.end(), [](const Tracked& element) { return element.value == 7; }) == true
+                        && tracked_pool.get_stats().used == 2 * TrackedPool::BLOCK_SIZE,
+                        "dynarray elements copy constructed from a value in the pool");
+
+        passed &= check(Tracked::destroyed == 1, "Only the temporary value destroyed while the dynarrays are alive");
+
+        dynarray<Tracked> moved { std::move(filled) };
+
+        passed &= check(moved.size() == 3 && moved[0].value == 7, "dynarray moved with its allocator");
+    }
+
+    passed &= check(Tracked::constructed == Tracked::destroyed && tracked_pool.get_stats().used == 0,
+                    "dynarray elements destroyed and storage returned to the pool (once)");
+
+    {
+        MemoryArena<256> tracked_arena;
+
+        MemoryAllocator<Tracked, MemoryArena<256>> arena_allocator { tracked_arena };
+
+        dynarray<Tracked> list({ Tracked { 1 }, Tracked { 2 }, Tracked { 3 } }, arena_allocator);
+
+        dynarray<Tracked> copy(list, arena_allocator);
+
+        passed &= check(copy.size() == 3 && copy[0].value == 1 && copy[2].value == 3 && tracked_arena.owns(copy.data()) == true
+                        && tracked_arena.get_stats().used > 3 * sizeof(Tracked),
+                        "dynarray initializer list and copy constructed in an arena");
+    }
+
+    passed &= check(Tracked::constructed == Tracked::destroyed, "dynarray elements in the arena destroyed");
+
+    return passed;
+}
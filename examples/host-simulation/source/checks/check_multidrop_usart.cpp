@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------------------
+// @file    check_multidrop_usart.cpp
+// @brief   Host simulation checks of the multidrop (9-bit address) USART.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+bool run_multidrop_usart_checks()
+{
+    check_group("MULTIDROP USART");
+
+    bool passed = true;
+
+    // 11 bit characters (~95 us) and a 4 character frame gap (13 bits each, 452 us)
+    MultidropUsart<8> node(Pin::Name::P0_25, Pin::Name::P0_24, 115200, 1, 0x12);
+
+    node.enable();
+
+    uint8_t frame[8] {};
+
+    // -------- FRAME COMPLETED BY THE GAP ------------------------------------
+
+    const uint8_t data[] = { 0xA1, 0xA2, 0xA3 };
+
+    HostSimulator::receive_usart_address(0, 0x12);
+    HostSimulator::receive_usart_data(0, data);
+
+    HostSimulator::run_for(600us);
+
+    passed &= check(node.is_frame_ready() == false, "Frame not complete before the frame gap");
+
+    // No reads in between: the frame is completed by the timer IRQ
+    HostSimulator::run_for(400us);
+
+    passed &= check(node.is_frame_ready() == true, "Frame completed by the gap timer without polling");
+
+    passed &= check(node.read_frame(frame) == 3 && std::equal(std::begin(data), std::end(data), frame), "Frame data read");
+
+    // -------- FRAME TO ANOTHER NODE -----------------------------------------
+
+    HostSimulator::receive_usart_address(0, 0x34);
+    HostSimulator::receive_usart_data(0, data);
+
+    HostSimulator::run_for(2ms);
+
+    passed &= check(node.is_frame_ready() == false, "Frame to another node ignored");
+
+    // -------- FRAME COMPLETED BY THE NEXT ADDRESS ---------------------------
+
+    HostSimulator::receive_usart_address(0, 0x12);
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 2));
+    HostSimulator::receive_usart_address(0, 0x12);
+    HostSimulator::receive_usart_data(0, gsl::span<const uint8_t>(data, 1));
+
+    HostSimulator::run_for(2ms);
+
+    passed &= check(node.read_frame(frame) == 2 && node.get_frame_dropped_count() == 1,
+                    "Frame completed by the next address (following frame dropped while not read)");
+
+    passed &= check(node.is_frame_ready() == false, "Single frame held");
+
+    return passed;
+}
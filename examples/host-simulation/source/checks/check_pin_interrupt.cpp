@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------
+// @file    check_pin_interrupt.cpp
+// @brief   Host simulation checks of the pin interrupts and the pattern match engine.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+namespace
+{
+
+
+
+
+using Channel     = PinInterrupt::Channel;
+using Mode        = PinInterrupt::Mode;
+using SliceConfig = PinInterrupt::SliceConfig;
+
+int32_t     g_edge_count   { 0 };
+int32_t     g_match_count  { 0 };
+int32_t     g_shared_count { 0 };
+
+SliceConfig g_match_config { SliceConfig::STICKY_FALLING };
+
+int32_t count_edge()
+{
+    g_edge_count++;
+    return 0;
+}
+
+// Re-write the slice configuration to clear its sticky edge (removes the match)
+int32_t count_match()
+{
+    PinInterrupt::set_pattern_slice(1, Channel::CH1, g_match_config, true);
+
+    g_match_count++;
+    return 0;
+}
+
+int32_t count_shared()
+{
+    PinInterrupt::set_pattern_slice(6, Channel::CH6, SliceConfig::STICKY_RISING, true);
+
+    g_shared_count++;
+    return 0;
+}
+
+
+
+
+} // namespace
+
+
+
+
+bool run_pin_interrupt_checks()
+{
+    check_group("PIN INTERRUPT");
+
+    bool passed = true;
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, true);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_17, true);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_18, false);
+
+    // -------- STANDARD FUNCTION ---------------------------------------------
+
+    PinInterrupt edge(Channel::CH0, Pin::Name::P0_16, Mode::EDGE_FALLING);
+
+    edge.assign_irq_handler(PinInterrupt::IrqHandler::create<&count_edge>());
+    edge.enable_irq();
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, false);
+    HostSimulator::run_for(100us);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, true);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_edge_count == 1 && edge.is_pending_irq() == false, "Falling edge IRQ dispatched once (IST cleared)");
+
+    // -------- PATTERN MATCH (DEDICATED IRQ) ---------------------------------
+
+    // CH0 low and a falling edge on CH1 request PININT1 (slices 0 and 1),
+    // a rising edge on CH6 requests the shared PININT6 / USART3 (slices 2 to 6)
+    PinInterrupt match(Channel::CH1, Pin::Name::P0_17, Mode::EDGE_RISING);
+    PinInterrupt shared(Channel::CH6, Pin::Name::P0_18, Mode::EDGE_RISING);
+
+    match.assign_irq_handler(PinInterrupt::IrqHandler::create<&count_match>());
+    match.enable_irq();
+    shared.assign_irq_handler(PinInterrupt::IrqHandler::create<&count_shared>());
+    shared.enable_irq();
+
+    PinInterrupt::set_pattern_slice(0, Channel::CH0, SliceConfig::LOW_LEVEL,      false);
+    PinInterrupt::set_pattern_slice(1, Channel::CH1, g_match_config,              true);
+
+    for(std::size_t slice = 2; slice < 6; ++slice)
+    {
+        PinInterrupt::set_pattern_slice(slice, Channel::CH6, SliceConfig::CONSTANT_HIGH, false);
+    }
+
+    PinInterrupt::set_pattern_slice(6, Channel::CH6, SliceConfig::STICKY_RISING, true);
+    PinInterrupt::set_pattern_slice(7, Channel::CH0, SliceConfig::CONSTANT_LOW,  true);
+
+    PinInterrupt::enable_pattern_match();
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_17, false);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_match_count == 0 && PinInterrupt::get_pattern_match_state() == 0, "Partial pattern (sticky edge only) not matched");
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, false);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_match_count == 1 && match.is_pending_irq() == false, "Pattern match IRQ dispatched without the IST flag");
+    passed &= check(PinInterrupt::get_pattern_match_state() == 0, "Match removed by the IRQ handler (dispatched once)");
+    passed &= check(g_edge_count == 1, "Standard function of the pattern inputs bypassed");
+
+    // An EVENT slice is only true at the edge: the product term state is gone
+    // by the time the IRQ handler runs
+    g_match_config = SliceConfig::EVENT;
+
+    PinInterrupt::set_pattern_slice(1, Channel::CH1, g_match_config, true);
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_17, true);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_match_count == 2, "Pattern match IRQ of an event slice dispatched");
+
+    // -------- PATTERN MATCH (SHARED IRQ) ------------------------------------
+
+    NVIC_SetPendingIRQ(PININT6_USART3_IRQn);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_shared_count == 0, "Shared IRQ without a match not dispatched to the pin interrupt");
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_18, true);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_shared_count == 1 && PinInterrupt::get_pattern_match_state() == 0, "Shared IRQ dispatched on the product term state");
+
+    // Discard the edges latched by the standard function while the pattern
+    // match engine drove the IRQs
+    edge.clear_pending_irq();
+    match.clear_pending_irq();
+    shared.clear_pending_irq();
+
+    PinInterrupt::disable_pattern_match();
+
+    // -------- STANDARD FUNCTION RESTORED ------------------------------------
+
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, true);
+    HostSimulator::set_pin_input_level(Pin::Name::P0_16, false);
+    HostSimulator::run_for(100us);
+
+    passed &= check(g_edge_count == 2 && g_match_count == 2 && g_shared_count == 1, "Standard function back after the pattern match is disabled");
+
+    return passed;
+}
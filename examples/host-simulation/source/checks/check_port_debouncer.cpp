@@ -0,0 +1,222 @@
+// ----------------------------------------------------------------------------
+// @file    check_port_debouncer.cpp
+// @brief   Host simulation checks and benchmark of the port debouncer.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// One input handler per pin (the path replaced by the port debouncer): each
+// handler reads the port and debounces its own pin with a sample counter
+struct PinDebouncer
+{
+    bool scan()
+    {
+        const bool level = ((read_sample() >> bit) & 1) != 0;
+
+        pressed  = false;
+        released = false;
+
+        if(level == state)
+        {
+            count = 0;
+            return false;
+        }
+
+        if(++count < depth)
+        {
+            return false;
+        }
+
+        count    = 0;
+        state    = level;
+        pressed  = level;
+        released = !level;
+
+        return true;
+    }
+
+    uint32_t read_sample() const
+    {
+        // Host checks debounce a generated sample, the benchmark reads the port
+        return (sample != nullptr) ? *sample : Port::read(Port::Name::PORT0);
+    }
+
+    const uint32_t* sample   { nullptr };
+    uint32_t        bit      { 0 };
+    uint32_t        depth    { 1 };
+    uint32_t        count    { 0 };
+    bool            state    { false };
+    bool            pressed  { false };
+    bool            released { false };
+};
+
+using InputHandler = InputScanner::InputHandler;
+
+constexpr std::size_t PIN_COUNT { 32 };
+
+static PinDebouncer pins[PIN_COUNT];
+static InputHandler pin_handlers[PIN_COUNT];
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525UL + 1013904223UL;
+    return seed >> 8;
+}
+
+static int64_t get_host_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Scan all the pin handlers (as the InputScanner IRQ handler does)
+static bool scan_pin_handlers()
+{
+    bool new_input = false;
+
+    for(const auto& handler : pin_handlers)
+    {
+        new_input |= handler();
+    }
+
+    return new_input;
+}
+
+
+
+
+bool run_port_debouncer_checks()
+{
+    check_group("PORT DEBOUNCER");
+
+    bool passed = true;
+
+    // -------- EQUIVALENCE WITH THE PER-PIN COUNTERS -------------------------
+
+    // Both start from the current port state, with random depths
+    PortDebouncer<3> debouncer(Port::Name::PORT0, 0xFFFFFFFF);
+
+    uint32_t sample = debouncer.get_state();
+    uint32_t seed   = 808;
+
+    for(std::size_t bit = 0; bit < PIN_COUNT; ++bit)
+    {
+        pins[bit].sample = &sample;
+        pins[bit].bit    = bit;
+        pins[bit].depth  = 1 + next_random(seed) % PortDebouncer<3>::MAX_DEPTH;
+        pins[bit].state  = ((sample >> bit) & 1) != 0;
+
+        pin_handlers[bit] = InputHandler::create<PinDebouncer, &PinDebouncer::scan>(&pins[bit]);
+
+        debouncer.set_depth(1UL << bit, pins[bit].depth);
+    }
+
+    // Bouncing samples: mostly the previous sample with some toggled bits
+
+    bool equal_state = true;
+    bool equal_edges = true;
+
+    for(std::size_t index = 0; index < 200000; ++index)
+    {
+        const uint32_t noise = ((next_random(seed) % 3) == 0) ? next_random(seed) : (1UL << (next_random(seed) % 32));
+
+        sample ^= ((next_random(seed) % 2) == 0) ? noise : 0;
+
+        const bool port_change = debouncer.update(sample);
+        const bool pin_change  = scan_pin_handlers();
+
+        uint32_t state    = 0;
+        uint32_t pressed  = 0;
+        uint32_t released = 0;
+
+        for(std::size_t bit = 0; bit < PIN_COUNT; ++bit)
+        {
+            state    |= static_cast<uint32_t>(pins[bit].state)    << bit;
+            pressed  |= static_cast<uint32_t>(pins[bit].pressed)  << bit;
+            released |= static_cast<uint32_t>(pins[bit].released) << bit;
+        }
+
+        equal_state &= (debouncer.get_state() == state);
+        equal_edges &= (debouncer.get_pressed() == pressed && debouncer.get_released() == released && port_change == pin_change);
+    }
+
+    passed &= check(equal_state == true, "Debounced state equal to the per-pin counters (32 pins, random depths)");
+    passed &= check(equal_edges == true, "Pressed / released masks equal to the per-pin edges");
+
+    // -------- BENCHMARK (32 PINS OF A PORT) ---------------------------------
+
+    constexpr int32_t SCAN_COUNT { 20000 };
+
+    for(auto& pin : pins)
+    {
+        pin.sample = nullptr;
+    }
+
+    // Virtual cycles of one scan (register accesses only)
+    int64_t cycles = HostSimulator::get_cycles();
+    scan_pin_handlers();
+    const int64_t pin_cycles = HostSimulator::get_cycles() - cycles;
+
+    cycles = HostSimulator::get_cycles();
+    debouncer.scan();
+    const int64_t port_cycles = HostSimulator::get_cycles() - cycles;
+
+    int64_t start_ns = get_host_ns();
+
+    for(int32_t scan = 0; scan < SCAN_COUNT; ++scan)
+    {
+        scan_pin_handlers();
+    }
+
+    const int64_t pin_ns = (get_host_ns() - start_ns) / SCAN_COUNT;
+
+    start_ns = get_host_ns();
+
+    for(int32_t scan = 0; scan < SCAN_COUNT; ++scan)
+    {
+        debouncer.scan();
+    }
+
+    const int64_t port_ns = (get_host_ns() - start_ns) / SCAN_COUNT;
+
+    passed &= check(port_cycles * static_cast<int64_t>(PIN_COUNT) == pin_cycles, "One port read per scan instead of one per pin");
+
+    std::printf("       delegate per pin: %lld ns/scan (%lld cycles), port debouncer: %lld ns/scan (%lld cycles)\n",
+                static_cast<long long>(pin_ns), static_cast<long long>(pin_cycles),
+                static_cast<long long>(port_ns), static_cast<long long>(port_cycles));
+
+    return passed;
+}
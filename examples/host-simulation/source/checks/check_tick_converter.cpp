@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+// @file    check_tick_converter.cpp
+// @brief   Host simulation checks of the tick converter (fixed point ratios).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace xarmlib;
+
+
+
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525UL + 1013904223UL;
+    return seed ^ (seed >> 16);
+}
+
+// Compare the four conversions of a frequency against the 64-bit divisions
+// they replace (returns the number of mismatches)
+static int32_t sweep_frequency(const uint32_t frequency, uint32_t& seed)
+{
+    static constexpr uint32_t edge_values[] = { 0, 1, 2, 999999, 1000000, 1000001, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF };
+
+    const TickConverter converter(frequency);
+
+    int32_t mismatch_count = 0;
+
+    for(std::size_t index = 0; index < 2000; ++index)
+    {
+        const uint32_t value = (index < std::size(edge_values)) ? edge_values[index] : next_random(seed);
+
+        const uint64_t us_product    = static_cast<uint64_t>(value) * frequency;
+        const uint64_t ticks_product = static_cast<uint64_t>(value) * 1000000UL;
+
+        const int64_t ticks         = static_cast<int64_t>(us_product / 1000000UL);
+        const int64_t ticks_ceil    = static_cast<int64_t>((us_product + 1000000UL - 1) / 1000000UL);
+        const int64_t duration      = static_cast<int64_t>(ticks_product / frequency);
+        const int64_t duration_ceil = static_cast<int64_t>((ticks_product + frequency - 1) / frequency);
+
+        mismatch_count += (converter.to_ticks(std::chrono::microseconds(value)) != ticks);
+        mismatch_count += (converter.to_ticks_ceil(std::chrono::microseconds(value)) != ticks_ceil);
+        mismatch_count += (converter.to_duration(value).count() != duration);
+        mismatch_count += (converter.to_duration_ceil(value).count() != duration_ceil);
+    }
+
+    return mismatch_count;
+}
+
+
+
+
+bool run_tick_converter_checks()
+{
+    check_group("TICK CONVERTER");
+
+    bool passed = true;
+
+    // -------- SWEEP AGAINST THE 64-BIT DIVISION -----------------------------
+
+    static constexpr uint32_t edge_frequencies[] = { 1, 32768, 999999, 1000000, 1000001, 7372800, 12000000, 15000000,
+                                                     18000000, 24000000, 30000000, 0x7FFFFFFF, 0xFFFFFFFF };
+
+    uint32_t seed           = 2018;
+    int32_t  mismatch_count = 0;
+
+    for(const auto frequency : edge_frequencies)
+    {
+        mismatch_count += sweep_frequency(frequency, seed);
+    }
+
+    for(std::size_t index = 0; index < 200; ++index)
+    {
+        const uint32_t frequency = next_random(seed);
+
+        mismatch_count += sweep_frequency((frequency != 0) ? frequency : 1, seed);
+    }
+
+    passed &= check(mismatch_count == 0, "Fixed point conversions equal to the 64-bit division (213 frequencies x 2000 values)");
+
+    // -------- TIMER CONVERTER -----------------------------------------------
+
+    // Updated by SystemCoreClockUpdate() in the startup hooks
+    const int64_t max_rate_us = static_cast<int64_t>(0x7FFFFFFFULL * 1000000UL / SystemCoreClock);
+
+    passed &= check(Timer::get_max_rate_us() == max_rate_us, "Timer converter of the current system clock");
+
+    return passed;
+}
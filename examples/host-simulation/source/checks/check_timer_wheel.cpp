@@ -0,0 +1,264 @@
+// ----------------------------------------------------------------------------
+// @file    check_timer_wheel.cpp
+// @brief   Host simulation checks and benchmark of the timer wheel.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// Timer recording its expiries on the ticker time base
+struct RecordedTimer
+{
+    RecordedTimer() : timer { SoftTimer::Handler::create<RecordedTimer, &RecordedTimer::on_expiry>(this) }
+    {}
+
+    int32_t on_expiry()
+    {
+        count++;
+        last_us = UsTicker::now().count();
+
+        if(other != nullptr)
+        {
+            wheel->stop(other->timer);
+        }
+
+        return 0;
+    }
+
+    SoftTimer      timer;
+    TimerWheel*    wheel   { nullptr };
+    RecordedTimer* other   { nullptr };     // Timer stopped by the expiry handler
+    int32_t        count   { 0 };
+    int64_t        last_us { 0 };
+};
+
+
+
+
+// Benchmark timers (started with pseudo-random delays)
+constexpr std::size_t BENCHMARK_TIMER_COUNT { 1000 };
+
+static RecordedTimer benchmark_timers[BENCHMARK_TIMER_COUNT];
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525UL + 1013904223UL;
+    return seed >> 8;
+}
+
+static int64_t get_host_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+
+static bool run_timer_wheel_benchmark()
+{
+    bool passed = true;
+
+    TimerWheel wheel(1ms);
+
+    // Start all the timers (delays from 1 to 500 ms)
+    std::array<int64_t, BENCHMARK_TIMER_COUNT> due_us {};
+
+    uint32_t seed = 12345;
+
+    const int64_t start_ns = get_host_ns();
+
+    for(std::size_t index = 0; index < BENCHMARK_TIMER_COUNT; ++index)
+    {
+        const auto delay = std::chrono::milliseconds(1 + next_random(seed) % 500);
+
+        due_us[index] = UsTicker::now().count() + delay.count() * 1000;
+
+        wheel.start(benchmark_timers[index].timer, delay, SoftTimer::Mode::SINGLE_SHOT);
+    }
+
+    const int64_t started_ns = get_host_ns();
+
+    // Stop every other timer
+    for(std::size_t index = 0; index < BENCHMARK_TIMER_COUNT; index += 2)
+    {
+        wheel.stop(benchmark_timers[index].timer);
+    }
+
+    const int64_t stopped_ns = get_host_ns();
+
+    passed &= check(wheel.get_running_count() == BENCHMARK_TIMER_COUNT / 2, "1000 timers started, 500 stopped");
+
+    const int64_t run_start_ns = get_host_ns();
+
+    HostSimulator::run_for(510ms);
+
+    const int64_t run_end_ns = get_host_ns();
+
+    bool    expired_once = true;
+    bool    on_time      = true;
+    int64_t max_late_us  = 0;
+
+    for(std::size_t index = 0; index < BENCHMARK_TIMER_COUNT; ++index)
+    {
+        const RecordedTimer& timer = benchmark_timers[index];
+
+        if(index % 2 == 0)
+        {
+            expired_once &= (timer.count == 0);
+            continue;
+        }
+
+        expired_once &= (timer.count == 1);
+
+        const int64_t late_us = timer.last_us - due_us[index];
+
+        on_time &= (late_us >= 0 && late_us < 1000 + 100);
+
+        max_late_us = (late_us > max_late_us) ? late_us : max_late_us;
+    }
+
+    passed &= check(expired_once == true && wheel.get_running_count() == 0, "Running timers expired once (stopped ones never)");
+    passed &= check(on_time == true, "Expiries within one tick of the due time");
+
+    std::printf("       start: %lld ns/timer, stop: %lld ns/timer, run 510 ms: %lld us (host), max late: %lld us\n",
+                static_cast<long long>((started_ns - start_ns) / BENCHMARK_TIMER_COUNT),
+                static_cast<long long>((stopped_ns - started_ns) / (BENCHMARK_TIMER_COUNT / 2)),
+                static_cast<long long>((run_end_ns - run_start_ns) / 1000),
+                static_cast<long long>(max_late_us));
+
+    return passed;
+}
+
+
+
+
+bool run_timer_wheel_checks()
+{
+    check_group("TIMER WHEEL");
+
+    bool passed = true;
+
+    // -------- SINGLE SHOT AND FREE RUNNING TIMERS ---------------------------
+    {
+        TimerWheel wheel(1ms);
+
+        RecordedTimer single;
+        RecordedTimer periodic;
+
+        const int64_t start_us = UsTicker::now().count();
+
+        wheel.start(single.timer, 5ms, SoftTimer::Mode::SINGLE_SHOT);
+        wheel.start(periodic.timer, 3ms, SoftTimer::Mode::FREE_RUNNING);
+
+        HostSimulator::run_for(31ms);
+
+        const int64_t single_us = single.last_us - start_us;
+
+        passed &= check(single.count == 1 && single_us >= 5000 && single_us < 6100 && single.timer.is_running() == false,
+                        "Single shot timer expired once after its delay");
+        passed &= check(periodic.count == 10 && periodic.timer.is_running() == true, "Free running timer expired every period");
+
+        wheel.stop(periodic.timer);
+
+        HostSimulator::run_for(10ms);
+
+        passed &= check(periodic.count == 10 && wheel.get_running_count() == 0, "No expiries after stop");
+    }
+
+    // -------- TIMERS STOPPED BY AN EARLIER HANDLER OF THE SAME SLOT ---------
+    {
+        TimerWheel wheel(1ms);
+
+        // Each handler stops the other timer of the pair, so only the first
+        // one dispatched is called
+        RecordedTimer single[2];
+        RecordedTimer periodic[2];
+
+        // Start the pairs inside a tick (same expiry tick for both timers)
+        HostSimulator::run_for(100us);
+
+        for(std::size_t index = 0; index < 2; ++index)
+        {
+            single[index].wheel   = &wheel;
+            single[index].other   = &single[1 - index];
+            periodic[index].wheel = &wheel;
+            periodic[index].other = &periodic[1 - index];
+
+            wheel.start(single[index].timer, 4ms, SoftTimer::Mode::SINGLE_SHOT);
+            wheel.start(periodic[index].timer, 6ms, SoftTimer::Mode::FREE_RUNNING);
+        }
+
+        HostSimulator::run_for(7ms);
+
+        passed &= check(single[0].count + single[1].count == 1, "Single shot timer stopped by an earlier handler not called");
+        passed &= check(periodic[0].count + periodic[1].count == 1, "Free running timer stopped by an earlier handler not called");
+
+        // The periodic timer that was dispatched keeps running
+        wheel.stop(periodic[0].timer);
+        wheel.stop(periodic[1].timer);
+    }
+
+    // -------- WAKE-UP BEYOND THE TIMER RANGE --------------------------------
+    {
+        // 32 slots of 5 s exceed the maximum timer rate (~89 s @ 24 MHz)
+        TimerWheel wheel(5s);
+
+        RecordedTimer single;
+
+        const int64_t start_us = UsTicker::now().count();
+
+        wheel.start(single.timer, 100s, SoftTimer::Mode::SINGLE_SHOT);
+
+        HostSimulator::run_for(96s);
+
+        passed &= check(single.count == 0, "Far timer not expired before its delay");
+
+        HostSimulator::run_for(10s);
+
+        const int64_t single_us = single.last_us - start_us;
+
+        // Within one tick (the elapsed part of the current tick counts) plus the wake-up latency
+        passed &= check(single.count == 1 && single_us >= 100000000 && single_us < 105000000 + 100,
+                        "Far timer expired after intermediate wake-ups");
+    }
+
+    // -------- BENCHMARK -----------------------------------------------------
+
+    passed &= run_timer_wheel_benchmark();
+
+    return passed;
+}
@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+// @file    check_us_ticker.cpp
+// @brief   Host simulation checks of the 64-bit microseconds ticker.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+// NOTE: Moves the SCT counter close to its wrap around, so the ticker jumps
+//       ~71 minutes ahead (run it after the checks that log timestamps).
+bool run_us_ticker_checks()
+{
+    check_group("MICROSECONDS TICKER");
+
+    bool passed = true;
+
+    // -------- 32-BIT COUNTER WRAP AROUND ------------------------------------
+
+    const int64_t high_before = UsTicker::now().count() >> 32;
+
+    LPC_SCT->COUNT = 0xFFFFFFF0;
+
+    const auto start     = UsTicker::now();
+    auto       previous  = start;
+    bool       monotonic = true;
+    bool       ticked    = false;
+
+    while(previous < start + 32us)
+    {
+        const auto current = UsTicker::now();
+
+        monotonic &= (current >= previous) && (current - previous < 10us);
+        ticked    |= (current >  previous);
+
+        previous = current;
+    }
+
+    passed &= check(monotonic == true && ticked == true, "Ticker monotonic across the 32-bit counter wrap around");
+    passed &= check((UsTicker::now().count() >> 32) == high_before + 1, "Counter overflow counted once");
+
+    // The overflow IRQ masked while the counter wraps around
+    LPC_SCT->COUNT = 0xFFFFFFF0;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const auto masked_start = UsTicker::now();
+
+    while((LPC_SCT->COUNT & 0x80000000) != 0)
+    {}
+
+    const auto masked_end = UsTicker::now();
+
+    __set_PRIMASK(primask);
+
+    const auto unmasked_end = UsTicker::now();
+
+    passed &= check(masked_end > masked_start && masked_end - masked_start < 32us, "Pending overflow accounted with the IRQ masked");
+    passed &= check(unmasked_end >= masked_end && unmasked_end - masked_end < 10us, "Ticker monotonic when the pending overflow IRQ runs");
+
+    return passed;
+}
@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+// @file    check_vector_table.cpp
+// @brief   Host simulation checks of the RAM vector table handler installation.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace std::chrono_literals;
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+namespace
+{
+
+
+
+
+int32_t g_delegate_count { 0 };
+int32_t g_direct_count   { 0 };
+
+// Library path: Timer delegate called by the MRT IRQ handler
+int32_t count_delegate()
+{
+    g_delegate_count++;
+    return 0;
+}
+
+// Installed in the vector table: clears the MRT channel flags itself
+int32_t count_direct()
+{
+    LPC_MRT->IRQ_FLAG = LPC_MRT->IRQ_FLAG;
+
+    g_direct_count++;
+    return 0;
+}
+
+// Flash vector table entry of an interrupt (empty on the host program)
+VectorTable::IrqHandlerPtr get_flash_handler(const IRQn_Type irq)
+{
+    return reinterpret_cast<VectorTable::IrqHandlerPtr>(__vectors_start__[16 + irq]);
+}
+
+
+
+
+} // namespace
+
+
+
+
+bool run_vector_table_checks()
+{
+    check_group("VECTOR TABLE");
+
+    bool passed = true;
+
+    VectorTable::relocate_to_flash();
+
+    Timer timer;
+
+    timer.assign_irq_handler(Timer::IrqHandler::create<&count_delegate>());
+    timer.enable_irq();
+    timer.start(1ms, Timer::Mode::FREE_RUNNING);
+
+    HostSimulator::run_for(5500us);
+
+    passed &= check(VectorTable::is_in_ram() == false && g_delegate_count == 5, "Library IRQ handler dispatches the Timer delegate (flash vector table)");
+
+    // -------- INSTALL -------------------------------------------------------
+
+    VectorTable::set_handler<&count_direct>(MRT_IRQn);
+
+    passed &= check(VectorTable::is_in_ram() == true, "Vector table relocated to RAM by the handler installation");
+    passed &= check(VectorTable::get_handler(MRT_IRQn) != get_flash_handler(MRT_IRQn), "Installed handler in the RAM vector table");
+    passed &= check(VectorTable::get_handler(USART0_IRQn) == get_flash_handler(USART0_IRQn)
+                    && VectorTable::get_handler(PININT7_USART4_IRQn) == get_flash_handler(PININT7_USART4_IRQn),
+                    "Other RAM vector table entries copied from the flash table");
+
+    HostSimulator::run_for(5ms);
+
+    passed &= check(g_direct_count == 5 && g_delegate_count == 5, "Installed handler bypasses the library IRQ handler");
+
+    // -------- RESTORE -------------------------------------------------------
+
+    VectorTable::restore_handler(MRT_IRQn);
+
+    passed &= check(VectorTable::is_in_ram() == true && VectorTable::get_handler(MRT_IRQn) == get_flash_handler(MRT_IRQn),
+                    "Restored entry back to the flash table handler (RAM table kept)");
+
+    HostSimulator::run_for(5ms);
+
+    passed &= check(g_direct_count == 5 && g_delegate_count == 10, "Library IRQ handler dispatches again after the restore");
+
+    // -------- IAP COMMANDS --------------------------------------------------
+
+    // NOTE: The IAP commands fail on the host (not simulated), but they run
+    //       with the RAM interrupts selected as on the target.
+    Iap::enable_ram_irq(MRT_IRQn);
+
+    VectorTable::set_handler<&count_direct>(MRT_IRQn);
+
+    const VectorTable::IrqHandlerPtr installed = VectorTable::get_handler(MRT_IRQn);
+
+    Iap::erase_flash_sectors(Iap::get_sector_count() - 1, Iap::get_sector_count() - 1);
+
+    passed &= check(VectorTable::is_in_ram() == true && VectorTable::get_handler(MRT_IRQn) == installed && NVIC_GetEnableIRQ(MRT_IRQn) == 1,
+                    "IAP command keeps the RAM vector table (already in RAM) and its installed handlers");
+
+    HostSimulator::run_for(3ms);
+
+    passed &= check(g_direct_count == 8, "Installed handler still dispatched after the IAP command");
+
+    VectorTable::restore_handler(MRT_IRQn);
+    VectorTable::relocate_to_flash();
+
+    Iap::erase_flash_sectors(Iap::get_sector_count() - 1, Iap::get_sector_count() - 1);
+
+    passed &= check(VectorTable::is_in_ram() == false && VectorTable::get_handler(MRT_IRQn) == get_flash_handler(MRT_IRQn),
+                    "IAP command returns to the flash vector table it was called with");
+
+    Iap::disable_ram_irq(MRT_IRQn);
+
+    timer.stop();
+
+    return passed;
+}
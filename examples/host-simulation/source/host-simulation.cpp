@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------------------
+// @file    host-simulation.cpp
+// @brief   Host simulation example (drivers running against the simulated LPC84x).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "host_checks.hpp"
+
+using namespace xarmlib;
+
+using HostSimulator = targets::lpc84x::HostSimulator;
+
+
+
+
+int main(void)
+{
+    bool passed = true;
+
+    passed &= run_driver_checks();
+    passed &= run_dma_checks();
+    passed &= run_vector_table_checks();
+    passed &= run_pin_interrupt_checks();
+    passed &= run_input_scanner_checks();
+    passed &= run_port_debouncer_checks();
+    passed &= run_buffered_usart_checks();
+    passed &= run_timer_wheel_checks();
+    passed &= run_frame_usart_checks();
+    passed &= run_multidrop_usart_checks();
+    passed &= run_tick_converter_checks();
+    passed &= run_memory_pool_checks();
+    passed &= run_crc_checks();
+    passed &= run_flash_kv_store_checks();
+
+    // Last group: the ticker jumps ahead to its 32-bit counter wrap around
+    passed &= run_us_ticker_checks();
+
+    std::printf("\nVirtual time: %lld us (%lld cycles @ %lu Hz)\n",
+                static_cast<long long>(HostSimulator::get_time().count()),
+                static_cast<long long>(HostSimulator::get_cycles()),
+                static_cast<unsigned long>(SystemCoreClock));
+
+    return (passed == true) ? 0 : 1;
+}
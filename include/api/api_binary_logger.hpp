@@ -0,0 +1,404 @@
+// ----------------------------------------------------------------------------
+// @file    api_binary_logger.hpp
+// @brief   API deferred binary logger (interned format strings) over USART.
+// @date    15 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_BINARY_LOGGER_HPP
+#define __XARMLIB_API_BINARY_LOGGER_HPP
+
+#include <cstring>
+#include <type_traits>
+
+#include "system/cassert"
+#include "system/cmsis"
+#include "system/target"
+#include "hal/hal_us_ticker.hpp"
+#include "hal/hal_usart.hpp"
+
+#ifdef __LPC84X__
+#include "targets/LPC84x/lpc84x_section_macros.hpp"
+#endif
+
+
+
+
+// Log a message with a format string interned in the non allocated
+// '.xarmlib_log' section (it takes no flash or RAM and is only read from the
+// ELF file by the host decoder: tools/binary_log_decoder.py). Only the string
+// ID (its section offset), a microseconds timestamp and the raw arguments are
+// queued, so it is safe and fast to use inside IRQ handlers.
+// Example:
+//          XARMLIB_LOG(logger, "adc: channel %u = %d mV", channel, value);
+#define XARMLIB_LOG(logger, format, ...)                                                    \
+    do                                                                                      \
+    {                                                                                       \
+        __attribute__ ((used)) __SECTION_SIMPLE(xarmlib_log)                                \
+        static const char xarmlib_log_format[] = format;                                    \
+        (logger).log(::xarmlib::LogFormat(xarmlib_log_format), ##__VA_ARGS__);              \
+    } while(0)
+
+
+
+
+namespace xarmlib
+{
+
+
+
+
+// Interned format string (created by the XARMLIB_LOG macro)
+class LogFormat
+{
+    public:
+
+        explicit constexpr LogFormat(const char* string) : m_string { string }
+        {}
+
+        // Offset of the string in the (non allocated) strings section
+        uint16_t get_id() const
+        {
+            const uintptr_t id = reinterpret_cast<uintptr_t>(m_string);
+
+            assert(id <= 0xFFFF);
+
+            return static_cast<uint16_t>(id);
+        }
+
+    private:
+
+        const char* m_string;
+};
+
+
+
+
+// Binary log records (little endian):
+//   0xA5 | header (4) | timestamp (4) | arguments (4 or 8 each) | checksum (1)
+// header:    bits 0-15 format string ID, bits 16-18 argument count and
+//            bits 19-30 argument types (2 bits each, see ArgumentType)
+// timestamp: lower 32 bits of the UsTicker value
+// checksum:  8 bit sum of the bytes between the sync byte and the checksum
+// NOTE: Buffer size must be a power of 2. Several producers are allowed (IRQ
+//       handlers of any priority and the application): each record is queued
+//       with the interrupts disabled for a few microseconds (Cortex-M0+ has no
+//       exclusive load / store to do it lock-free). The USART TX IRQ handler
+//       is the only consumer. Records that don't fit are dropped and counted.
+template <std::size_t BufferSize>
+class BinaryLogger : private Usart
+{
+        static_assert(BufferSize >= 64 && (BufferSize & (BufferSize - 1)) == 0, "Logger buffer size must be a power of 2 (at least 64).");
+
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using ClockSource = typename Usart::ClockSource;
+
+        // Argument type encoded in the record header
+        enum class ArgumentType
+        {
+            INT32 = 0,      // Integers (up to 32 bits), characters, booleans, enumerations and pointers
+            INT64,          // 64 bit integers
+            FLOAT,          // Single precision floating point
+            DOUBLE          // Double precision floating point
+        };
+
+        static constexpr std::size_t MAX_ARGUMENTS { 6 };
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        BinaryLogger(const Pin::Name   txd,
+                     const Pin::Name   rxd,
+                     const int32_t     baudrate,
+                     const int32_t     irq_priority,
+                     const ClockSource clock_source = ClockSource::FRG0) : Usart(txd, rxd, baudrate, DataBits::BITS_8, StopBits::BITS_1, Parity::NONE, clock_source)
+        {
+            const auto handler = IrqHandler::template create<BinaryLogger, &BinaryLogger::irq_handler>(this);
+            Usart::assign_irq_handler(handler, irq_priority);
+
+            // TX ready interrupt is only enabled while there are records to transmit
+            Usart::enable();
+        }
+
+        ~BinaryLogger()
+        {
+            Usart::disable_interrupts(Interrupt::ALL);
+            Usart::remove_irq_handler();
+        }
+
+        // -------- LOG -------------------------------------------------------
+
+        // Queue a record, returning 'false' if it was dropped (buffer full)
+        // NOTE: Use the XARMLIB_LOG macro to intern the format string.
+        template <typename... Args>
+        bool log(const LogFormat& format, const Args... args)
+        {
+            static_assert(sizeof...(Args) <= MAX_ARGUMENTS, "Too many log arguments.");
+
+            uint8_t     record[MAX_RECORD_SIZE];
+            std::size_t size = 9;
+
+            const uint32_t header = format.get_id()
+                                  | (static_cast<uint32_t>(sizeof...(Args)) << 16)
+                                  | (get_argument_types<Args...>(0) << 19);
+
+            record[0] = SYNC_BYTE;
+            std::memcpy(&record[1], &header, 4);
+
+            (encode_argument(record, size, args), ...);
+
+            // Checksum without the timestamp (added when it is queued)
+            uint8_t checksum = 0;
+
+            for(std::size_t index = 1; index < size; ++index)
+            {
+                checksum += (index < 5 || index >= 9) ? record[index] : 0;
+            }
+
+            record[size++] = checksum;
+
+            return push_record(record, size);
+        }
+
+        // -------- STATUS ----------------------------------------------------
+
+        // Return 'true' when all the queued records were completely shifted out
+        bool is_flushed() const
+        {
+            return m_head == m_tail && Usart::is_tx_idle() == true;
+        }
+
+        // Wait until all the queued records were completely shifted out
+        void flush() const
+        {
+            while(is_flushed() == false)
+            {}
+        }
+
+        // Number of records dropped because the buffer was full
+        uint32_t get_dropped_count() const
+        {
+            return m_dropped_count;
+        }
+
+        void clear_dropped_count()
+        {
+            m_dropped_count = 0;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DataBits   = typename Usart::DataBits;
+        using StopBits   = typename Usart::StopBits;
+        using Parity     = typename Usart::Parity;
+        using Interrupt  = typename Usart::Interrupt;
+        using IrqHandler = typename Usart::IrqHandler;
+
+        static constexpr uint8_t     SYNC_BYTE       { 0xA5 };
+        static constexpr std::size_t MAX_RECORD_SIZE { 1 + 4 + 4 + MAX_ARGUMENTS * 8 + 1 };
+        static constexpr uint32_t    MASK            { BufferSize - 1 };
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- ENCODING --------------------------------------------------
+
+        template <typename T>
+        static constexpr ArgumentType get_argument_type()
+        {
+            static_assert(!std::is_same<std::decay_t<T>, char*>::value && !std::is_same<std::decay_t<T>, const char*>::value,
+                          "String arguments are not supported (only the address would be logged).");
+            static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                          "Unsupported log argument type.");
+            static_assert(sizeof(T) <= 8, "Unsupported log argument size.");
+
+            if(std::is_same<T, float>::value)
+            {
+                return ArgumentType::FLOAT;
+            }
+            else if(std::is_floating_point<T>::value)
+            {
+                return ArgumentType::DOUBLE;
+            }
+            else if(sizeof(T) == 8)
+            {
+                return ArgumentType::INT64;
+            }
+
+            return ArgumentType::INT32;
+        }
+
+        template <typename... Args>
+        static constexpr uint32_t get_argument_types(const uint32_t shift)
+        {
+            if constexpr(sizeof...(Args) == 0)
+            {
+                return 0;
+            }
+            else
+            {
+                return get_first_argument_type<Args...>(shift);
+            }
+        }
+
+        template <typename T, typename... Args>
+        static constexpr uint32_t get_first_argument_type(const uint32_t shift)
+        {
+            return (static_cast<uint32_t>(get_argument_type<T>()) << shift) | get_argument_types<Args...>(shift + 2);
+        }
+
+        template <typename T>
+        static void encode_argument(uint8_t* const record, std::size_t& size, const T value)
+        {
+            constexpr ArgumentType type = get_argument_type<T>();
+
+            if constexpr(std::is_pointer<T>::value)
+            {
+                encode_argument(record, size, reinterpret_cast<uintptr_t>(value));
+            }
+            else if constexpr(type == ArgumentType::FLOAT || type == ArgumentType::DOUBLE)
+            {
+                std::memcpy(&record[size], &value, sizeof(T));
+                size += sizeof(T);
+            }
+            else if constexpr(type == ArgumentType::INT64)
+            {
+                const int64_t word = static_cast<int64_t>(value);
+                std::memcpy(&record[size], &word, 8);
+                size += 8;
+            }
+            else
+            {
+                // Sign extended (the decoder uses the format conversion to interpret it)
+                const int32_t word = static_cast<int32_t>(value);
+                std::memcpy(&record[size], &word, 4);
+                size += 4;
+            }
+        }
+
+        // -------- BUFFER ----------------------------------------------------
+
+        // Timestamp and queue a record
+        // NOTE: The timestamp is taken in the critical section, so the records
+        //       of preempting producers are queued in timestamp order.
+        bool push_record(uint8_t* const record, const std::size_t size)
+        {
+            const uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            const uint32_t head = m_head;
+
+            if(BufferSize - (head - m_tail) < size)
+            {
+                m_dropped_count++;
+
+                __set_PRIMASK(primask);
+
+                return false;
+            }
+
+            const uint32_t timestamp = static_cast<uint32_t>(xarmlib::UsTicker::now().count());
+
+            std::memcpy(&record[5], &timestamp, 4);
+
+            record[size - 1] += record[5] + record[6] + record[7] + record[8];
+
+            for(std::size_t index = 0; index < size; ++index)
+            {
+                m_buffer[(head + index) & MASK] = record[index];
+            }
+
+            m_head = head + size;
+
+            Usart::enable_interrupts(Interrupt::TX_READY);
+
+            __set_PRIMASK(primask);
+
+            return true;
+        }
+
+        int32_t irq_handler()
+        {
+            // Feed the transmitter
+            while(Usart::is_tx_ready() == true)
+            {
+                const uint32_t tail = m_tail;
+
+                if(tail == m_head)
+                {
+                    // Nothing else to transmit
+                    Usart::disable_interrupts(Interrupt::TX_READY);
+
+                    // A higher priority producer may have queued a record (and
+                    // enabled the interrupt) right before it was disabled
+                    if(tail == m_head)
+                    {
+                        break;
+                    }
+
+                    Usart::enable_interrupts(Interrupt::TX_READY);
+                    continue;
+                }
+
+                Usart::write(m_buffer[tail & MASK]);
+
+                m_tail = tail + 1;
+            }
+
+            return 0;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        // NOTE: Free running indexes (wrap around naturally on overflow)
+        volatile uint32_t m_head { 0 };     // Written by the producers (interrupts disabled)
+        volatile uint32_t m_tail { 0 };     // Written only by the USART IRQ handler
+
+        uint8_t           m_buffer[BufferSize];
+
+        volatile uint32_t m_dropped_count { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_BINARY_LOGGER_HPP
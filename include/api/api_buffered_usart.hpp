@@ -0,0 +1,259 @@
+// ----------------------------------------------------------------------------
+// @file    api_buffered_usart.hpp
+// @brief   API interrupt driven buffered USART class.
+// @date    2 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_BUFFERED_USART_HPP
+#define __XARMLIB_API_BUFFERED_USART_HPP
+
+#include "system/gsl"
+#include "system/ring_buffer"
+#include "hal/hal_usart.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// NOTE: Buffer sizes must be a power of 2.
+template <std::size_t RxBufferSize, std::size_t TxBufferSize>
+class BufferedUsart : private Usart
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DataBits = typename Usart::DataBits;
+        using StopBits = typename Usart::StopBits;
+        using Parity   = typename Usart::Parity;
+
+        using ClockSource = typename Usart::ClockSource;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        BufferedUsart(const Pin::Name   txd,
+                      const Pin::Name   rxd,
+                      const int32_t     baudrate,
+                      const int32_t     irq_priority,
+                      const DataBits    data_bits    = DataBits::BITS_8,
+                      const StopBits    stop_bits    = StopBits::BITS_1,
+                      const Parity      parity       = Parity::NONE,
+                      const ClockSource clock_source = ClockSource::FRG0) : Usart(txd, rxd, baudrate, data_bits, stop_bits, parity, clock_source)
+        {
+            const auto handler = IrqHandler::template create<BufferedUsart, &BufferedUsart::irq_handler>(this);
+            Usart::assign_irq_handler(handler, irq_priority);
+
+            // TX ready interrupt is only enabled while there is data to transmit
+            Usart::enable_interrupts(Interrupt::RX_READY | Interrupt::RX_OVERRUN_INT);
+        }
+
+        ~BufferedUsart()
+        {
+            Usart::disable_interrupts(Interrupt::ALL);
+            Usart::remove_irq_handler();
+        }
+
+        // -------- FORMAT / BAUDRATE -----------------------------------------
+
+        using Usart::set_format;
+        using Usart::set_data_bits;
+        using Usart::set_stop_bits;
+        using Usart::set_parity;
+        using Usart::set_baudrate;
+
+        // -------- ENABLE / DISABLE ------------------------------------------
+
+        using Usart::enable;
+        using Usart::disable;
+        using Usart::is_enabled;
+
+        // -------- READ ------------------------------------------------------
+
+        // Dequeue one received byte (non-blocking), returning 'false' if none is available
+        bool read(uint8_t& value)
+        {
+            return m_rx_buffer.pop(value);
+        }
+
+        // Dequeue received bytes (non-blocking), returning the number of actual read bytes
+        int32_t read(const gsl::span<uint8_t> buffer)
+        {
+            int32_t count = 0;
+
+            while(count < buffer.size() && m_rx_buffer.pop(buffer[count]) == true)
+            {
+                count++;
+            }
+
+            return count;
+        }
+
+        // Number of received bytes waiting to be read
+        std::size_t get_rx_count() const
+        {
+            return m_rx_buffer.size();
+        }
+
+        // Discard all the received bytes not yet read
+        void flush_rx()
+        {
+            m_rx_buffer.clear();
+        }
+
+        // -------- WRITE -----------------------------------------------------
+
+        // Enqueue one byte to be transmitted (non-blocking), returning 'false' if the buffer is full
+        bool write(const uint8_t value)
+        {
+            const bool result = m_tx_buffer.push(value);
+
+            Usart::enable_interrupts(Interrupt::TX_READY);
+
+            return result;
+        }
+
+        // Enqueue bytes to be transmitted (non-blocking), returning the number of actual enqueued bytes
+        int32_t write(const gsl::span<const uint8_t> buffer)
+        {
+            int32_t count = 0;
+
+            while(count < buffer.size() && m_tx_buffer.push(buffer[count]) == true)
+            {
+                count++;
+            }
+
+            Usart::enable_interrupts(Interrupt::TX_READY);
+
+            return count;
+        }
+
+        // Number of free bytes in the transmit buffer
+        std::size_t get_tx_free() const
+        {
+            return m_tx_buffer.available();
+        }
+
+        // Return 'true' when all the enqueued bytes were completely shifted out
+        bool is_tx_complete() const
+        {
+            return m_tx_buffer.is_empty() == true && Usart::is_tx_idle() == true;
+        }
+
+        // -------- ERROR COUNTERS --------------------------------------------
+
+        // Number of bytes lost by the hardware (receiver overrun)
+        uint32_t get_rx_overrun_count() const
+        {
+            return m_rx_overrun_count;
+        }
+
+        // Number of received bytes discarded because the receive buffer was full
+        uint32_t get_rx_dropped_count() const
+        {
+            return m_rx_dropped_count;
+        }
+
+        void clear_error_counters()
+        {
+            m_rx_overrun_count = 0;
+            m_rx_dropped_count = 0;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Status     = typename Usart::Status;
+        using Interrupt  = typename Usart::Interrupt;
+        using IrqHandler = typename Usart::IrqHandler;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        int32_t irq_handler()
+        {
+            if((Usart::get_status() & Status::RX_OVERRUN_INT) != 0)
+            {
+                Usart::clear_status(Status::RX_OVERRUN_INT);
+
+                m_rx_overrun_count++;
+            }
+
+            // Drain the receiver
+            while(Usart::is_rx_ready() == true)
+            {
+                if(m_rx_buffer.push(static_cast<uint8_t>(Usart::read())) == false)
+                {
+                    m_rx_dropped_count++;
+                }
+            }
+
+            // Feed the transmitter
+            while(Usart::is_tx_ready() == true)
+            {
+                uint8_t value;
+
+                if(m_tx_buffer.pop(value) == false)
+                {
+                    // Nothing else to transmit
+                    Usart::disable_interrupts(Interrupt::TX_READY);
+                    break;
+                }
+
+                Usart::write(value);
+            }
+
+            return 0;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        RingBuffer<uint8_t, RxBufferSize> m_rx_buffer;
+        RingBuffer<uint8_t, TxBufferSize> m_tx_buffer;
+
+        volatile uint32_t                 m_rx_overrun_count { 0 };
+        volatile uint32_t                 m_rx_dropped_count { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_BUFFERED_USART_HPP
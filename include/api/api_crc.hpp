@@ -1,8 +1,10 @@
 // ----------------------------------------------------------------------------
 // @file    api_crc.hpp
 // @brief   Generic CRC class (usable when a hardware implementation is not
-//          available). Specializations for some common types of 8, 16 and
-//          32 bits. Formulas taken from:
+//          available). Single call or streaming calculation with nibble,
+//          byte or slicing-by-4/8 lookup tables. Hardware CRC engine class
+//          and selector. Specializations for some common types of 8, 16
+//          and 32 bits. Formulas taken from:
 //          https://barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
 // @date    12 June 2018
 // ----------------------------------------------------------------------------
@@ -37,8 +39,15 @@
 
 #include <stdint.h>
 
+#include <type_traits>
+
 #include "system/array"
 #include "system/gsl"
+#include "system/target"
+
+#ifdef __TARGET_HAS_CRC_ENGINE__
+#include "hal/hal_crc_engine.hpp"
+#endif
 
 namespace xarmlib
 {
@@ -46,31 +55,78 @@ namespace xarmlib
 
 
 
-template <typename Type,
-          Type     Polynomial,
-          Type     InitialRemainder,
-          Type     FinalXorValue,
-          bool     ReflectInput,
-          bool     ReflectOutput>
+// Lookup table strategy (trade flash size for speed)
+enum class CrcTableStrategy
+{
+    NIBBLE = 0,     // 16 entries (4 bits per lookup)
+    BYTE,           // 256 entries (8 bits per lookup)
+    SLICING_BY_4,   // 4 x 256 entries (32 bits per 4 lookups)
+    SLICING_BY_8    // 8 x 256 entries (64 bits per 8 lookups)
+};
+
+
+
+
+template <typename         Type,
+          Type             Polynomial,
+          Type             InitialRemainder,
+          Type             FinalXorValue,
+          bool             ReflectInput,
+          bool             ReflectOutput,
+          CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
 class Crc
 {
     public:
 
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using TableStrategy = CrcTableStrategy;
+
         // --------------------------------------------------------------------
         // PUBLIC MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
+        // -------- SINGLE CALL -----------------------------------------------
+
         static constexpr Type calculate(const gsl::span<const uint8_t> buffer)
         {
-            Type remainder = InitialRemainder;
+            return finalize_remainder(update_remainder(get_initial_remainder(), buffer));
+        }
 
-            for(auto& elem : buffer)
-            {
-                const uint8_t data = static_cast<uint8_t>(reflect_input(elem) ^ (remainder >> (WIDTH - 8)));
-                remainder = static_cast<Type>(m_lookup_table[data] ^ (remainder << 8));
-            }
+        // -------- STREAMING -------------------------------------------------
 
-            return reflect_output(remainder) ^ FinalXorValue;
+        Crc()
+        {
+            init();
+        }
+
+        // Start a new calculation
+        void init()
+        {
+            m_remainder = get_initial_remainder();
+        }
+
+        // Add the next chunk of data to the calculation
+        void update(const gsl::span<const uint8_t> buffer)
+        {
+            m_remainder = update_remainder(m_remainder, buffer);
+        }
+
+        // Get the CRC of all the data added since the last init()
+        // NOTE: The calculation state is kept, so more data can still be added.
+        Type finalize() const
+        {
+            return finalize_remainder(m_remainder);
+        }
+
+        // -------- TABLE SIZE ------------------------------------------------
+
+        // Lookup table size in bytes
+        static constexpr std::size_t get_table_size()
+        {
+            return sizeof(m_lookup_table);
         }
 
     private:
@@ -85,32 +141,113 @@ class Crc
             WIDTH = 8 * sizeof(Type)
         };
 
+        // NOTE: The remainder is kept reflected when the input is reflected,
+        //       so the input bytes never need to be reflected. Only the
+        //       initial and final values are reflected (when required).
+        static constexpr bool REFLECTED = ReflectInput;
+
+        static constexpr std::size_t TABLE_ENTRIES = (Strategy == CrcTableStrategy::NIBBLE) ? 16 : 256;
+
+        static constexpr std::size_t TABLE_COUNT = (Strategy == CrcTableStrategy::SLICING_BY_8) ? 8 :
+                                                   (Strategy == CrcTableStrategy::SLICING_BY_4) ? 4 : 1;
+
+        using LookupTable = std::array<std::array<Type, TABLE_ENTRIES>, TABLE_COUNT>;
+
         // --------------------------------------------------------------------
         // PRIVATE MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
-        template<bool enabled = ReflectInput>
-        static constexpr Type reflect_input(typename std::enable_if<enabled, Type>::type data)
+        static constexpr Type get_initial_remainder()
         {
-            return reflect(data, 8);
+            return REFLECTED ? reflect(InitialRemainder, WIDTH) : InitialRemainder;
         }
 
-        template<bool enabled = ReflectInput>
-        static constexpr Type reflect_input(typename std::enable_if<!enabled, Type>::type data)
+        static constexpr Type finalize_remainder(const Type remainder)
         {
-            return data;
+            return static_cast<Type>(((ReflectInput != ReflectOutput) ? reflect(remainder, WIDTH) : remainder) ^ FinalXorValue);
         }
 
-        template<bool enabled = ReflectOutput>
-        static constexpr Type reflect_output(typename std::enable_if<enabled, Type>::type data)
+        static constexpr Type update_remainder(Type remainder, const gsl::span<const uint8_t> buffer)
         {
-            return reflect(data, WIDTH);
+            const uint8_t*    data  = buffer.data();
+            std::size_t       count = static_cast<std::size_t>(buffer.size());
+
+            // Process TABLE_COUNT bytes per iteration (slicing strategies)
+            for(; TABLE_COUNT > 1 && count >= TABLE_COUNT; count -= TABLE_COUNT, data += TABLE_COUNT)
+            {
+                remainder = update_slice(remainder, data);
+            }
+
+            for(; count > 0; --count, ++data)
+            {
+                remainder = update_byte(remainder, *data);
+            }
+
+            return remainder;
+        }
+
+        // Process one byte
+        static constexpr Type update_byte(const Type remainder, const uint8_t data)
+        {
+            if(Strategy == CrcTableStrategy::NIBBLE)
+            {
+                Type result = remainder;
+
+                if(REFLECTED)
+                {
+                    // Low nibble first
+                    result = static_cast<Type>((result >> 4) ^ m_lookup_table[0][(result ^ data)        & 0x0F]);
+                    result = static_cast<Type>((result >> 4) ^ m_lookup_table[0][(result ^ (data >> 4)) & 0x0F]);
+                }
+                else
+                {
+                    // High nibble first
+                    result = static_cast<Type>((result << 4) ^ m_lookup_table[0][((result >> (WIDTH - 4)) ^ (data >> 4)) & 0x0F]);
+                    result = static_cast<Type>((result << 4) ^ m_lookup_table[0][((result >> (WIDTH - 4)) ^ data)        & 0x0F]);
+                }
+
+                return result;
+            }
+
+            if(REFLECTED)
+            {
+                return static_cast<Type>(shift_right_8(remainder) ^ m_lookup_table[0][(remainder ^ data) & 0xFF]);
+            }
+            else
+            {
+                return static_cast<Type>(shift_left_8(remainder) ^ m_lookup_table[0][((remainder >> (WIDTH - 8)) ^ data) & 0xFF]);
+            }
+        }
+
+        // Process TABLE_COUNT bytes (TABLE_COUNT >= sizeof(Type), so the whole remainder is consumed)
+        static constexpr Type update_slice(const Type remainder, const uint8_t* const data)
+        {
+            Type result = 0;
+
+            for(std::size_t index = 0; index < TABLE_COUNT; ++index)
+            {
+                uint8_t byte = data[index];
+
+                if(index < sizeof(Type))
+                {
+                    byte ^= REFLECTED ? static_cast<uint8_t>(remainder >> (8 * index))
+                                      : static_cast<uint8_t>(remainder >> (WIDTH - 8 - 8 * index));
+                }
+
+                result ^= m_lookup_table[TABLE_COUNT - 1 - index][byte];
+            }
+
+            return result;
+        }
+
+        static constexpr Type shift_right_8(const Type value)
+        {
+            return (WIDTH > 8) ? static_cast<Type>(value >> 8) : 0;
         }
 
-        template<bool enabled = ReflectOutput>
-        static constexpr Type reflect_output(typename std::enable_if<!enabled, Type>::type data)
+        static constexpr Type shift_left_8(const Type value)
         {
-            return data;
+            return (WIDTH > 8) ? static_cast<Type>(value << 8) : 0;
         }
 
         static constexpr Type reflect(Type data, const int32_t num_bits)
@@ -123,7 +260,7 @@ class Crc
                 // If the LSB bit is set, set the reflection of it.
                 if((data & 0x01) != 0)
                 {
-                    reflection |= static_cast<Type>((1 << ((num_bits - 1) - bit)));
+                    reflection |= static_cast<Type>(static_cast<Type>(1) << ((num_bits - 1) - bit));
                 }
 
                 data = static_cast<Type>(data >> 1);
@@ -132,65 +269,229 @@ class Crc
             return reflection;
         }
 
-        static constexpr Type modulo2(const std::size_t dividend)
+        // Remainder of the supplied dividend (with the given number of bits)
+        static constexpr Type modulo2(const std::size_t dividend, const int32_t num_bits)
         {
-            //static_assert(dividend >= 0 && dividend <= 255);
+            if(REFLECTED)
+            {
+                const Type polynomial = reflect(Polynomial, WIDTH);
 
-            // Start with the dividend followed by zeros
-            Type remainder = static_cast<Type>(dividend << (WIDTH - 8));
+                Type remainder = static_cast<Type>(dividend);
+
+                // Perform modulo-2 division (a bit at a time, LSB first)
+                for(int32_t bit = num_bits; bit > 0; --bit)
+                {
+                    if((remainder & 0x01) != 0)
+                    {
+                        remainder = static_cast<Type>((remainder >> 1) ^ polynomial);
+                    }
+                    else
+                    {
+                        remainder = static_cast<Type>(remainder >> 1);
+                    }
+                }
 
-            // Perform modulo-2 division (a bit at a time)
-            for(int32_t bit = 8; bit > 0; --bit)
+                return remainder;
+            }
+            else
             {
-                // Try to divide the current data bit
-                if ((remainder & (1 << (WIDTH - 1))) != 0)
+                const Type top_bit = static_cast<Type>(static_cast<Type>(1) << (WIDTH - 1));
+
+                // Start with the dividend followed by zeros
+                Type remainder = static_cast<Type>(dividend << (WIDTH - num_bits));
+
+                // Perform modulo-2 division (a bit at a time, MSB first)
+                for(int32_t bit = num_bits; bit > 0; --bit)
                 {
-                    remainder = static_cast<Type>((remainder << 1) ^ Polynomial);
+                    // Try to divide the current data bit
+                    if((remainder & top_bit) != 0)
+                    {
+                        remainder = static_cast<Type>((remainder << 1) ^ Polynomial);
+                    }
+                    else
+                    {
+                        remainder = static_cast<Type>(remainder << 1);
+                    }
                 }
-                else
+
+                return remainder;
+            }
+        }
+
+        static constexpr LookupTable build_lookup_table()
+        {
+            LookupTable result {};
+
+            const int32_t num_bits = (Strategy == CrcTableStrategy::NIBBLE) ? 4 : 8;
+
+            for(std::size_t i = 0; i < TABLE_ENTRIES; ++i)
+            {
+                result[0][i] = modulo2(i, num_bits);
+            }
+
+            // Slicing tables: table[k][i] is the remainder of byte i followed by k zero bytes
+            for(std::size_t k = 1; k < TABLE_COUNT; ++k)
+            {
+                for(std::size_t i = 0; i < TABLE_ENTRIES; ++i)
                 {
-                    remainder = static_cast<Type>(remainder << 1);
+                    const Type previous = result[k - 1][i];
+
+                    if(REFLECTED)
+                    {
+                        result[k][i] = static_cast<Type>(shift_right_8(previous) ^ result[0][previous & 0xFF]);
+                    }
+                    else
+                    {
+                        result[k][i] = static_cast<Type>(shift_left_8(previous) ^ result[0][(previous >> (WIDTH - 8)) & 0xFF]);
+                    }
                 }
             }
 
-            return remainder;
+            return result;
         }
 
-        static constexpr auto build_lookup_table()
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        static constexpr LookupTable m_lookup_table { build_lookup_table() };
+
+        Type m_remainder { 0 };     // Streaming calculation state
+};
+
+
+
+
+#ifdef __TARGET_HAS_CRC_ENGINE__
+
+// CRC calculated by the hardware CRC engine (same interface as the generic class)
+// NOTE: The engine is only reconfigured when another calculation used it since
+//       the last update. The final reflection and XOR are done in software, so
+//       any initial / final value and reflection combination is supported.
+template <typename Type,
+          Type     Polynomial,
+          Type     InitialRemainder,
+          Type     FinalXorValue,
+          bool     ReflectInput,
+          bool     ReflectOutput>
+class CrcHardware
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- SINGLE CALL -----------------------------------------------
+
+        static Type calculate(const gsl::span<const uint8_t> buffer)
         {
-            std::array<Type, 256> result {0};
+            CrcHardware crc;
+
+            crc.update(buffer);
+
+            return crc.finalize();
+        }
 
-            for(std::size_t i = 0; i < result.size(); ++i)
+        // -------- STREAMING -------------------------------------------------
+
+        CrcHardware()
+        {
+            init();
+        }
+
+        ~CrcHardware()
+        {
+            CrcEngine::release(this);
+        }
+
+        // Start a new calculation
+        void init()
+        {
+            CrcEngine::release(this);
+
+            m_remainder = InitialRemainder;
+        }
+
+        // Add the next chunk of data to the calculation
+        void update(const gsl::span<const uint8_t> buffer)
+        {
+            if(CrcEngine::is_owner(this) == false)
             {
-                result[i] = modulo2(i);
+                CrcEngine::configure(CrcEngine::get_polynomial<Type, Polynomial>(), ReflectInput, false, m_remainder);
+                CrcEngine::set_owner(this);
             }
 
-            return result;
+            CrcEngine::write(buffer);
+
+            m_remainder = static_cast<Type>(CrcEngine::read_sum());
+        }
+
+        // Get the CRC of all the data added since the last init()
+        // NOTE: The calculation state is kept, so more data can still be added.
+        Type finalize() const
+        {
+            return static_cast<Type>((ReflectOutput ? reflect(m_remainder) : m_remainder) ^ FinalXorValue);
+        }
+
+        // -------- TABLE SIZE ------------------------------------------------
+
+        static constexpr std::size_t get_table_size()
+        {
+            return 0;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static constexpr Type reflect(Type data)
+        {
+            Type reflection = 0;
+
+            for(std::size_t bit = 0; bit < 8 * sizeof(Type); ++bit)
+            {
+                reflection = static_cast<Type>((reflection << 1) | (data & 0x01));
+                data       = static_cast<Type>(data >> 1);
+            }
+
+            return reflection;
         }
 
         // --------------------------------------------------------------------
         // PRIVATE MEMBER VARIABLES
         // --------------------------------------------------------------------
 
-        static constexpr std::array<Type, 256> m_lookup_table { build_lookup_table() };
+        Type m_remainder { InitialRemainder };  // Current remainder (not reflected)
 };
 
 
 
 
-// Static definition
+// Select the hardware CRC engine when it supports the polynomial (generic class otherwise)
+template <typename Type,
+          Type     Polynomial,
+          Type     InitialRemainder,
+          Type     FinalXorValue,
+          bool     ReflectInput,
+          bool     ReflectOutput>
+using CrcSelect = typename std::conditional<CrcEngine::is_supported<Type, Polynomial>(),
+                                            CrcHardware<Type, Polynomial, InitialRemainder, FinalXorValue, ReflectInput, ReflectOutput>,
+                                            Crc<Type, Polynomial, InitialRemainder, FinalXorValue, ReflectInput, ReflectOutput>>::type;
+
+#else
+
 template <typename Type,
           Type     Polynomial,
           Type     InitialRemainder,
           Type     FinalXorValue,
           bool     ReflectInput,
           bool     ReflectOutput>
-constexpr std::array<Type, 256> Crc<Type,
-                                    Polynomial,
-                                    InitialRemainder,
-                                    FinalXorValue,
-                                    ReflectInput,
-                                    ReflectOutput>::m_lookup_table;
+using CrcSelect = Crc<Type, Polynomial, InitialRemainder, FinalXorValue, ReflectInput, ReflectOutput>;
+
+#endif // __TARGET_HAS_CRC_ENGINE__
 
 
 
@@ -202,13 +503,29 @@ constexpr std::array<Type, 256> Crc<Type,
 // Most commonly used CRC types definition
 // --------------------------------------------------------------------
 
-using Crc32 = Crc<uint32_t, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true>;
+template <CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
+using Crc32Strategy = Crc<uint32_t, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true, Strategy>;
+
+template <CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
+using Crc16ModbusStrategy = Crc<uint16_t, 0x8005, 0xFFFF, 0x0000, true,  true,  Strategy>;
+template <CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
+using Crc16XmodemStrategy = Crc<uint16_t, 0x1021, 0x0000, 0x0000, false, false, Strategy>;
+
+template <CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
+using Crc8Strategy    = Crc<uint8_t, 0x07, 0x00, 0x00, false, false, Strategy>;
+template <CrcTableStrategy Strategy = CrcTableStrategy::BYTE>
+using Crc8ItuStrategy = Crc<uint8_t, 0x07, 0x00, 0x55, false, false, Strategy>;
+
+// NOTE: The next types use the hardware CRC engine when available. Use the
+//       *Strategy types above to force the generic table implementation.
+
+using Crc32 = CrcSelect<uint32_t, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true>;
 
-using Crc16Modbus = Crc<uint16_t, 0x8005, 0xFFFF, 0x0000, true,  true>;
-using Crc16Xmodem = Crc<uint16_t, 0x1021, 0x0000, 0x0000, false, false>;
+using Crc16Modbus = CrcSelect<uint16_t, 0x8005, 0xFFFF, 0x0000, true,  true>;
+using Crc16Xmodem = CrcSelect<uint16_t, 0x1021, 0x0000, 0x0000, false, false>;
 
-using Crc8    = Crc<uint8_t, 0x07, 0x00, 0x00, false, false>;
-using Crc8Itu = Crc<uint8_t, 0x07, 0x00, 0x55, false, false>;
+using Crc8    = CrcSelect<uint8_t, 0x07, 0x00, 0x00, false, false>;
+using Crc8Itu = CrcSelect<uint8_t, 0x07, 0x00, 0x55, false, false>;
 
 
 
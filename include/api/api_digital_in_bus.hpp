@@ -32,8 +32,6 @@
 #ifndef __XARMLIB_API_DIGITAL_IN_BUS_HPP
 #define __XARMLIB_API_DIGITAL_IN_BUS_HPP
 
-#include <type_traits>
-
 #include "hal/hal_gpio.hpp"
 #include "api/api_pin_bus.hpp"
 
@@ -46,7 +44,8 @@ namespace xarmlib
 template <Pin::Name... pins>
 class DigitalInBus
 {
-        using Type = typename std::conditional<sizeof...(pins) <= 32, uint32_t, uint64_t>::type;
+        using PortMap = PinBusPortMap<pins...>;
+        using Type    = typename PortMap::Type;
 
     public:
 
@@ -54,43 +53,41 @@ class DigitalInBus
         // PUBLIC MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
-        //template <Pin::Name... pins>
-        constexpr DigitalInBus(const PinBus<pins...>&      pin_bus,
-                               const Gpio::InputMode       input_mode,
-                               const Gpio::InputFilter     input_filter     = Gpio::InputFilter::BYPASS,
-                               const Gpio::InputInvert     input_invert     = Gpio::InputInvert::NORMAL,
-                               const Gpio::InputHysteresis input_hysteresis = Gpio::InputHysteresis::ENABLE)
-            : m_bus { make_array(pin_bus,
-                                 input_mode,
-                                 input_filter,
-                                 input_invert,
-                                 input_hysteresis,
-                                 std::make_index_sequence<sizeof...(pins)>()) }
-        {}
-
-        constexpr DigitalInBus(const PinBus<pins...>&             pin_bus,
-                               const Gpio::InputModeTrueOpenDrain input_mode,
-                               const Gpio::InputFilter            input_filter = Gpio::InputFilter::BYPASS,
-                               const Gpio::InputInvert            input_invert = Gpio::InputInvert::NORMAL)
-            : m_bus { make_array(pin_bus,
-                                 input_mode,
-                                 input_filter,
-                                 input_invert,
-                                 std::make_index_sequence<sizeof...(pins)>()) }
-        {}
+        DigitalInBus(const PinBus<pins...>&      /* pin_bus */,
+                     const Gpio::InputMode       input_mode,
+                     const Gpio::InputFilter     input_filter     = Gpio::InputFilter::BYPASS,
+                     const Gpio::InputInvert     input_invert     = Gpio::InputInvert::NORMAL,
+                     const Gpio::InputHysteresis input_hysteresis = Gpio::InputHysteresis::ENABLE)
+        {
+            // Only the pin configuration is needed. The bus is read directly from the port registers.
+            (Gpio(pins, input_mode, input_filter, input_invert, input_hysteresis), ...);
+        }
+
+        DigitalInBus(const PinBus<pins...>&             /* pin_bus */,
+                     const Gpio::InputModeTrueOpenDrain input_mode,
+                     const Gpio::InputFilter            input_filter = Gpio::InputFilter::BYPASS,
+                     const Gpio::InputInvert            input_invert = Gpio::InputInvert::NORMAL)
+        {
+            // Only the pin configuration is needed. The bus is read directly from the port registers.
+            (Gpio(pins, input_mode, input_filter, input_invert), ...);
+        }
 
         // -------- READ ------------------------------------------------------
 
+        // Read the bus with a single PIN register read per used port
         Type read() const
         {
-            Type value = 0;
+            typename PortMap::PortValues port_values {};
 
-            for(std::size_t pin = 0; pin < get_width(); pin++)
+            for(std::size_t port = 0; port < Port::COUNT; port++)
             {
-                value |= static_cast<Type>(m_bus[pin].read()) << pin;
+                if(PortMap::is_port_used(port) == true)
+                {
+                    port_values[port] = Port::read(static_cast<Port::Name>(port));
+                }
             }
 
-            return value;
+            return PortMap::gather(port_values);
         }
 
         operator Type () const
@@ -122,39 +119,6 @@ class DigitalInBus
 
             return mask;
         }
-
-    private:
-
-        // --------------------------------------------------------------------
-        // PRIVATE MEMBER FUNCTIONS
-        // --------------------------------------------------------------------
-
-        template<std::size_t... index>
-        static constexpr std::array<Gpio, sizeof...(pins)> make_array(const PinBus<pins...>&      pin_bus,
-                                                                      const Gpio::InputMode       input_mode,
-                                                                      const Gpio::InputFilter     input_filter,
-                                                                      const Gpio::InputInvert     input_invert,
-                                                                      const Gpio::InputHysteresis input_hysteresis,
-                                                                      std::index_sequence<index...>)
-        {
-            return { Gpio(pin_bus.get_pin_name(index), input_mode, input_filter, input_invert, input_hysteresis)... };
-        }
-
-        template<std::size_t... index>
-        static constexpr std::array<Gpio, sizeof...(pins)> make_array(const PinBus<pins...>&             pin_bus,
-                                                                      const Gpio::InputModeTrueOpenDrain input_mode,
-                                                                      const Gpio::InputFilter            input_filter,
-                                                                      const Gpio::InputInvert            input_invert,
-                                                                      std::index_sequence<index...>)
-        {
-            return { Gpio(pin_bus.get_pin_name(index), input_mode, input_filter, input_invert)... };
-        }
-
-        // --------------------------------------------------------------------
-        // PRIVATE MEMBER VARIABLES
-        // --------------------------------------------------------------------
-
-        std::array<Gpio, sizeof...(pins)> m_bus;
 };
 
 
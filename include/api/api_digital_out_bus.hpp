@@ -0,0 +1,169 @@
+// ----------------------------------------------------------------------------
+// @file    api_digital_out_bus.hpp
+// @brief   API digital output bus class.
+// @date    6 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_DIGITAL_OUT_BUS_HPP
+#define __XARMLIB_API_DIGITAL_OUT_BUS_HPP
+
+#include "hal/hal_gpio.hpp"
+#include "api/api_pin_bus.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+template <Pin::Name... pins>
+class DigitalOutBus
+{
+        using PortMap = PinBusPortMap<pins...>;
+        using Type    = typename PortMap::Type;
+
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        DigitalOutBus(const PinBus<pins...>& /* pin_bus */, const Gpio::OutputMode output_mode)
+        {
+            // Only the pin configuration is needed. The bus is written directly to the port registers.
+            (Gpio(pins, output_mode), ...);
+        }
+
+        DigitalOutBus(const PinBus<pins...>& /* pin_bus */, const Gpio::OutputModeTrueOpenDrain output_mode)
+        {
+            // Only the pin configuration is needed. The bus is written directly to the port registers.
+            (Gpio(pins, output_mode), ...);
+        }
+
+        // -------- READ ------------------------------------------------------
+
+        // Read the bus pins state with a single PIN register read per used port
+        Type read() const
+        {
+            typename PortMap::PortValues port_values {};
+
+            for(std::size_t port = 0; port < Port::COUNT; port++)
+            {
+                if(PortMap::is_port_used(port) == true)
+                {
+                    port_values[port] = Port::read(static_cast<Port::Name>(port));
+                }
+            }
+
+            return PortMap::gather(port_values);
+        }
+
+        operator Type () const
+        {
+            return read();
+        }
+
+        // Read negated value operator
+        Type operator ! () const
+        {
+            return !read();
+        }
+
+        // -------- WRITE -----------------------------------------------------
+
+        // Write the bus with a single MPIN store per used port. All the bus
+        // pins of a port change at the same time (glitch-free parallel output).
+        // NOTE: Uses the port MASK register, so it must not be interleaved with
+        //       other masked port accesses on the same port (e.g. from an ISR).
+        void write(const Type value)
+        {
+            for(std::size_t port = 0; port < Port::COUNT; port++)
+            {
+                if(PortMap::is_port_used(port) == true)
+                {
+                    Port::write_masked(static_cast<Port::Name>(port), PortMap::PORT_MASKS[port], PortMap::scatter(value, port));
+                }
+            }
+        }
+
+        // Set the bus bits that are one in the supplied value (single SET store per used port)
+        void set(const Type value)
+        {
+            for(std::size_t port = 0; port < Port::COUNT; port++)
+            {
+                if(PortMap::is_port_used(port) == true)
+                {
+                    Port::set(static_cast<Port::Name>(port), PortMap::scatter(value, port));
+                }
+            }
+        }
+
+        // Clear the bus bits that are one in the supplied value (single CLR store per used port)
+        void clear(const Type value)
+        {
+            for(std::size_t port = 0; port < Port::COUNT; port++)
+            {
+                if(PortMap::is_port_used(port) == true)
+                {
+                    Port::clear(static_cast<Port::Name>(port), PortMap::scatter(value, port));
+                }
+            }
+        }
+
+        DigitalOutBus& operator = (const Type value)
+        {
+            write(value);
+            return (*this);
+        }
+
+        // -------- BUS WIDTH / MASK ------------------------------------------------------
+
+        constexpr std::size_t get_width() const
+        {
+            return sizeof...(pins);
+        }
+
+        constexpr Type get_mask() const
+        {
+            Type mask = 0;
+
+            for(std::size_t bit = 0; bit < get_width(); bit++)
+            {
+                mask |= static_cast<Type>(1) << bit;
+            }
+
+            return mask;
+        }
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_DIGITAL_OUT_BUS_HPP
@@ -0,0 +1,781 @@
+// ----------------------------------------------------------------------------
+// @file    api_flash_kv_store.hpp
+// @brief   API wear-leveled log-structured key-value store in flash.
+// @date    10 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_FLASH_KV_STORE_HPP
+#define __XARMLIB_API_FLASH_KV_STORE_HPP
+
+#include "system/array"
+#include "system/cassert"
+#include "system/gsl"
+#include "system/non_copyable"
+#include "api/api_crc.hpp"
+#include "hal/hal_iap.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// Key-value store kept as an append-only log of records in a range of flash
+// sectors used circularly (wear-leveling). Every record is protected by a
+// CRC and programmed in a single page operation, so a power failure can only
+// lose the records that were not yet committed. Sectors are only erased when
+// the oldest sector is garbage collected (its live records are copied to the
+// head of the log before the erase), so one sector is always kept free
+// (a blank sector found when mounting is erased again before it is used).
+//
+// Record layout (padded with 0xFF to a 4 byte multiple, never crossing a page):
+//   | key (16) | length (16, bit 15 = removed) | value | CRC-16 (header + value) |
+//
+// The Flash backend class must provide the static functions get_page_size(),
+// get_sector_size(), get_sector_count(), read_flash(), program_flash() and
+// erase_flash_sectors() (Iap or a simulated flash for host builds).
+template <class Flash = Iap, std::size_t INDEX_SIZE = 32>
+class FlashKvStore : private NonCopyable<FlashKvStore<Flash, INDEX_SIZE>>
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Key = uint16_t;
+
+        static constexpr Key     INVALID_KEY    { 0xFFFF };
+        static constexpr int32_t MAX_VALUE_SIZE { (Flash::get_page_size() - 8 /* sector header */ - 6 /* record overhead */) & ~3 };
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        FlashKvStore(const int32_t first_sector, const int32_t sector_count) : m_first_sector { first_sector },
+                                                                               m_sector_count { sector_count }
+        {
+            assert(sector_count >= 2 && sector_count <= 64);
+            assert(first_sector >= 0 && (first_sector + sector_count) <= Flash::get_sector_count());
+        }
+
+        // Mount the store: rebuild the RAM index from the log and recover from
+        // an interrupted garbage collection. Returns false if the log is
+        // inconsistent (the store must be formatted).
+        bool open()
+        {
+            m_index_count      = 0;
+            m_unerased_sectors = 0;
+
+            int32_t  head_sector   = -1;
+            uint32_t head_sequence = 0;
+            int32_t  used_count    = 0;
+
+            // Find the head sector and erase the sectors with an invalid header
+            for(int32_t sector = 0; sector < m_sector_count; ++sector)
+            {
+                uint32_t sequence = 0;
+
+                if(read_sector_header(sector, sequence) == true)
+                {
+                    if(head_sector < 0 || sequence > head_sequence)
+                    {
+                        head_sector   = sector;
+                        head_sequence = sequence;
+                    }
+
+                    ++used_count;
+                }
+                else if(is_sector_blank(sector) == false)
+                {
+                    if(erase_sector(sector) == false)
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // Blank, but the erase may have been interrupted
+                    m_unerased_sectors |= get_sector_mask(sector);
+                }
+            }
+
+            if(used_count == 0)
+            {
+                m_head_sector = m_sector_count - 1;
+                m_used_count  = 0;
+                m_sequence    = 0;
+
+                return open_next_sector();
+            }
+
+            // The used sectors must be consecutive (in circular order) with
+            // consecutive sequence numbers
+            for(int32_t count = 0; count < used_count; ++count)
+            {
+                const int32_t sector   = (head_sector - count + m_sector_count) % m_sector_count;
+                uint32_t      sequence = 0;
+
+                if(read_sector_header(sector, sequence) == false || sequence != head_sequence - count)
+                {
+                    return false;
+                }
+            }
+
+            m_head_sector = head_sector;
+            m_used_count  = used_count;
+            m_sequence    = head_sequence;
+
+            // Replay the log from the oldest to the head sector
+            for(int32_t count = used_count - 1; count >= 0; --count)
+            {
+                if(scan_sector((head_sector - count + m_sector_count) % m_sector_count) == false)
+                {
+                    return false;
+                }
+            }
+
+            // Power failed before the oldest sector was erased by the garbage collection
+            if(m_used_count == m_sector_count)
+            {
+                return collect_garbage();
+            }
+
+            return true;
+        }
+
+        // Erase all the sectors of the store
+        bool format()
+        {
+            m_index_count = 0;
+            m_head_sector = m_sector_count - 1;
+            m_used_count  = 0;
+            m_sequence    = 0;
+
+            if(Flash::erase_flash_sectors(m_first_sector, m_first_sector + m_sector_count - 1) == false)
+            {
+                return false;
+            }
+
+            m_unerased_sectors = 0;
+
+            return open_next_sector();
+        }
+
+        // -------- ACCESS ----------------------------------------------------
+
+        // Get the number of stored keys
+        std::size_t get_count() const
+        {
+            return m_index_count;
+        }
+
+        // Get the value size of a key (-1 if not found)
+        int32_t get_size(const Key key) const
+        {
+            const int32_t index = find(key);
+
+            return (index < 0) ? -1 : m_index[index].length;
+        }
+
+        // Read the value of a key into the buffer (truncated if the buffer is smaller)
+        // Returns the value size or -1 if the key was not found.
+        int32_t read(const Key key, const gsl::span<uint8_t> buffer) const
+        {
+            const int32_t index = find(key);
+
+            if(index < 0)
+            {
+                return -1;
+            }
+
+            const int32_t length = m_index[index].length;
+            const int32_t count  = (buffer.size() < length) ? static_cast<int32_t>(buffer.size()) : length;
+
+            read_bytes(m_index[index].address + m_record_header_size, buffer.first(count));
+
+            return length;
+        }
+
+        // -------- MODIFY ----------------------------------------------------
+
+        // Write the value of a key (buffered until the page is full or commit() is called)
+        // NOTE: Writing the current value of a key does not use flash.
+        bool write(const Key key, const gsl::span<const uint8_t> value)
+        {
+            if(key == INVALID_KEY || value.size() > MAX_VALUE_SIZE)
+            {
+                return false;
+            }
+
+            int32_t index = find(key);
+
+            if(index >= 0)
+            {
+                if(is_value_equal(index, value) == true)
+                {
+                    return true;
+                }
+            }
+            else if(m_index_count >= INDEX_SIZE)
+            {
+                return false;
+            }
+
+            const int32_t address = append_record(key, static_cast<uint16_t>(value.size()), value);
+
+            if(address < 0)
+            {
+                return false;
+            }
+
+            // NOTE: A garbage collection only relocates the index entries
+            if(index < 0)
+            {
+                index = static_cast<int32_t>(m_index_count++);
+
+                m_index[index].key = key;
+            }
+
+            m_index[index].length  = static_cast<uint16_t>(value.size());
+            m_index[index].address = address;
+
+            return true;
+        }
+
+        // Remove a key (a removal record is written to the log)
+        bool remove(const Key key)
+        {
+            const int32_t index = find(key);
+
+            if(index < 0)
+            {
+                return false;
+            }
+
+            if(append_record(key, m_removed_flag, gsl::span<const uint8_t>()) < 0)
+            {
+                return false;
+            }
+
+            m_index[index] = m_index[--m_index_count];
+
+            return true;
+        }
+
+        // Program the pending records to flash (the rest of the page is left unused)
+        bool commit()
+        {
+            if(m_page_pending == false)
+            {
+                return true;
+            }
+
+            return program_page();
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        struct IndexEntry
+        {
+            Key      key;
+            uint16_t length;
+            int32_t  address;   // Record flash address
+        };
+
+        static constexpr int32_t  m_page_size          { Flash::get_page_size() };
+        static constexpr int32_t  m_sector_size        { Flash::get_sector_size() };
+        static constexpr int32_t  m_sector_header_size { 8 };
+        static constexpr int32_t  m_record_header_size { 4 };
+        static constexpr int32_t  m_record_crc_size    { 2 };
+        static constexpr uint16_t m_sector_magic       { 0x4B56 };     // "KV"
+        static constexpr uint16_t m_removed_flag       { 0x8000 };
+
+        static_assert(m_sector_size % m_page_size == 0, "Sector size must be a multiple of the page size.");
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- LAYOUT ----------------------------------------------------
+
+        int32_t get_sector_address(const int32_t sector) const
+        {
+            return (m_first_sector + sector) * m_sector_size;
+        }
+
+        static constexpr uint64_t get_sector_mask(const int32_t sector)
+        {
+            return static_cast<uint64_t>(1) << sector;
+        }
+
+        static constexpr int32_t get_record_size(const int32_t length)
+        {
+            return (m_record_header_size + length + m_record_crc_size + 3) & ~3;
+        }
+
+        static uint16_t get_u16(const uint8_t* const data)
+        {
+            return static_cast<uint16_t>(data[0] | (data[1] << 8));
+        }
+
+        static void set_u16(uint8_t* const data, const uint16_t value)
+        {
+            data[0] = static_cast<uint8_t>(value);
+            data[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        static bool is_blank(const gsl::span<const uint8_t> buffer)
+        {
+            for(const auto byte : buffer)
+            {
+                if(byte != 0xFF)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // -------- INDEX -----------------------------------------------------
+
+        int32_t find(const Key key) const
+        {
+            for(std::size_t index = 0; index < m_index_count; ++index)
+            {
+                if(m_index[index].key == key)
+                {
+                    return static_cast<int32_t>(index);
+                }
+            }
+
+            return -1;
+        }
+
+        // Apply a valid record found in the log to the index
+        bool replay_record(const Key key, const uint16_t length, const int32_t address)
+        {
+            int32_t index = find(key);
+
+            if((length & m_removed_flag) != 0)
+            {
+                if(index >= 0)
+                {
+                    m_index[index] = m_index[--m_index_count];
+                }
+
+                return true;
+            }
+
+            if(index < 0)
+            {
+                if(m_index_count >= INDEX_SIZE)
+                {
+                    return false;
+                }
+
+                index = static_cast<int32_t>(m_index_count++);
+
+                m_index[index].key = key;
+            }
+
+            m_index[index].length  = length;
+            m_index[index].address = address;
+
+            return true;
+        }
+
+        // -------- FLASH READ ------------------------------------------------
+
+        // Read from flash or from the page buffer if the address is still pending
+        void read_bytes(const int32_t address, const gsl::span<uint8_t> buffer) const
+        {
+            if(m_page_pending == true && address >= m_page_address && address < m_page_address + m_page_offset)
+            {
+                const int32_t offset = address - m_page_address;
+
+                for(int32_t index = 0; index < buffer.size(); ++index)
+                {
+                    buffer[index] = m_page[offset + index];
+                }
+            }
+            else
+            {
+                Flash::read_flash(address, buffer);
+            }
+        }
+
+        bool is_value_equal(const int32_t index, const gsl::span<const uint8_t> value) const
+        {
+            if(m_index[index].length != value.size())
+            {
+                return false;
+            }
+
+            std::array<uint8_t, MAX_VALUE_SIZE> current;
+
+            read_bytes(m_index[index].address + m_record_header_size, gsl::make_span(current).first(value.size()));
+
+            for(int32_t byte = 0; byte < value.size(); ++byte)
+            {
+                if(current[byte] != value[byte])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool read_sector_header(const int32_t sector, uint32_t& sequence) const
+        {
+            std::array<uint8_t, m_sector_header_size> header;
+
+            Flash::read_flash(get_sector_address(sector), header);
+
+            if(get_u16(&header[4]) != m_sector_magic ||
+               get_u16(&header[6]) != Crc16Xmodem::calculate(gsl::make_span(header).first(6)))
+            {
+                return false;
+            }
+
+            sequence = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+
+            return true;
+        }
+
+        bool is_sector_blank(const int32_t sector) const
+        {
+            alignas(4) std::array<uint8_t, m_page_size> page;
+
+            for(int32_t offset = 0; offset < m_sector_size; offset += m_page_size)
+            {
+                Flash::read_flash(get_sector_address(sector) + offset, page);
+
+                if(is_blank(page) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Replay all the valid records of a sector (the first blank page of
+        // the head sector sets the write position)
+        bool scan_sector(const int32_t sector)
+        {
+            const int32_t sector_address = get_sector_address(sector);
+
+            alignas(4) std::array<uint8_t, m_page_size> page;
+
+            for(int32_t page_offset = 0; page_offset < m_sector_size; page_offset += m_page_size)
+            {
+                const int32_t page_address = sector_address + page_offset;
+
+                Flash::read_flash(page_address, page);
+
+                if(is_blank(page) == true)
+                {
+                    if(sector == m_head_sector)
+                    {
+                        set_page(page_address, 0);
+                        return true;
+                    }
+
+                    continue;
+                }
+
+                // A torn or corrupted record ends the records of the page
+                int32_t offset = (page_offset == 0) ? m_sector_header_size : 0;
+
+                while(offset + m_record_header_size + m_record_crc_size <= m_page_size)
+                {
+                    const Key      key    = get_u16(&page[offset]);
+                    const uint16_t length = get_u16(&page[offset + 2]);
+                    const int32_t  size   = length & ~m_removed_flag;
+
+                    if(key == INVALID_KEY || size > MAX_VALUE_SIZE || offset + get_record_size(size) > m_page_size)
+                    {
+                        break;
+                    }
+
+                    const int32_t crc_offset = offset + m_record_header_size + size;
+
+                    if(get_u16(&page[crc_offset]) != Crc16Xmodem::calculate(gsl::make_span(&page[offset], crc_offset - offset)))
+                    {
+                        break;
+                    }
+
+                    if(replay_record(key, length, page_address + offset) == false)
+                    {
+                        return false;
+                    }
+
+                    offset += get_record_size(size);
+                }
+            }
+
+            if(sector == m_head_sector)
+            {
+                // Head sector full: the next record opens a new sector
+                set_page(sector_address + m_sector_size - m_page_size, m_page_size);
+            }
+
+            return true;
+        }
+
+        // -------- FLASH WRITE -----------------------------------------------
+
+        // Start a new page buffer at the supplied flash address
+        void set_page(const int32_t page_address, const int32_t offset)
+        {
+            m_page.fill(0xFF);
+
+            m_page_address = page_address;
+            m_page_offset  = offset;
+            m_page_pending = false;
+        }
+
+        bool program_page()
+        {
+            if(Flash::program_flash(m_page_address, m_page) == false)
+            {
+                return false;
+            }
+
+            // The rest of the page can't be programmed again
+            m_page_offset  = m_page_size;
+            m_page_pending = false;
+
+            return true;
+        }
+
+        bool erase_sector(const int32_t sector)
+        {
+            return Flash::erase_flash_sectors(m_first_sector + sector, m_first_sector + sector);
+        }
+
+        // Open the next (erased) sector of the log and write its header into the page buffer
+        bool open_next_sector()
+        {
+            if(m_collecting == true)
+            {
+                return false;
+            }
+
+            const int32_t next_sector = (m_head_sector + 1) % m_sector_count;
+
+            // NOTE: A sector only found blank by open() is erased again before
+            //       its first page is programmed: a power failure during an
+            //       erase can leave cells that read as erased but are not.
+            if((m_unerased_sectors & get_sector_mask(next_sector)) != 0)
+            {
+                if(erase_sector(next_sector) == false)
+                {
+                    return false;
+                }
+
+                m_unerased_sectors &= ~get_sector_mask(next_sector);
+            }
+
+            m_head_sector = next_sector;
+            m_used_count++;
+            m_sequence++;
+
+            set_page(get_sector_address(m_head_sector), m_sector_header_size);
+
+            m_page[0] = static_cast<uint8_t>(m_sequence);
+            m_page[1] = static_cast<uint8_t>(m_sequence >> 8);
+            m_page[2] = static_cast<uint8_t>(m_sequence >> 16);
+            m_page[3] = static_cast<uint8_t>(m_sequence >> 24);
+
+            set_u16(&m_page[4], m_sector_magic);
+            set_u16(&m_page[6], Crc16Xmodem::calculate(gsl::make_span(m_page).first(6)));
+
+            // Keep one free sector
+            if(m_used_count == m_sector_count)
+            {
+                return collect_garbage();
+            }
+
+            return true;
+        }
+
+        // Move the live records of the oldest sector to the head sector and erase it
+        bool collect_garbage()
+        {
+            const int32_t oldest_sector  = (m_head_sector + 1) % m_sector_count;
+            const int32_t oldest_address = get_sector_address(oldest_sector);
+
+            m_collecting = true;
+
+            bool success = true;
+
+            for(std::size_t index = 0; index < m_index_count && success == true; ++index)
+            {
+                const int32_t address = m_index[index].address;
+
+                if(address < oldest_address || address >= oldest_address + m_sector_size)
+                {
+                    continue;
+                }
+
+                const int32_t size = get_record_size(m_index[index].length);
+
+                // Copy the raw record (header, value and CRC)
+                alignas(4) std::array<uint8_t, m_page_size> record;
+
+                Flash::read_flash(address, gsl::make_span(record).first(size));
+
+                success = reserve(size);
+
+                if(success == true)
+                {
+                    for(int32_t byte = 0; byte < size; ++byte)
+                    {
+                        m_page[m_page_offset + byte] = record[byte];
+                    }
+
+                    m_index[index].address = m_page_address + m_page_offset;
+
+                    m_page_offset += size;
+                    m_page_pending = true;
+                }
+            }
+
+            m_collecting = false;
+
+            // The copies must be programmed before erasing the oldest sector
+            if(success == false || commit() == false || erase_sector(oldest_sector) == false)
+            {
+                return false;
+            }
+
+            m_used_count--;
+
+            return true;
+        }
+
+        // Make room for a record in the page buffer (programming the current
+        // page and opening new pages and sectors as needed)
+        bool reserve(const int32_t size)
+        {
+            for(int32_t opened_sectors = 0; m_page_offset + size > m_page_size; )
+            {
+                if(m_page_pending == true && program_page() == false)
+                {
+                    return false;
+                }
+
+                if((m_page_address + m_page_size) % m_sector_size != 0)
+                {
+                    set_page(m_page_address + m_page_size, 0);
+                }
+                else
+                {
+                    // Give up if the store is full of live records
+                    if(++opened_sectors > m_sector_count || open_next_sector() == false)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // Append a record to the page buffer and return its flash address (-1 on error)
+        int32_t append_record(const Key key, const uint16_t length, const gsl::span<const uint8_t> value)
+        {
+            const int32_t size = get_record_size(static_cast<int32_t>(value.size()));
+
+            if(reserve(size) == false)
+            {
+                return -1;
+            }
+
+            uint8_t* const record = &m_page[m_page_offset];
+
+            set_u16(&record[0], key);
+            set_u16(&record[2], length);
+
+            for(int32_t byte = 0; byte < value.size(); ++byte)
+            {
+                record[m_record_header_size + byte] = value[byte];
+            }
+
+            const int32_t crc_offset = m_record_header_size + static_cast<int32_t>(value.size());
+
+            set_u16(&record[crc_offset], Crc16Xmodem::calculate(gsl::make_span(record, crc_offset)));
+
+            const int32_t address = m_page_address + m_page_offset;
+
+            m_page_offset += size;
+            m_page_pending = true;
+
+            return address;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        const int32_t m_first_sector;
+        const int32_t m_sector_count;
+
+        std::array<IndexEntry, INDEX_SIZE> m_index;
+        std::size_t                        m_index_count { 0 };
+
+        int32_t  m_head_sector { 0 };
+        int32_t  m_used_count  { 0 };
+        uint32_t m_sequence    { 0 };
+        bool     m_collecting  { false };
+
+        uint64_t m_unerased_sectors { 0 };      // Blank sectors found by open() and not erased since
+
+        alignas(4) std::array<uint8_t, m_page_size> m_page;
+        int32_t                                     m_page_address { -1 };
+        int32_t                                     m_page_offset  { 0 };
+        bool                                        m_page_pending { false };
+};
+
+
+
+
+} // namespace xarmlib
+
+
+
+
+#endif // __XARMLIB_API_FLASH_KV_STORE_HPP
@@ -0,0 +1,283 @@
+// ----------------------------------------------------------------------------
+// @file    api_frame_usart.hpp
+// @brief   API interrupt driven USART frame receiver (idle line / inter-character timeout).
+// @date    14 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_FRAME_USART_HPP
+#define __XARMLIB_API_FRAME_USART_HPP
+
+#include "system/delegate"
+#include "system/gsl"
+#include "hal/hal_usart.hpp"
+#include "api/api_usart_gap_timer.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// Receives variable length frames delimited by a silent line (e.g. the
+// Modbus RTU 3.5 character gap). Every received character re-starts the
+// gap timer (UsartGapTimer); when it expires with the receiver idle the frame
+// is complete and is delivered to the frame handler from the timer ISR.
+// NOTE: The gap is measured from the receiver ready event (middle of the
+//       stop bit).
+template <std::size_t MaxFrameSize>
+class FrameUsart : private Usart
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC TYPE ALIASES
+        // --------------------------------------------------------------------
+
+        // Frame handler definition (called from the timer ISR, the frame data
+        // is only valid during the call). Returns the yield flag for FreeRTOS.
+        using FrameHandlerType = int32_t(const gsl::span<const uint8_t> frame);
+        using FrameHandler     = Delegate<FrameHandlerType>;
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DataBits = typename Usart::DataBits;
+        using StopBits = typename Usart::StopBits;
+        using Parity   = typename Usart::Parity;
+
+        using ClockSource = typename Usart::ClockSource;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        FrameUsart(const Pin::Name                 txd,
+                   const Pin::Name                 rxd,
+                   const int32_t                   baudrate,
+                   const int32_t                   irq_priority,
+                   const std::chrono::microseconds frame_gap_us,
+                   const FrameHandler&             frame_handler,
+                   const DataBits                  data_bits    = DataBits::BITS_8,
+                   const StopBits                  stop_bits    = StopBits::BITS_1,
+                   const Parity                    parity       = Parity::NONE,
+                   const ClockSource               clock_source = ClockSource::FRG0) : Usart(txd, rxd, baudrate, data_bits, stop_bits, parity, clock_source),
+                                                                                       m_gap_timer { *this, UsartGapTimer::GapHandler::create<FrameUsart, &FrameUsart::gap_handler>(this) },
+                                                                                       m_frame_handler { frame_handler }
+        {
+            assert(frame_handler != nullptr);
+
+            set_frame_gap(frame_gap_us);
+
+            const auto handler = IrqHandler::template create<FrameUsart, &FrameUsart::irq_handler>(this);
+            Usart::assign_irq_handler(handler, irq_priority);
+
+            Usart::enable_interrupts(Interrupt::RX_READY | Interrupt::RX_OVERRUN_INT);
+        }
+
+        ~FrameUsart()
+        {
+            Usart::disable_interrupts(Interrupt::ALL);
+            Usart::remove_irq_handler();
+        }
+
+        // -------- FORMAT / BAUDRATE -----------------------------------------
+
+        using Usart::set_format;
+        using Usart::set_data_bits;
+        using Usart::set_stop_bits;
+        using Usart::set_parity;
+        using Usart::set_baudrate;
+
+        // -------- ENABLE / DISABLE ------------------------------------------
+
+        using Usart::enable;
+        using Usart::disable;
+        using Usart::is_enabled;
+
+        // -------- FRAME GAP -------------------------------------------------
+
+        // Silent line time that completes a frame
+        // NOTE: Discards the frame being received (if any).
+        void set_frame_gap(const std::chrono::microseconds frame_gap_us)
+        {
+            Usart::disable_interrupts(Interrupt::RX_READY);
+
+            m_gap_timer.set_gap(frame_gap_us);
+
+            m_rx_count    = 0;
+            m_rx_overflow = false;
+
+            Usart::enable_interrupts(Interrupt::RX_READY);
+        }
+
+        std::chrono::microseconds get_frame_gap() const
+        {
+            return m_gap_timer.get_gap();
+        }
+
+        // Modbus RTU frame gap: 3.5 characters (11 bits each) or a fixed
+        // 1750 us for baudrates above 19200
+        static constexpr std::chrono::microseconds get_modbus_rtu_frame_gap(const int32_t baudrate)
+        {
+            return (baudrate > 19200) ? std::chrono::microseconds(1750)
+                                      : std::chrono::microseconds((35 * 11 * 100000LL + baudrate - 1) / baudrate);
+        }
+
+        // -------- WRITE -----------------------------------------------------
+
+        // Write a frame, returning when the last character was completely shifted out
+        void write_frame(const gsl::span<const uint8_t> frame)
+        {
+            for(const auto value : frame)
+            {
+                Usart::write(value);
+            }
+
+            while(Usart::is_tx_idle() == false)
+            {}
+        }
+
+        // -------- ERROR COUNTERS --------------------------------------------
+
+        // Number of characters lost by the hardware (receiver overrun)
+        uint32_t get_rx_overrun_count() const
+        {
+            return m_rx_overrun_count;
+        }
+
+        // Number of frames discarded because they were larger than the buffer
+        uint32_t get_frame_dropped_count() const
+        {
+            return m_frame_dropped_count;
+        }
+
+        void clear_error_counters()
+        {
+            m_rx_overrun_count    = 0;
+            m_frame_dropped_count = 0;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Status     = typename Usart::Status;
+        using Interrupt  = typename Usart::Interrupt;
+        using IrqHandler = typename Usart::IrqHandler;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        int32_t irq_handler()
+        {
+            if((Usart::get_status() & Status::RX_OVERRUN_INT) != 0)
+            {
+                Usart::clear_status(Status::RX_OVERRUN_INT);
+
+                m_rx_overrun_count++;
+            }
+
+            // Drain the receiver into the active buffer
+            while(Usart::is_rx_ready() == true)
+            {
+                // Clear the start flag of the character being read (a new one sets it again)
+                Usart::clear_status(Status::START);
+
+                const uint8_t value = static_cast<uint8_t>(Usart::read());
+
+                if(m_rx_count < MaxFrameSize)
+                {
+                    m_buffer[m_active_buffer][m_rx_count++] = value;
+                }
+                else
+                {
+                    m_rx_overflow = true;
+                }
+            }
+
+            // Re-start the frame gap time
+            m_gap_timer.restart();
+
+            return 0;
+        }
+
+        // Frame completed by the silent line (called with the receiver ready interrupt disabled)
+        int32_t gap_handler()
+        {
+            // Swap buffers so the next frame can be received during the frame handler call
+            const std::size_t frame_buffer = m_active_buffer;
+            const std::size_t frame_size   = m_rx_count;
+            const bool        overflow     = m_rx_overflow;
+
+            m_active_buffer = frame_buffer ^ 1;
+            m_rx_count      = 0;
+            m_rx_overflow   = false;
+
+            Usart::enable_interrupts(Interrupt::RX_READY);
+
+            if(overflow == true)
+            {
+                m_frame_dropped_count++;
+                return 0;
+            }
+
+            if(frame_size == 0)
+            {
+                return 0;
+            }
+
+            return m_frame_handler(gsl::span<const uint8_t>(m_buffer[frame_buffer], frame_size));
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        UsartGapTimer        m_gap_timer;
+
+        FrameHandler         m_frame_handler;
+
+        uint8_t              m_buffer[2][MaxFrameSize];
+        volatile std::size_t m_active_buffer { 0 };
+        volatile std::size_t m_rx_count      { 0 };
+        volatile bool        m_rx_overflow   { false };
+
+        volatile uint32_t    m_rx_overrun_count    { 0 };
+        volatile uint32_t    m_frame_dropped_count { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_FRAME_USART_HPP
@@ -33,17 +33,13 @@
 #define __XARMLIB_API_INPUT_SCANNER_HPP
 
 #include "system/delegate"
-#include "system/dynarray"
+#include "system/gsl"
 #include "hal/hal_timer.hpp"
-
-#include "api/api_digital_out.hpp" /* TEMP*/
+#include "api/api_port_debouncer.hpp"
 
 namespace xarmlib
 {
 
-/* TEMP */
-static DigitalOut led_blue(Pin::Name::P1_15, DigitalOut::OutputMode::PUSH_PULL_HIGH);
-
 
 
 
@@ -63,22 +59,54 @@ class InputScanner
         using PinChangeHandlerType = int32_t();
         using PinChangeHandler     = Delegate<PinChangeHandlerType>;
 
+        // Scan instrumentation hook definition (called with true when a scan
+        // starts and with false when it ends, e.g. to toggle a debug pin)
+        using ScanHookType = void(bool);
+        using ScanHook     = Delegate<ScanHookType>;
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Input handler table defined at compile-time. No run-time registration
+        // is needed and the handlers are called directly (unrolled loop).
+        // Usage: InputScanner::start<InputScanner::InputHandlerTable<&read_keys, &read_switches>>(scan_time);
+        template <InputHandlerType*... input_handlers>
+        struct InputHandlerTable
+        {
+            static bool scan()
+            {
+                bool new_input = false;
+
+                // All handlers must be called (no short-circuit evaluation)
+                ((new_input |= input_handlers()), ...);
+
+                return new_input;
+            }
+        };
+
         // --------------------------------------------------------------------
         // PUBLIC MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
+        // Register an input handler at run-time (scanned when started without a compile-time table)
         static void add_input_handler(const InputHandler& input_handler)
         {
             assert(input_handler != nullptr);
 
-            // Find an empty slot to store the input handler
-            auto result = std::find(m_input_handlers.begin(), m_input_handlers.end(), nullptr);
-
-            // Assert if empty slot not found
-            assert(result != m_input_handlers.end());
+            // Assert if no more slots are available
+            assert(m_input_handler_count < static_cast<std::size_t>(m_input_handlers.size()));
 
             // Assign input handler
-            *result = input_handler;
+            m_input_handlers[m_input_handler_count++] = input_handler;
+        }
+
+        // Add a port debouncer as a single input handler for all its pins
+        // (one port read per scan instead of one handler per pin)
+        template <std::size_t DEPTH_BITS>
+        static void add_port_debouncer(PortDebouncer<DEPTH_BITS>& port_debouncer)
+        {
+            add_input_handler(InputHandler::create<PortDebouncer<DEPTH_BITS>, &PortDebouncer<DEPTH_BITS>::scan>(&port_debouncer));
         }
 
         static void assign_pin_change_handler(const PinChangeHandler& pin_change_handler)
@@ -93,17 +121,29 @@ class InputScanner
             m_pin_change_handler = nullptr;
         }
 
+        static void assign_scan_hook(const ScanHook& scan_hook)
+        {
+            assert(scan_hook != nullptr);
+
+            m_scan_hook = scan_hook;
+        }
+
+        static void remove_scan_hook()
+        {
+            m_scan_hook = nullptr;
+        }
+
+        // Start scanning the input handlers registered at run-time
         static void start(const std::chrono::milliseconds scan_time)
         {
-            if(m_timer.is_running() == false)
-            {
-                const auto handler = Timer::IrqHandler::create<&timer_irq_handler>();
-                m_timer.assign_irq_handler(handler);
-                m_timer.enable_irq();
-            }
+            start(scan_time, Timer::IrqHandler::create<&timer_irq_handler<&scan_input_handlers>>());
+        }
 
-            // Start or restart the timer with the new specified scan time
-            m_timer.start(scan_time, Timer::Mode::FREE_RUNNING);
+        // Start scanning the supplied compile-time input handler table
+        template <class Table>
+        static void start(const std::chrono::milliseconds scan_time)
+        {
+            start(scan_time, Timer::IrqHandler::create<&timer_irq_handler<&Table::scan>>());
         }
 
         static void stop()
@@ -120,8 +160,10 @@ class InputScanner
         {
             if(m_timer.is_running() == false)
             {
-                const auto handler = Timer::IrqHandler::create<&timer_irq_handler>();
-                m_timer.assign_irq_handler(handler);
+                // Ensure the scanner was started before
+                assert(m_timer_irq_handler != nullptr);
+
+                m_timer.assign_irq_handler(m_timer_irq_handler);
                 m_timer.enable_irq();
                 m_timer.reload();
             }
@@ -150,30 +192,62 @@ class InputScanner
 
     private:
 
-        static int32_t timer_irq_handler()
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static void start(const std::chrono::milliseconds scan_time, const Timer::IrqHandler& timer_irq_handler)
         {
-            // @DEBUG
-            led_blue.write(0);
+            // Stop a running scanner before replacing its IRQ handler
+            if(m_timer.is_running() == true)
+            {
+                stop();
+            }
 
+            m_timer_irq_handler = timer_irq_handler;
+
+            m_timer.assign_irq_handler(m_timer_irq_handler);
+            m_timer.enable_irq();
+
+            // Start or restart the timer with the new specified scan time
+            m_timer.start(scan_time, Timer::Mode::FREE_RUNNING);
+        }
+
+        // Scan the input handlers registered at run-time (only the used slots)
+        static bool scan_input_handlers()
+        {
             bool new_input = false;
 
-            for(auto handler : m_input_handlers)
+            for(std::size_t index = 0; index < m_input_handler_count; ++index)
             {
-                if(handler != nullptr && handler() == true)
+                if(m_input_handlers[index]() == true)
                 {
                     new_input = true;
                 }
             }
 
+            return new_input;
+        }
+
+        template <InputHandlerType* scan>
+        static int32_t timer_irq_handler()
+        {
+            if(m_scan_hook != nullptr)
+            {
+                m_scan_hook(true);
+            }
+
             int32_t yield = 0;  // Used in FreeRTOS
 
-            if(new_input == true && m_pin_change_handler != nullptr)
+            if(scan() == true && m_pin_change_handler != nullptr)
             {
                 yield = m_pin_change_handler();
             }
 
-            // @DEBUG
-            led_blue.write(1);
+            if(m_scan_hook != nullptr)
+            {
+                m_scan_hook(false);
+            }
 
             return yield;
         }
@@ -182,9 +256,12 @@ class InputScanner
         // PRIVATE MEMBER VARIABLES
         // --------------------------------------------------------------------
 
-        static Timer                    m_timer;
-        static dynarray<InputHandler>   m_input_handlers;
-        static PinChangeHandler         m_pin_change_handler;
+        static Timer                            m_timer;
+        static Timer::IrqHandler                m_timer_irq_handler;
+        static const gsl::span<InputHandler>    m_input_handlers;       // Statically allocated in the source file
+        static std::size_t                      m_input_handler_count;
+        static PinChangeHandler                 m_pin_change_handler;
+        static ScanHook                         m_scan_hook;
 };
 
 
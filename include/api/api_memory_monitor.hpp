@@ -0,0 +1,172 @@
+// ----------------------------------------------------------------------------
+// @file    api_memory_monitor.hpp
+// @brief   API memory monitor class (stack / heap usage and stack guard).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_MEMORY_MONITOR_HPP
+#define __XARMLIB_API_MEMORY_MONITOR_HPP
+
+#include "system/chrono"
+#include "system/delegate"
+#include "system/memory_pool"
+#include "hal/hal_timer.hpp"
+
+#include <cstdlib>
+#include <optional>
+
+namespace xarmlib
+{
+
+
+
+
+// NOTE: On the Cortex-M0+ the thread mode and the interrupts share the same
+//       main stack (there is no process stack in use), so the stack figures
+//       below include the nested interrupt handlers frames.
+class MemoryMonitor
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Stack overflow (stack guard canary overwritten) handler definition
+        using StackOverflowHandlerType = int32_t();
+        using StackOverflowHandler     = Delegate<StackOverflowHandlerType>;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- STACK -----------------------------------------------------
+
+        // Main stack usage in bytes:
+        // - capacity:        size of the stack region (canary included)
+        // - used:            current depth of the stack
+        // - high_water_mark: deepest depth reached so far (needs the symbol
+        //                    XARMLIB_ENABLE_STACK_PAINTING defined, 0 otherwise)
+        // - failures:        1 if the stack guard canary was overwritten
+        static MemoryStats get_stack_stats();
+
+        // Check the canary written at the bottom of the stack by the startup
+        static bool is_stack_canary_intact();
+
+        // -------- HEAP ------------------------------------------------------
+
+        static MemoryStats get_heap_stats()
+        {
+            return xarmlib::get_heap_stats();
+        }
+
+        // -------- STACK GUARD -----------------------------------------------
+
+        // Check the stack guard canary periodically (takes control of one
+        // available Timer only while the guard is running). On overflow the
+        // checks stop and the supplied handler is called once (or 'abort()'
+        // if no handler was supplied).
+        static void start_stack_guard(const std::chrono::microseconds period, const StackOverflowHandler& handler = StackOverflowHandler())
+        {
+            if(m_stack_guard_timer.has_value() == true)
+            {
+                stop_stack_guard();
+            }
+
+            m_stack_overflow_handler = handler;
+
+            m_stack_guard_timer.emplace();
+
+            m_stack_guard_timer->assign_irq_handler(Timer::IrqHandler::create<&stack_guard_irq_handler>());
+            m_stack_guard_timer->enable_irq();
+            m_stack_guard_timer->start(period, Timer::Mode::FREE_RUNNING);
+        }
+
+        // Stop the checks and release the Timer
+        // NOTE: Must not be called from the overflow handler (nor restart the
+        //       guard from it): the Timer would be destroyed while its IRQ
+        //       handler is running. The checks are already stopped when the
+        //       overflow handler is called.
+        static void stop_stack_guard()
+        {
+            if(m_stack_guard_timer.has_value() == true)
+            {
+                m_stack_guard_timer->stop();
+                m_stack_guard_timer->clear_pending_irq();
+
+                m_stack_guard_timer->disable_irq();
+                m_stack_guard_timer->remove_irq_handler();
+
+                m_stack_guard_timer.reset();
+            }
+        }
+
+        static bool is_stack_guard_running()
+        {
+            return m_stack_guard_timer.has_value() == true && m_stack_guard_timer->is_running() == true;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static int32_t stack_guard_irq_handler()
+        {
+            if(is_stack_canary_intact() == true)
+            {
+                return 0;
+            }
+
+            // Report the overflow only once (the Timer is released by 'stop_stack_guard()')
+            m_stack_guard_timer->stop();
+            m_stack_guard_timer->disable_irq();
+
+            if(m_stack_overflow_handler == nullptr)
+            {
+                abort();
+            }
+
+            return m_stack_overflow_handler();
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        static std::optional<Timer> m_stack_guard_timer;
+        static StackOverflowHandler m_stack_overflow_handler;
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_MEMORY_MONITOR_HPP
@@ -0,0 +1,388 @@
+// ----------------------------------------------------------------------------
+// @file    api_multidrop_usart.hpp
+// @brief   API interrupt driven 9-bit multidrop (RS-485) USART class.
+// @date    13 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_MULTIDROP_USART_HPP
+#define __XARMLIB_API_MULTIDROP_USART_HPP
+
+#include "system/gsl"
+#include "hal/hal_usart.hpp"
+#include "api/api_usart_gap_timer.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// Multidrop bus node: the hardware ignores every character until an address
+// character (9th bit set) equal to the node address is received, so only the
+// frames sent to this node generate receive interrupts.
+// A frame is complete when another address character is received or when the
+// line is silent for longer than the frame gap (4 character times by default,
+// measured by the gap timer (UsartGapTimer) re-started on every received
+// character and completed from the timer ISR, so no polling is needed).
+// NOTE: Only one complete frame is held; frames sent to this node while the
+//       previous one was not read yet are dropped (and counted).
+template <std::size_t MaxFrameSize>
+class MultidropUsart : private Usart
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using StopBits = typename Usart::StopBits;
+        using Parity   = typename Usart::Parity;
+
+        using ClockSource          = typename Usart::ClockSource;
+        using DriverEnablePolarity = typename Usart::DriverEnablePolarity;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // NOTE: Pass Pin::Name::NC as 'rts' if the RS-485 driver enable is
+        //       controlled elsewhere.
+        MultidropUsart(const Pin::Name            txd,
+                       const Pin::Name            rxd,
+                       const int32_t              baudrate,
+                       const int32_t              irq_priority,
+                       const uint8_t              address,
+                       const Pin::Name            rts          = Pin::Name::NC,
+                       const DriverEnablePolarity rts_polarity = DriverEnablePolarity::ACTIVE_HIGH,
+                       const StopBits             stop_bits    = StopBits::BITS_1,
+                       const Parity               parity       = Parity::NONE,
+                       const ClockSource          clock_source = ClockSource::FRG0) : Usart(txd, rxd, baudrate, DataBits::BITS_9, stop_bits, parity, clock_source),
+                                                                                      m_gap_timer { *this, UsartGapTimer::GapHandler::create<MultidropUsart, &MultidropUsart::gap_handler>(this) },
+                                                                                      m_address { address }
+        {
+            if(rts != Pin::Name::NC)
+            {
+                // Keep the driver enabled during the last character stop bit(s)
+                Usart::enable_driver_enable(rts, rts_polarity, true);
+            }
+
+            set_frame_gap_characters(4);
+
+            Usart::enable_address_match(address);
+            Usart::enable_address_detect();
+
+            const auto handler = IrqHandler::template create<MultidropUsart, &MultidropUsart::irq_handler>(this);
+            Usart::assign_irq_handler(handler, irq_priority);
+
+            Usart::enable_interrupts(Interrupt::RX_READY | Interrupt::RX_OVERRUN_INT);
+        }
+
+        ~MultidropUsart()
+        {
+            Usart::disable_interrupts(Interrupt::ALL);
+            Usart::remove_irq_handler();
+        }
+
+        // -------- ENABLE / DISABLE ------------------------------------------
+
+        using Usart::enable;
+        using Usart::disable;
+        using Usart::is_enabled;
+
+        // -------- ADDRESS ---------------------------------------------------
+
+        // Change the node address (discarding the frame being received, if any)
+        void set_address(const uint8_t address)
+        {
+            Usart::disable_interrupts(Interrupt::RX_READY);
+
+            m_gap_timer.stop();
+
+            m_receiving = false;
+            m_address   = address;
+
+            Usart::enable_address_match(address);
+            Usart::enable_address_detect();
+
+            Usart::enable_interrupts(Interrupt::RX_READY);
+        }
+
+        uint8_t get_address() const
+        {
+            return m_address;
+        }
+
+        // -------- FRAME GAP -------------------------------------------------
+
+        // Silence on the line that completes the frame being received
+        // NOTE: Discards the frame being received (if any).
+        void set_frame_gap(const std::chrono::microseconds gap_us)
+        {
+            Usart::disable_interrupts(Interrupt::RX_READY);
+
+            m_gap_timer.set_gap(gap_us);
+
+            if(m_receiving == true)
+            {
+                m_receiving = false;
+
+                // Let the hardware ignore the data sent to other nodes
+                Usart::enable_address_detect();
+            }
+
+            Usart::enable_interrupts(Interrupt::RX_READY);
+        }
+
+        // Frame gap in character times (13 bit times each, the longest 9-bit character:
+        // start bit, 9 data bits, parity bit and 2 stop bits)
+        void set_frame_gap_characters(const int32_t characters)
+        {
+            const int64_t baudrate = Usart::get_baudrate_settings().baudrate;
+
+            assert(characters > 0 && baudrate > 0);
+
+            set_frame_gap(std::chrono::microseconds((characters * 13 * 1000000LL + baudrate - 1) / baudrate));
+        }
+
+        std::chrono::microseconds get_frame_gap() const
+        {
+            return m_gap_timer.get_gap();
+        }
+
+        // -------- READ ------------------------------------------------------
+
+        // Return 'true' if a complete frame is waiting to be read
+        bool is_frame_ready() const
+        {
+            return m_frame_ready;
+        }
+
+        // Read the received frame data (non-blocking), returning the frame size or -1 if
+        // no complete frame is available (data that does not fit the buffer is discarded)
+        int32_t read_frame(const gsl::span<uint8_t> buffer)
+        {
+            if(is_frame_ready() == false)
+            {
+                return -1;
+            }
+
+            const int32_t frame_size = static_cast<int32_t>(m_frame_size);
+            const int32_t count      = (frame_size < buffer.size()) ? frame_size : static_cast<int32_t>(buffer.size());
+
+            for(int32_t index = 0; index < count; ++index)
+            {
+                buffer[index] = m_frame_buffer[index];
+            }
+
+            // Release the frame buffer (the IRQ handler does not touch it while a frame is ready)
+            m_frame_ready = false;
+
+            return frame_size;
+        }
+
+        // -------- WRITE -----------------------------------------------------
+
+        // Write a frame (address character followed by the data), returning
+        // when the last character was completely shifted out
+        // NOTE: Blocking write. With the RS-485 driver enable controlled by
+        //       hardware the bus is released as soon as this returns.
+        void write_frame(const uint8_t address, const gsl::span<const uint8_t> data)
+        {
+            Usart::write_address(address);
+
+            for(const auto value : data)
+            {
+                Usart::write(value);
+            }
+
+            while(Usart::is_tx_idle() == false)
+            {}
+        }
+
+        // -------- ERROR COUNTERS --------------------------------------------
+
+        // Number of characters lost by the hardware (receiver overrun)
+        uint32_t get_rx_overrun_count() const
+        {
+            return m_rx_overrun_count;
+        }
+
+        // Number of frames sent to this node that were discarded (previous
+        // frame not read yet or frame larger than the buffer)
+        uint32_t get_frame_dropped_count() const
+        {
+            return m_frame_dropped_count;
+        }
+
+        void clear_error_counters()
+        {
+            m_rx_overrun_count    = 0;
+            m_frame_dropped_count = 0;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DataBits   = typename Usart::DataBits;
+        using Status     = typename Usart::Status;
+        using Interrupt  = typename Usart::Interrupt;
+        using IrqHandler = typename Usart::IrqHandler;
+
+        static constexpr uint32_t ADDRESS_BIT = 0x100;  // 9th bit of the data (address character)
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        void end_frame()
+        {
+            m_receiving = false;
+
+            if(m_rx_overflow == true)
+            {
+                m_frame_dropped_count++;
+            }
+            else
+            {
+                m_frame_size  = m_rx_count;
+                m_frame_ready = true;
+            }
+        }
+
+        int32_t irq_handler()
+        {
+            if((Usart::get_status() & Status::RX_OVERRUN_INT) != 0)
+            {
+                Usart::clear_status(Status::RX_OVERRUN_INT);
+
+                m_rx_overrun_count++;
+            }
+
+            while(Usart::is_rx_ready() == true)
+            {
+                // Clear the start flag of the character being read (a new one sets it again)
+                Usart::clear_status(Status::START);
+
+                const uint32_t value = Usart::read();
+
+                if((value & ADDRESS_BIT) != 0)
+                {
+                    // Address character (matched by hardware in address detect
+                    // mode): it also completes the frame being received.
+                    if(m_receiving == true)
+                    {
+                        end_frame();
+                    }
+
+                    if((value & 0xFF) != m_address)
+                    {
+                        // Frame to another node: let the hardware ignore its data
+                        Usart::enable_address_detect();
+                    }
+                    else if(m_frame_ready == true)
+                    {
+                        // Previous frame not read yet
+                        m_frame_dropped_count++;
+
+                        Usart::enable_address_detect();
+                    }
+                    else
+                    {
+                        // Frame to this node: receive its data
+                        Usart::disable_address_detect();
+
+                        m_rx_count    = 0;
+                        m_rx_overflow = false;
+                        m_receiving   = true;
+                    }
+                }
+                else if(m_receiving == true)
+                {
+                    if(m_rx_count < MaxFrameSize)
+                    {
+                        m_frame_buffer[m_rx_count++] = static_cast<uint8_t>(value);
+                    }
+                    else
+                    {
+                        m_rx_overflow = true;
+                    }
+                }
+            }
+
+            if(m_receiving == true)
+            {
+                // Re-start the frame gap time
+                m_gap_timer.restart();
+            }
+
+            return 0;
+        }
+
+        // Complete the frame being received when the line was silent for the frame gap
+        // (called with the receiver ready interrupt disabled)
+        int32_t gap_handler()
+        {
+            if(m_receiving == true)
+            {
+                end_frame();
+
+                // Let the hardware ignore the data sent to other nodes
+                Usart::enable_address_detect();
+            }
+
+            return 0;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        UsartGapTimer        m_gap_timer;
+
+        uint8_t              m_address;
+
+        uint8_t              m_frame_buffer[MaxFrameSize];
+        volatile std::size_t m_rx_count    { 0 };
+        volatile std::size_t m_frame_size  { 0 };
+        volatile bool        m_receiving   { false };
+        volatile bool        m_rx_overflow { false };
+        volatile bool        m_frame_ready { false };
+
+        volatile uint32_t    m_rx_overrun_count    { 0 };
+        volatile uint32_t    m_frame_dropped_count { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_MULTIDROP_USART_HPP
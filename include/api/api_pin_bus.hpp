@@ -1,6 +1,6 @@
 // ----------------------------------------------------------------------------
 // @file    api_pin_bus.hpp
-// @brief   API pin bus class.
+// @brief   API pin bus and pin bus port map classes.
 // @date    21 June 2018
 // ----------------------------------------------------------------------------
 //
@@ -32,8 +32,11 @@
 #ifndef __XARMLIB_API_PIN_BUS_HPP
 #define __XARMLIB_API_PIN_BUS_HPP
 
+#include <type_traits>
+
 #include "system/array"
 #include "hal/hal_pin.hpp"
+#include "hal/hal_port.hpp"
 
 namespace xarmlib
 {
@@ -74,6 +77,170 @@ class PinBus
 
 
 
+namespace private_pin_bus
+{
+
+// Run of consecutive bus bits mapped to consecutive bits of the same port
+struct PortSegment
+{
+    std::size_t port;       // Port index
+    uint32_t    port_shift; // Position of the first bit in the port register
+    uint32_t    bus_shift;  // Position of the first bit in the bus value
+    uint32_t    mask;       // Right aligned mask of the run
+};
+
+constexpr std::size_t get_port_index(const Pin::Name pin_name)
+{
+    return static_cast<std::size_t>(pin_name) / 32;
+}
+
+constexpr uint32_t get_port_bit(const Pin::Name pin_name)
+{
+    return static_cast<uint32_t>(pin_name) % 32;
+}
+
+// Check if the pin at the supplied index extends the run of the previous pin
+template <std::size_t Size>
+constexpr bool is_run_continuation(const std::array<Pin::Name, Size>& pin_names, const std::size_t index)
+{
+    return index > 0
+        && pin_names[index - 1] != Pin::Name::NC
+        && pin_names[index]     != Pin::Name::NC
+        && get_port_index(pin_names[index - 1]) == get_port_index(pin_names[index])
+        && get_port_bit(pin_names[index - 1]) + 1 == get_port_bit(pin_names[index]);
+}
+
+template <std::size_t Size>
+constexpr std::size_t count_segments(const std::array<Pin::Name, Size>& pin_names)
+{
+    std::size_t count = 0;
+
+    for(std::size_t index = 0; index < Size; index++)
+    {
+        if(pin_names[index] != Pin::Name::NC && is_run_continuation(pin_names, index) == false)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+template <std::size_t Count, std::size_t Size>
+constexpr std::array<PortSegment, Count> make_segments(const std::array<Pin::Name, Size>& pin_names)
+{
+    std::array<PortSegment, Count> segments {};
+    std::size_t                    segment = 0;
+
+    for(std::size_t index = 0; index < Size; index++)
+    {
+        if(pin_names[index] == Pin::Name::NC)
+        {
+            continue;
+        }
+
+        if(is_run_continuation(pin_names, index) == true)
+        {
+            segments[segment - 1].mask = (segments[segment - 1].mask << 1) | 1;
+        }
+        else
+        {
+            segments[segment++] = { get_port_index(pin_names[index]), get_port_bit(pin_names[index]), static_cast<uint32_t>(index), 1 };
+        }
+    }
+
+    return segments;
+}
+
+template <std::size_t Size>
+constexpr std::array<uint32_t, Port::COUNT> make_port_masks(const std::array<Pin::Name, Size>& pin_names)
+{
+    std::array<uint32_t, Port::COUNT> port_masks {};
+
+    for(std::size_t index = 0; index < Size; index++)
+    {
+        if(pin_names[index] != Pin::Name::NC)
+        {
+            port_masks[get_port_index(pin_names[index])] |= 1UL << get_port_bit(pin_names[index]);
+        }
+    }
+
+    return port_masks;
+}
+
+} // namespace private_pin_bus
+
+
+
+
+// Compile-time map between the bits of a bus value and the bits of the port
+// registers. Pins are grouped by port and consecutive pins are merged into
+// segments, so a bus laid out on consecutive port pins gathers / scatters
+// with a single shift and mask. NC pins are ignored (read as zero).
+template <Pin::Name... pins>
+class PinBusPortMap
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Type = typename std::conditional<sizeof...(pins) <= 32, uint32_t, uint64_t>::type;
+
+        using PortValues = std::array<uint32_t, Port::COUNT>;
+
+        static constexpr std::array<Pin::Name, sizeof...(pins)> PIN_NAMES { pins... };
+
+        static constexpr std::size_t SEGMENT_COUNT = private_pin_bus::count_segments(PIN_NAMES);
+
+        static constexpr std::array<private_pin_bus::PortSegment, SEGMENT_COUNT> SEGMENTS = private_pin_bus::make_segments<SEGMENT_COUNT>(PIN_NAMES);
+
+        // Mask of the bus pins in each port (zero if the port is not used)
+        static constexpr PortValues PORT_MASKS = private_pin_bus::make_port_masks(PIN_NAMES);
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static constexpr bool is_port_used(const std::size_t port)
+        {
+            return PORT_MASKS[port] != 0;
+        }
+
+        // Gather the bus value from the port register values
+        static constexpr Type gather(const PortValues& port_values)
+        {
+            Type value = 0;
+
+            for(const auto& segment : SEGMENTS)
+            {
+                value |= static_cast<Type>((port_values[segment.port] >> segment.port_shift) & segment.mask) << segment.bus_shift;
+            }
+
+            return value;
+        }
+
+        // Scatter the bus value into the bits of the supplied port register
+        static constexpr uint32_t scatter(const Type value, const std::size_t port)
+        {
+            uint32_t port_value = 0;
+
+            for(const auto& segment : SEGMENTS)
+            {
+                if(segment.port == port)
+                {
+                    port_value |= (static_cast<uint32_t>(value >> segment.bus_shift) & segment.mask) << segment.port_shift;
+                }
+            }
+
+            return port_value;
+        }
+};
+
+
+
+
 } // namespace xarmlib
 
 #endif // __XARMLIB_API_PIN_BUS_HPP
@@ -0,0 +1,219 @@
+// ----------------------------------------------------------------------------
+// @file    api_port_debouncer.hpp
+// @brief   API port debouncer class (bit-sliced vertical counters).
+// @date    8 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_PORT_DEBOUNCER_HPP
+#define __XARMLIB_API_PORT_DEBOUNCER_HPP
+
+#include "system/array"
+#include "system/cassert"
+#include "hal/hal_port.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// Debounce all the pins of a port in parallel. Each bit has its own counter
+// stored vertically across DEPTH_BITS bit-planes, so one sample updates the
+// 32 counters with a handful of logic operations. A bit toggles its debounced
+// state after 'depth' consecutive samples different from the current state
+// (maximum depth of 2^DEPTH_BITS samples).
+//
+// The scan() member function can be registered in the InputScanner as a
+// single input handler for all the pins of the port:
+//   InputScanner::add_port_debouncer(debouncer);
+template <std::size_t DEPTH_BITS = 3>
+class PortDebouncer
+{
+        static_assert(DEPTH_BITS > 0 && DEPTH_BITS <= 8, "Debounce counter must have between 1 and 8 bits.");
+
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        static constexpr uint32_t MAX_DEPTH { 1UL << DEPTH_BITS };
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Debounce the pins selected by the supplied mask. Pins in the active
+        // low mask are inverted before debouncing (e.g. keys with pull-ups),
+        // so a set bit in the state always means an active (pressed) input.
+        PortDebouncer(const Port::Name port,
+                      const uint32_t   mask,
+                      const uint32_t   depth           = MAX_DEPTH,
+                      const uint32_t   active_low_mask = 0) : m_port { port },
+                                                              m_mask { mask },
+                                                              m_active_low_mask { active_low_mask & mask }
+        {
+            set_depth(mask, depth);
+
+            // Start from the current input state (no edges reported at startup)
+            m_state = get_sample();
+        }
+
+        // -------- CONFIGURATION ---------------------------------------------
+
+        // Set the debounce depth (number of consecutive samples) of the pins in the mask
+        void set_depth(const uint32_t mask, const uint32_t depth)
+        {
+            assert(depth >= 1 && depth <= MAX_DEPTH);
+
+            // Counters count down from (depth - 1) and toggle on underflow
+            const uint32_t reload = depth - 1;
+
+            for(std::size_t plane = 0; plane < DEPTH_BITS; plane++)
+            {
+                if(((reload >> plane) & 1) != 0)
+                {
+                    m_reload[plane] |= mask;
+                }
+                else
+                {
+                    m_reload[plane] &= ~mask;
+                }
+
+                m_counter[plane] = m_reload[plane];
+            }
+        }
+
+        // -------- SCAN ------------------------------------------------------
+
+        // Read the port and debounce all the pins
+        // NOTE: Returns true if any pin changed its debounced state
+        bool scan()
+        {
+            return update(get_sample());
+        }
+
+        // Debounce a new sample (already masked and with the active low pins inverted)
+        // NOTE: Returns true if any bit changed its debounced state
+        bool update(const uint32_t sample)
+        {
+            // Bits that differ from the debounced state count down, the others reload
+            const uint32_t delta = sample ^ m_state;
+
+            // Vertical decrement of the counters of the changed bits
+            uint32_t borrow = delta;
+
+            for(std::size_t plane = 0; plane < DEPTH_BITS; plane++)
+            {
+                const uint32_t counter = m_counter[plane];
+
+                m_counter[plane] = counter ^ borrow;
+                borrow &= ~counter;
+            }
+
+            // A borrow out of the last plane means the counter underflowed
+            const uint32_t toggle = borrow;
+
+            // Reload the counters of the stable and the toggled bits
+            const uint32_t counting = delta & ~toggle;
+
+            for(std::size_t plane = 0; plane < DEPTH_BITS; plane++)
+            {
+                m_counter[plane] = (m_counter[plane] & counting) | (m_reload[plane] & ~counting);
+            }
+
+            m_state   ^= toggle;
+            m_pressed  = toggle & m_state;
+            m_released = toggle & ~m_state;
+
+            return (toggle != 0);
+        }
+
+        // -------- STATE / EDGES ---------------------------------------------
+
+        // Debounced state (set bits are active inputs)
+        uint32_t get_state() const
+        {
+            return m_state;
+        }
+
+        // Bits that became active in the last scan
+        uint32_t get_pressed() const
+        {
+            return m_pressed;
+        }
+
+        // Bits that became inactive in the last scan
+        uint32_t get_released() const
+        {
+            return m_released;
+        }
+
+        Port::Name get_port() const
+        {
+            return m_port;
+        }
+
+        uint32_t get_mask() const
+        {
+            return m_mask;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        uint32_t get_sample() const
+        {
+            return (Port::read(m_port) ^ m_active_low_mask) & m_mask;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        const Port::Name                 m_port;
+        const uint32_t                   m_mask;
+        const uint32_t                   m_active_low_mask;
+
+        std::array<uint32_t, DEPTH_BITS> m_counter  {};   // Vertical counters (one bit-plane per element)
+        std::array<uint32_t, DEPTH_BITS> m_reload   {};   // Vertical reload values (depth - 1)
+
+        uint32_t                         m_state    { 0 };
+        uint32_t                         m_pressed  { 0 };
+        uint32_t                         m_released { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_PORT_DEBOUNCER_HPP
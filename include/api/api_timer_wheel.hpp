@@ -0,0 +1,467 @@
+// ----------------------------------------------------------------------------
+// @file    api_timer_wheel.hpp
+// @brief   API timer wheel class (virtual timers multiplexed on a single timer).
+// @date    4 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_TIMER_WHEEL_HPP
+#define __XARMLIB_API_TIMER_WHEEL_HPP
+
+#include "system/array"
+#include "system/cassert"
+#include "system/chrono"
+#include "system/delegate"
+#include "system/non_copyable"
+#include "hal/hal_timer.hpp"
+#include "hal/hal_us_ticker.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+class TimerWheel;
+
+
+
+
+// Virtual timer (intrusive node owned by the user and managed by a TimerWheel)
+class SoftTimer : private NonCopyable<SoftTimer>
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Expiry handler definition
+        // NOTE: Returns yield flag for FreeRTOS
+        using HandlerType = int32_t();
+        using Handler     = Delegate<HandlerType>;
+
+        // Timer running mode selection
+        enum class Mode
+        {
+            FREE_RUNNING,   // Re-start at expiry
+            SINGLE_SHOT     // Stop at expiry
+        };
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        explicit SoftTimer(const Handler& handler) : m_handler { handler }
+        {
+            assert(handler != nullptr);
+        }
+
+        bool is_running() const
+        {
+            return m_wheel != nullptr;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // FRIEND CLASSES
+        // --------------------------------------------------------------------
+
+        friend class TimerWheel;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        SoftTimer*  m_prev         { nullptr };  // Previous timer in the same wheel slot
+        SoftTimer*  m_next         { nullptr };  // Next timer in the same wheel slot
+        SoftTimer*  m_next_expired { nullptr };  // Next timer in the wheel dispatch list
+        TimerWheel* m_wheel        { nullptr };  // Wheel managing this timer (nullptr if stopped)
+        uint32_t    m_expiry       { 0 };        // Absolute expiry tick
+        uint32_t    m_period       { 0 };        // Reload period in ticks (0 if single shot)
+        bool        m_expired      { false };    // In the dispatch list (cleared by a start / stop)
+        Handler     m_handler;                   // User defined expiry handler
+};
+
+
+
+
+// Hashed timer wheel running from a single (single shot) timer that is only
+// programmed to fire at the next wheel slot that holds timers. Start and stop
+// are O(1) and the next slot is found in O(1) through a slot occupancy mask.
+// Tick boundaries are kept on the UsTicker time base so that wake-up latency
+// does not accumulate.
+// NOTE: Timers are not allocated by the wheel. They must remain valid while running
+//       (and until the end of the dispatch when stopped from an expiry handler).
+// NOTE: The wheel state is changed with all the interrupts disabled (PRIMASK),
+//       so timers can be started and stopped from any context. The expiry
+//       handlers are called with the interrupts enabled.
+class TimerWheel : private NonCopyable<TimerWheel>
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Number of wheel slots (one bit for each slot in the occupancy mask)
+        static constexpr std::size_t SLOT_COUNT { 32 };
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // NOTE: The tick sets the resolution of all the timers (delays are rounded up to a tick)
+        explicit TimerWheel(const std::chrono::microseconds tick) : m_tick_us { static_cast<uint32_t>(tick.count()) }
+        {
+            assert(tick.count() > 0 && tick.count() <= Timer::get_max_rate_us());
+
+            m_base_time_us = static_cast<uint32_t>(UsTicker::now().count());
+
+            const auto handler = Timer::IrqHandler::create<TimerWheel, &TimerWheel::timer_irq_handler>(this);
+            m_timer.assign_irq_handler(handler);
+            m_timer.enable_irq();
+        }
+
+        ~TimerWheel()
+        {
+            m_timer.stop();
+            m_timer.disable_irq();
+            m_timer.remove_irq_handler();
+        }
+
+        // Start (or restart) a timer to expire after the supplied delay
+        void start(SoftTimer& timer, const std::chrono::microseconds delay, const SoftTimer::Mode mode)
+        {
+            // Delays fit in half the tick range (wrap-safe expiry comparison) and
+            // in 32 bits with the elapsed part of the current tick (conversion)
+            assert(delay.count() >= 0 && delay.count() <= INT32_MAX);
+
+            const uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            if(timer.m_wheel != nullptr)
+            {
+                unlink(timer);
+            }
+
+            // A pending expiry of the previous run is cancelled
+            timer.m_expired = false;
+
+            uint32_t       fraction_us = 0;
+            const uint32_t now         = get_current_tick(fraction_us);
+
+            // The part of the current tick already elapsed counts for the delay
+            const uint32_t delay_ticks = convert_us_to_ticks(static_cast<uint32_t>(delay.count()) + fraction_us);
+
+            timer.m_wheel  = this;
+            timer.m_expiry = now + delay_ticks;
+            timer.m_period = (mode == SoftTimer::Mode::FREE_RUNNING) ? convert_us_to_ticks(static_cast<uint32_t>(delay.count())) : 0;
+
+            link(timer);
+
+            // Reprogram the timer if this expiry is sooner than the scheduled one
+            // NOTE: Not needed during dispatch or with a pending wake-up (rescheduled by the IRQ handler)
+            if(m_in_dispatch == false && m_timer.is_pending_irq() == false)
+            {
+                if(m_timer.is_running() == false || is_before(timer.m_expiry, m_next_tick) == true)
+                {
+                    schedule(now);
+                }
+            }
+
+            __set_PRIMASK(primask);
+        }
+
+        // Stop a running timer (the scheduled wake-up is kept and ignored if the slot is left empty)
+        // NOTE: An expired timer not yet dispatched (stopped by an earlier handler of the same slot) isn't called
+        void stop(SoftTimer& timer)
+        {
+            const uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            if(timer.m_wheel == this)
+            {
+                unlink(timer);
+            }
+
+            timer.m_expired = false;
+
+            __set_PRIMASK(primask);
+        }
+
+        // Number of running timers
+        std::size_t get_running_count() const
+        {
+            return m_running_count;
+        }
+
+        // NOTE: Timer type is a multi-rate timer (single timer with multiple channels).
+        //       Only one IRQ and one priority available for all channels.
+        #ifdef __TARGET_TIMER_TYPE_IS_MRT__
+        static void set_mrt_irq_priority(const int32_t irq_priority)
+        {
+            Timer::set_mrt_irq_priority(irq_priority);
+        }
+        #else
+        void set_timer_irq_priority(const int32_t irq_priority)
+        {
+            m_timer.set_irq_priority(irq_priority);
+        }
+        #endif
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        static constexpr uint32_t SLOT_MASK { SLOT_COUNT - 1 };
+
+        static_assert(SLOT_COUNT == 32, "The slot occupancy mask is a 32-bit word.");
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Wrap-safe tick comparison (a happens before b)
+        static bool is_before(const uint32_t a, const uint32_t b)
+        {
+            return static_cast<int32_t>(a - b) < 0;
+        }
+
+        // Delay in ticks, rounded up (at least one tick)
+        // NOTE: 32-bit division (no overflow: delays are limited to INT32_MAX
+        //       microseconds and the tick to the maximum timer rate).
+        uint32_t convert_us_to_ticks(const uint32_t delay_us) const
+        {
+            const uint32_t ticks = (delay_us + m_tick_us - 1) / m_tick_us;
+
+            return (ticks > 0) ? ticks : 1;
+        }
+
+        // Current tick, returning the part of it already elapsed in 'fraction_us'
+        uint32_t get_current_tick(uint32_t& fraction_us) const
+        {
+            const uint32_t elapsed_us = static_cast<uint32_t>(UsTicker::now().count()) - m_base_time_us;
+
+            fraction_us = elapsed_us % m_tick_us;
+
+            return m_base_tick + elapsed_us / m_tick_us;
+        }
+
+        void link(SoftTimer& timer)
+        {
+            const uint32_t slot = timer.m_expiry & SLOT_MASK;
+
+            timer.m_prev = nullptr;
+            timer.m_next = m_slots[slot];
+
+            if(m_slots[slot] != nullptr)
+            {
+                m_slots[slot]->m_prev = &timer;
+            }
+
+            m_slots[slot] = &timer;
+            m_slot_mask  |= (1UL << slot);
+
+            m_running_count++;
+        }
+
+        void unlink(SoftTimer& timer)
+        {
+            const uint32_t slot = timer.m_expiry & SLOT_MASK;
+
+            if(timer.m_prev != nullptr)
+            {
+                timer.m_prev->m_next = timer.m_next;
+            }
+            else
+            {
+                m_slots[slot] = timer.m_next;
+            }
+
+            if(timer.m_next != nullptr)
+            {
+                timer.m_next->m_prev = timer.m_prev;
+            }
+
+            if(m_slots[slot] == nullptr)
+            {
+                m_slot_mask &= ~(1UL << slot);
+            }
+
+            timer.m_prev  = nullptr;
+            timer.m_next  = nullptr;
+            timer.m_wheel = nullptr;
+
+            m_running_count--;
+        }
+
+        // Move the time base to the supplied tick and program the timer to wake up
+        // at the next occupied slot after it
+        void schedule(const uint32_t now)
+        {
+            m_timer.stop();
+
+            // Keep the tick boundaries aligned to the time base
+            m_base_time_us += (now - m_base_tick) * m_tick_us;
+            m_base_tick     = now;
+
+            if(m_slot_mask == 0)
+            {
+                return;
+            }
+
+            // Rotate the occupancy mask so that bit 0 is the slot of the next tick
+            const uint32_t first    = (now + 1) & SLOT_MASK;
+            const uint32_t rotated  = (first == 0) ? m_slot_mask : ((m_slot_mask >> first) | (m_slot_mask << (SLOT_COUNT - first)));
+            uint32_t       distance = static_cast<uint32_t>(__builtin_ctz(rotated)) + 1;
+
+            // Wake up earlier (at an empty slot) if the timer can't reach the occupied one
+            const uint32_t max_distance = static_cast<uint32_t>(Timer::get_max_rate_us() / m_tick_us);
+
+            if(distance > max_distance)
+            {
+                distance = (max_distance > 0) ? max_distance : 1;
+            }
+
+            m_next_tick = now + distance;
+
+            // Discount the time already elapsed since the tick boundary (wake-up latency included)
+            const int64_t elapsed_us  = static_cast<uint32_t>(UsTicker::now().count()) - m_base_time_us;
+            const int64_t interval_us = static_cast<int64_t>(distance) * m_tick_us - elapsed_us;
+
+            m_timer.start(std::chrono::microseconds((interval_us > 0) ? interval_us : 1), Timer::Mode::SINGLE_SHOT);
+        }
+
+        // Wake-up handler: dispatch the expired timers of the current slot and schedule the next wake-up
+        int32_t timer_irq_handler()
+        {
+            int32_t yield = 0;  // Used in FreeRTOS
+
+            const uint32_t now  = m_next_tick;
+            const uint32_t slot = now & SLOT_MASK;
+
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            m_in_dispatch = true;
+
+            // Move the expired timers of this slot to the dispatch list (later rounds are kept)
+            SoftTimer*  expired = nullptr;
+            SoftTimer** tail    = &expired;
+
+            SoftTimer* timer = m_slots[slot];
+
+            while(timer != nullptr)
+            {
+                SoftTimer* const next = timer->m_next;
+
+                if(is_before(now, timer->m_expiry) == false)
+                {
+                    unlink(*timer);
+
+                    if(timer->m_period != 0)
+                    {
+                        // Keep the phase of free running timers
+                        timer->m_wheel   = this;
+                        timer->m_expiry += timer->m_period;
+
+                        link(*timer);
+                    }
+
+                    timer->m_next_expired = nullptr;
+                    timer->m_expired      = true;
+
+                    *tail = timer;
+                    tail  = &timer->m_next_expired;
+                }
+
+                timer = next;
+            }
+
+            __set_PRIMASK(primask);
+
+            // Call the expiry handlers of the timers not stopped (or restarted) in the meantime
+            // NOTE: Handlers may start or stop any timer (including their own)
+            while(expired != nullptr)
+            {
+                SoftTimer& current = *expired;
+
+                primask = __get_PRIMASK();
+                __disable_irq();
+
+                expired = current.m_next_expired;
+
+                const bool dispatch = current.m_expired;
+                current.m_expired = false;
+
+                __set_PRIMASK(primask);
+
+                if(dispatch == true)
+                {
+                    yield |= current.m_handler();
+                }
+            }
+
+            primask = __get_PRIMASK();
+            __disable_irq();
+
+            m_in_dispatch = false;
+
+            schedule(now);
+
+            __set_PRIMASK(primask);
+
+            return yield;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        Timer                              m_timer;                        // Wake-up timer
+        const uint32_t                     m_tick_us;                      // Tick period in microseconds
+
+        std::array<SoftTimer*, SLOT_COUNT> m_slots            {};          // Timer list of each slot
+        uint32_t                           m_slot_mask        { 0 };       // Slot occupancy mask
+        std::size_t                        m_running_count    { 0 };       // Number of running timers
+
+        uint32_t                           m_base_tick        { 0 };       // Tick of the last wake-up (or reprogramming)
+        uint32_t                           m_base_time_us     { 0 };       // Time base value at the base tick boundary
+        uint32_t                           m_next_tick        { 0 };       // Tick of the scheduled wake-up
+        bool                               m_in_dispatch      { false };   // Expiry handlers running
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_TIMER_WHEEL_HPP
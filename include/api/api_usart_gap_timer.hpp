@@ -0,0 +1,184 @@
+// ----------------------------------------------------------------------------
+// @file    api_usart_gap_timer.hpp
+// @brief   API USART line silence (frame gap) detector.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_API_USART_GAP_TIMER_HPP
+#define __XARMLIB_API_USART_GAP_TIMER_HPP
+
+#include "system/delegate"
+#include "hal/hal_timer.hpp"
+#include "hal/hal_usart.hpp"
+
+namespace xarmlib
+{
+
+
+
+
+// Detects a silent receive line on a USART: the owner re-starts the gap time
+// on every received character and a single-shot timer calls the gap handler
+// from its ISR when the gap time elapsed with the receiver idle (RX_IDLE set,
+// no START detected and no character waiting). While the line is not idle the
+// gap time is waited again.
+// NOTE: The gap handler is called with the USART receiver ready interrupt
+//       disabled (the receiver IRQ can't preempt it); the handler may enable
+//       it before returning.
+// NOTE: The timer uses a multi-rate timer channel, so the timer IRQ priority
+//       is shared with the other Timer instances.
+class UsartGapTimer
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC TYPE ALIASES
+        // --------------------------------------------------------------------
+
+        // Gap handler definition (called from the timer ISR). Returns the
+        // yield flag for FreeRTOS.
+        using GapHandlerType = int32_t();
+        using GapHandler     = Delegate<GapHandlerType>;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        UsartGapTimer(Usart& usart, const GapHandler& gap_handler) : m_usart { usart },
+                                                                      m_gap_handler { gap_handler }
+        {
+            assert(gap_handler != nullptr);
+
+            const auto timer_handler = Timer::IrqHandler::create<UsartGapTimer, &UsartGapTimer::timer_handler>(this);
+            m_timer.assign_irq_handler(timer_handler);
+            m_timer.enable_irq();
+        }
+
+        ~UsartGapTimer()
+        {
+            m_timer.stop();
+            m_timer.disable_irq();
+            m_timer.remove_irq_handler();
+        }
+
+        // Silent line time that calls the gap handler (stops the timer)
+        // NOTE: Call it with the receiver ready interrupt disabled.
+        void set_gap(const std::chrono::microseconds gap_us)
+        {
+            assert(gap_us.count() > 0);
+
+            // Load the interval once: the receiver IRQ handler only re-starts it
+            m_timer.start(gap_us, Timer::Mode::SINGLE_SHOT);
+            stop();
+
+            m_gap_us = gap_us;
+        }
+
+        std::chrono::microseconds get_gap() const
+        {
+            return m_gap_us;
+        }
+
+        // Re-start the gap time (called from the receiver IRQ handler on every character)
+        void restart()
+        {
+            m_timer.reload();
+        }
+
+        // Stop the gap time, discarding an expiry not handled yet
+        void stop()
+        {
+            m_timer.stop();
+            m_timer.clear_pending_irq();
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Status    = Usart::Status;
+        using Interrupt = Usart::Interrupt;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Check if a character is being received (or was received and not read yet)
+        bool is_rx_active() const
+        {
+            return m_usart.is_rx_ready() == true
+                || m_usart.is_rx_idle()  == false
+                || (m_usart.get_status() & Status::START) != 0;
+        }
+
+        int32_t timer_handler()
+        {
+            // Ignore an expiry overtaken by a receiver IRQ (timer already re-started)
+            if(m_timer.is_running() == true)
+            {
+                return 0;
+            }
+
+            m_usart.disable_interrupts(Interrupt::RX_READY);
+
+            int32_t yield = 0;
+
+            if(is_rx_active() == true)
+            {
+                // Line not idle: wait for another gap time
+                m_timer.reload();
+            }
+            else
+            {
+                yield = m_gap_handler();
+            }
+
+            m_usart.enable_interrupts(Interrupt::RX_READY);
+
+            return yield;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        Usart&                    m_usart;
+        GapHandler                m_gap_handler;
+
+        Timer                     m_timer;
+        std::chrono::microseconds m_gap_us { 0 };
+};
+
+
+
+
+} // namespace xarmlib
+
+#endif // __XARMLIB_API_USART_GAP_TIMER_HPP
@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------
+// @file    hal_crc_engine.hpp
+// @brief   CRC engine HAL interface class.
+// @date    9 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_CRC_ENGINE_HPP
+#define __XARMLIB_HAL_CRC_ENGINE_HPP
+
+#include "system/target"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+template <class TargetCrcEngine>
+class CrcEngine : private TargetCrcEngine
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Polynomial = typename TargetCrcEngine::Polynomial;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        using TargetCrcEngine::is_supported;
+        using TargetCrcEngine::get_polynomial;
+
+        using TargetCrcEngine::configure;
+        using TargetCrcEngine::write;
+        using TargetCrcEngine::read_sum;
+
+        // -------- OWNERSHIP -------------------------------------------------
+
+        using TargetCrcEngine::is_owner;
+        using TargetCrcEngine::set_owner;
+        using TargetCrcEngine::release;
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_crc_engine.hpp"
+
+namespace xarmlib
+{
+using CrcEngine = hal::CrcEngine<targets::lpc84x::CrcEngine>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using CrcEngine = hal::CrcEngine<targets::other_target::CrcEngine>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_CRC_ENGINE_HPP
@@ -0,0 +1,154 @@
+// ----------------------------------------------------------------------------
+// @file    hal_dma.hpp
+// @brief   DMA channel HAL interface class.
+// @date    3 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_DMA_HPP
+#define __XARMLIB_HAL_DMA_HPP
+
+#include "system/target"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+template <class TargetDmaChannel>
+class DmaChannel : private TargetDmaChannel
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Name      = typename TargetDmaChannel::Name;
+        using Request   = typename TargetDmaChannel::Request;
+        using Priority  = typename TargetDmaChannel::Priority;
+        using Width     = typename TargetDmaChannel::Width;
+        using Increment = typename TargetDmaChannel::Increment;
+        using Interrupt = typename TargetDmaChannel::Interrupt;
+
+        using Descriptor = typename TargetDmaChannel::Descriptor;
+        using Transfer   = typename TargetDmaChannel::Transfer;
+
+        using IrqFlags   = typename TargetDmaChannel::IrqFlags;
+        using IrqHandler = typename TargetDmaChannel::IrqHandler;
+
+        using TargetDmaChannel::MAX_TRANSFER_COUNT;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        DmaChannel(const Name     name,
+                   const Request  request,
+                   const Priority priority = Priority::MEDIUM) : TargetDmaChannel(name, request, priority)
+        {}
+
+        // -------- DESCRIPTORS -----------------------------------------------
+
+        using TargetDmaChannel::set_descriptor;
+
+        // -------- START / ABORT ---------------------------------------------
+
+        using TargetDmaChannel::start;
+        using TargetDmaChannel::abort;
+        using TargetDmaChannel::is_busy;
+        using TargetDmaChannel::is_active;
+        using TargetDmaChannel::get_remaining_count;
+
+        // Start a continuous transfer alternating between two descriptors
+        // NOTE: Interrupt A is raised when the ping transfer completes and
+        //       interrupt B when the pong transfer completes, so the user
+        //       IRQ handler knows which buffer is ready to be processed.
+        void start_ping_pong(Descriptor& ping, Transfer ping_transfer, Descriptor& pong, Transfer pong_transfer)
+        {
+            ping_transfer.interrupt = Interrupt::A;
+            pong_transfer.interrupt = Interrupt::B;
+
+            TargetDmaChannel::set_descriptor(ping, ping_transfer, &pong);
+            TargetDmaChannel::set_descriptor(pong, pong_transfer, &ping);
+
+            TargetDmaChannel::start(ping);
+        }
+
+        // -------- PRIORITY --------------------------------------------------
+
+        using TargetDmaChannel::set_priority;
+
+        // -------- INTERRUPTS ------------------------------------------------
+
+        using TargetDmaChannel::enable_irq;
+        using TargetDmaChannel::disable_irq;
+        using TargetDmaChannel::is_enabled_irq;
+
+        // NOTE: Only one IRQ and one priority available for all channels.
+        using TargetDmaChannel::set_dma_irq_priority;
+
+        using TargetDmaChannel::assign_irq_handler;
+        using TargetDmaChannel::remove_irq_handler;
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_dma.hpp"
+
+namespace xarmlib
+{
+using DmaChannel = hal::DmaChannel<targets::lpc84x::DmaChannel>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using DmaChannel = hal::DmaChannel<targets::other_target::DmaChannel>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_DMA_HPP
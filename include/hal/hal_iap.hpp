@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+// @file    hal_iap.hpp
+// @brief   IAP HAL interface class.
+// @date    10 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_IAP_HPP
+#define __XARMLIB_HAL_IAP_HPP
+
+#include "system/target"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+template <class TargetIap>
+class Iap : private TargetIap
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using StatusCode = typename TargetIap::StatusCode;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        using TargetIap::get_page_size;
+        using TargetIap::get_sector_size;
+        using TargetIap::get_sector_count;
+
+        // -------- FLASH -----------------------------------------------------
+
+        using TargetIap::write_flash_page;
+        using TargetIap::write_flash;
+        using TargetIap::program_flash;
+        using TargetIap::erase_flash_sectors;
+        using TargetIap::read_flash;
+
+        // -------- FAIM ------------------------------------------------------
+
+        using TargetIap::read_faim_word;
+        using TargetIap::write_faim_word;
+
+        // -------- RAM INTERRUPTS --------------------------------------------
+
+        using TargetIap::enable_ram_irq;
+        using TargetIap::disable_ram_irq;
+        using TargetIap::is_enabled_ram_irq;
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_iap.hpp"
+
+namespace xarmlib
+{
+using Iap = hal::Iap<targets::lpc84x::Iap>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using Iap = hal::Iap<targets::other_target::Iap>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_IAP_HPP
@@ -0,0 +1,141 @@
+// ----------------------------------------------------------------------------
+// @file    hal_pin_interrupt.hpp
+// @brief   Pin interrupt HAL interface class.
+// @date    7 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_PIN_INTERRUPT_HPP
+#define __XARMLIB_HAL_PIN_INTERRUPT_HPP
+
+#include "system/target"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+template <class TargetPinInterrupt>
+class PinInterrupt : private TargetPinInterrupt
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using Channel     = typename TargetPinInterrupt::Channel;
+        using Mode        = typename TargetPinInterrupt::Mode;
+        using SliceConfig = typename TargetPinInterrupt::SliceConfig;
+        using IrqHandler  = typename TargetPinInterrupt::IrqHandler;
+
+        using TargetPinInterrupt::SLICE_COUNT;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- CONSTRUCTORS ----------------------------------------------
+
+        PinInterrupt(const xarmlib::Pin::Name pin_name,
+                     const Mode               mode) : TargetPinInterrupt(pin_name, mode)
+        {}
+
+        PinInterrupt(const Channel            channel,
+                     const xarmlib::Pin::Name pin_name,
+                     const Mode               mode) : TargetPinInterrupt(channel, pin_name, mode)
+        {}
+
+        // -------- CONFIGURATION ---------------------------------------------
+
+        using TargetPinInterrupt::get_channel;
+        using TargetPinInterrupt::set_mode;
+
+        // -------- EDGE DETECTION --------------------------------------------
+
+        using TargetPinInterrupt::is_rising_edge_detected;
+        using TargetPinInterrupt::is_falling_edge_detected;
+
+        // -------- INTERRUPTS ------------------------------------------------
+
+        using TargetPinInterrupt::enable_irq;
+        using TargetPinInterrupt::disable_irq;
+
+        using TargetPinInterrupt::is_enabled_irq;
+        using TargetPinInterrupt::is_pending_irq;
+        using TargetPinInterrupt::clear_pending_irq;
+
+        using TargetPinInterrupt::set_irq_priority;
+
+        using TargetPinInterrupt::assign_irq_handler;
+        using TargetPinInterrupt::remove_irq_handler;
+
+        // -------- PATTERN MATCH ENGINE --------------------------------------
+
+        using TargetPinInterrupt::set_pattern_slice;
+        using TargetPinInterrupt::enable_pattern_match;
+        using TargetPinInterrupt::disable_pattern_match;
+        using TargetPinInterrupt::is_enabled_pattern_match;
+        using TargetPinInterrupt::get_pattern_match_state;
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_pin_interrupt.hpp"
+
+namespace xarmlib
+{
+using PinInterrupt = hal::PinInterrupt<targets::lpc84x::PinInterrupt>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using PinInterrupt = hal::PinInterrupt<targets::other_target::PinInterrupt>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_PIN_INTERRUPT_HPP
@@ -67,6 +67,10 @@ class Port : private TargetPort
 
         using TargetPort::write;
         using TargetPort::write_masked;
+
+        using TargetPort::set;
+        using TargetPort::clear;
+        using TargetPort::toggle;
 };
 
 
@@ -70,10 +70,31 @@ class SpiMaster : private TargetSpi
                   const SpiMode            spi_mode      = SpiMode::MODE3,
                   const DataBits           data_bits     = DataBits::BITS_8,
                   const DataOrder          data_order    = DataOrder::MSB_FIRST,
+                  const LoopbackMode       loopback_mode = LoopbackMode::DISABLED) : SpiMaster(master_mosi,
+                                                                                               master_miso,
+                                                                                               master_sck,
+                                                                                               xarmlib::Pin::Name::NC,
+                                                                                               max_frequency,
+                                                                                               spi_mode,
+                                                                                               data_bits,
+                                                                                               data_order,
+                                                                                               loopback_mode)
+        {}
+
+        // NOTE: Slave select (active low) is driven by hardware and deasserted
+        //       at the end of each buffer transfer (end of transfer control).
+        SpiMaster(const xarmlib::Pin::Name master_mosi,
+                  const xarmlib::Pin::Name master_miso,
+                  const xarmlib::Pin::Name master_sck,
+                  const xarmlib::Pin::Name master_sel,
+                  const int32_t            max_frequency,
+                  const SpiMode            spi_mode      = SpiMode::MODE3,
+                  const DataBits           data_bits     = DataBits::BITS_8,
+                  const DataOrder          data_order    = DataOrder::MSB_FIRST,
                   const LoopbackMode       loopback_mode = LoopbackMode::DISABLED)
        {
             // Initialize peripheral structure and pins
-            TargetSpi::initialize(master_mosi, master_miso, master_sck, xarmlib::Pin::Name::NC);
+            TargetSpi::initialize(master_mosi, master_miso, master_sck, master_sel);
             // Configure data format and operating modes
             TargetSpi::set_configuration(TargetSpi::MasterMode::MASTER, spi_mode, data_bits, data_order, TargetSpi::SselPolarity::LOW, loopback_mode);
             // Set supplied maximum frequency
@@ -105,12 +126,29 @@ class SpiMaster : private TargetSpi
 
         // Transfer a buffer (simultaneous write and read)
         // NOTE: The read values will be placed on the same buffer, destroying the original buffer.
-        void transfer(gsl::span<uint8_t> buffer)
+        void transfer(gsl::span<uint8_t> buffer, const bool end_of_transfer = true)
         {
-            for(auto& elem : buffer)
-            {
-                elem = transfer(elem);
-            }
+            transfer_burst(buffer.data(), buffer.data(), buffer.size(), end_of_transfer);
+        }
+
+        // Transfer a buffer while receiving into another one of the same size (simultaneous write and read)
+        void transfer(const gsl::span<const uint8_t> tx_buffer, gsl::span<uint8_t> rx_buffer, const bool end_of_transfer = true)
+        {
+            assert(tx_buffer.size() == rx_buffer.size());
+
+            transfer_burst(tx_buffer.data(), rx_buffer.data(), rx_buffer.size(), end_of_transfer);
+        }
+
+        // Write a buffer (received data is ignored)
+        void write(const gsl::span<const uint8_t> buffer, const bool end_of_transfer = true)
+        {
+            transfer_burst(buffer.data(), nullptr, buffer.size(), end_of_transfer);
+        }
+
+        // Read a buffer (dummy 0xFF frames are written to generate the clock)
+        void read(gsl::span<uint8_t> buffer, const bool end_of_transfer = true)
+        {
+            transfer_burst(nullptr, buffer.data(), buffer.size(), end_of_transfer);
         }
 
         // -------- ENABLE / DISABLE ------------------------------------------
@@ -140,12 +178,81 @@ class SpiMaster : private TargetSpi
             #endif
         }
 
+    protected:
+
+        // --------------------------------------------------------------------
+        // PROTECTED MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- DMA -------------------------------------------------------
+
+        // DMA request channels, data registers and transfer control (used by SpiMasterDma)
+        using TargetSpi::get_dma_rx_channel;
+        using TargetSpi::get_dma_tx_channel;
+        using TargetSpi::get_rx_data_address;
+        using TargetSpi::get_tx_data_address;
+        using TargetSpi::get_tx_data_control_address;
+        using TargetSpi::get_data_control_end_of_transfer;
+        using TargetSpi::clear_end_of_transfer;
+        using TargetSpi::set_rx_ignore;
+        using TargetSpi::is_writable;
+
     private:
 
         // --------------------------------------------------------------------
         // PRIVATE MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
+        // -------- BURST TRANSFER --------------------------------------------
+
+        // Pipelined buffer transfer that keeps TXDAT loaded while draining RXDAT
+        // NOTE: A null transmit buffer writes dummy 0xFF frames. A null receive buffer
+        //       sets the receive ignore control so RXDAT never has to be read.
+        //       The last frame is written with the end of transfer control set
+        //       if requested, to deassert the slave select after it.
+        void transfer_burst(const uint8_t* tx_buffer, uint8_t* rx_buffer, const std::ptrdiff_t count, const bool end_of_transfer)
+        {
+            const bool rx_ignore = (rx_buffer == nullptr);
+
+            std::ptrdiff_t tx_count = 0;
+            std::ptrdiff_t rx_count = (rx_ignore == true) ? count : 0;
+
+            TargetSpi::set_rx_ignore(rx_ignore);
+
+            while(tx_count < count || rx_count < count)
+            {
+                // Keep at most two frames in flight (transmit holding and shift registers)
+                if(tx_count < count && (tx_count - rx_count) < 2 && TargetSpi::is_writable() == true)
+                {
+                    const uint32_t value = (tx_buffer != nullptr) ? tx_buffer[tx_count] : 0xFF;
+
+                    if(tx_count == count - 1 && end_of_transfer == true)
+                    {
+                        TargetSpi::write_data_end_of_transfer(value);
+                    }
+                    else
+                    {
+                        TargetSpi::write_data(value);
+                    }
+
+                    tx_count++;
+                }
+
+                if(rx_count < count && TargetSpi::is_readable() == true)
+                {
+                    rx_buffer[rx_count] = static_cast<uint8_t>(TargetSpi::read_data());
+
+                    rx_count++;
+                }
+            }
+
+            // Wait for the last frame to leave the transmit holding register before restoring the controls
+            while(TargetSpi::is_writable() == false);
+
+            TargetSpi::clear_end_of_transfer();
+            TargetSpi::set_rx_ignore(false);
+        }
+
         // -------- READ / WRITE ----------------------------------------------
 
         // Read a frame as soon as possible
@@ -263,7 +370,6 @@ class SpiSlave : private TargetSpi
 
         // -------- GET STATUS FLAGS ------------------------------------------
 
-        using TargetSpi::is_writable;
         using TargetSpi::is_readable;
         using TargetSpi::is_rx_overrun;
         using TargetSpi::is_tx_underrun;
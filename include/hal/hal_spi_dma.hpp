@@ -0,0 +1,306 @@
+// ----------------------------------------------------------------------------
+// @file    hal_spi_dma.hpp
+// @brief   SPI master HAL interface class with DMA transfers.
+// @date    3 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_SPI_DMA_HPP
+#define __XARMLIB_HAL_SPI_DMA_HPP
+
+#include "system/cassert"
+#include "system/gsl"
+#include "system/target"
+#include "hal/hal_dma.hpp"
+#include "hal/hal_spi.hpp"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+// SPI master with asynchronous reads / writes through its DMA request channels
+// NOTE: Asynchronous transfers are limited to 8 bit frames. The two DMA channels
+//       are claimed by the constructor and kept for the lifetime of the object
+//       (SpiMaster objects don't use any DMA resource). The last frame of each
+//       buffer is written by a linked descriptor through TXDATCTL with the end
+//       of transfer control set.
+template <class TargetSpi>
+class SpiMasterDma : public SpiMaster<TargetSpi>
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using SpiMode      = typename SpiMaster<TargetSpi>::SpiMode;
+        using DataBits     = typename SpiMaster<TargetSpi>::DataBits;
+        using DataOrder    = typename SpiMaster<TargetSpi>::DataOrder;
+        using LoopbackMode = typename SpiMaster<TargetSpi>::LoopbackMode;
+
+        using DmaIrqFlags = typename xarmlib::DmaChannel::IrqFlags;
+        using DmaHandler  = typename xarmlib::DmaChannel::IrqHandler;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        SpiMasterDma(const xarmlib::Pin::Name master_mosi,
+                     const xarmlib::Pin::Name master_miso,
+                     const xarmlib::Pin::Name master_sck,
+                     const int32_t            max_frequency,
+                     const SpiMode            spi_mode      = SpiMode::MODE3,
+                     const DataBits           data_bits     = DataBits::BITS_8,
+                     const DataOrder          data_order    = DataOrder::MSB_FIRST,
+                     const LoopbackMode       loopback_mode = LoopbackMode::DISABLED) : SpiMasterDma(master_mosi,
+                                                                                                     master_miso,
+                                                                                                     master_sck,
+                                                                                                     xarmlib::Pin::Name::NC,
+                                                                                                     max_frequency,
+                                                                                                     spi_mode,
+                                                                                                     data_bits,
+                                                                                                     data_order,
+                                                                                                     loopback_mode)
+        {}
+
+        // NOTE: Slave select (active low) is driven by hardware and deasserted
+        //       after the last frame of each asynchronous buffer transfer.
+        SpiMasterDma(const xarmlib::Pin::Name master_mosi,
+                     const xarmlib::Pin::Name master_miso,
+                     const xarmlib::Pin::Name master_sck,
+                     const xarmlib::Pin::Name master_sel,
+                     const int32_t            max_frequency,
+                     const SpiMode            spi_mode      = SpiMode::MODE3,
+                     const DataBits           data_bits     = DataBits::BITS_8,
+                     const DataOrder          data_order    = DataOrder::MSB_FIRST,
+                     const LoopbackMode       loopback_mode = LoopbackMode::DISABLED) : SpiMaster<TargetSpi>(master_mosi,
+                                                                                                             master_miso,
+                                                                                                             master_sck,
+                                                                                                             master_sel,
+                                                                                                             max_frequency,
+                                                                                                             spi_mode,
+                                                                                                             data_bits,
+                                                                                                             data_order,
+                                                                                                             loopback_mode),
+                                                                                       // Receiver has higher priority to keep up with the transmitter
+                                                                                       m_dma_rx(get_dma_channel_name(this->get_dma_rx_channel()), DmaChannel::Request::PERIPHERAL, DmaChannel::Priority::HIGH),
+                                                                                       m_dma_tx(get_dma_channel_name(this->get_dma_tx_channel()), DmaChannel::Request::PERIPHERAL, DmaChannel::Priority::MEDIUM)
+        {
+            m_dma_tx.assign_irq_handler(DmaHandler::template create<SpiMasterDma, &SpiMasterDma::dma_tx_irq_handler>(this));
+
+            m_dma_rx.enable_irq();
+            m_dma_tx.enable_irq();
+        }
+
+        // -------- ASYNCHRONOUS READ / WRITE (DMA) ---------------------------
+
+        // Start reading a buffer through DMA (dummy 0xFF frames are written to generate
+        // the clock), returning 'false' if a previous transfer is still in progress.
+        // NOTE: The handler is called from the DMA ISR when the buffer is full.
+        //       The buffer must remain valid until then.
+        bool read_async(const gsl::span<uint8_t> buffer, const DmaHandler& handler)
+        {
+            assert(buffer.size() >= 1 && buffer.size() <= DmaChannel::MAX_TRANSFER_COUNT);
+
+            if(is_async_busy() == true)
+            {
+                return false;
+            }
+
+            DmaTransfer rx_transfer { this->get_rx_data_address(), buffer.data(), static_cast<int32_t>(buffer.size()) };
+            rx_transfer.source_increment = DmaChannel::Increment::NONE;
+
+            m_dma_write_handler = nullptr;
+
+            m_dma_rx.assign_irq_handler(handler);
+            m_dma_rx.start(rx_transfer);
+
+            start_tx(&m_dma_dummy, DmaChannel::Increment::NONE, static_cast<int32_t>(buffer.size()));
+
+            return true;
+        }
+
+        // Start writing a buffer through DMA (received data is ignored),
+        // returning 'false' if a previous transfer is still in progress.
+        // NOTE: The handler is called from the DMA ISR when the last frame is loaded
+        //       into the transmitter. The buffer must remain valid until then.
+        bool write_async(const gsl::span<const uint8_t> buffer, const DmaHandler& handler)
+        {
+            assert(buffer.size() >= 1 && buffer.size() <= DmaChannel::MAX_TRANSFER_COUNT);
+
+            if(is_async_busy() == true)
+            {
+                return false;
+            }
+
+            m_dma_write_handler = handler;
+
+            this->set_rx_ignore(true);
+
+            start_tx(buffer.data(), DmaChannel::Increment::X1, static_cast<int32_t>(buffer.size()));
+
+            return true;
+        }
+
+        bool is_async_busy() const
+        {
+            return m_dma_rx.is_active() == true || m_dma_tx.is_active() == true;
+        }
+
+        void abort_async()
+        {
+            m_dma_tx.abort();
+            m_dma_rx.abort();
+
+            this->clear_end_of_transfer();
+            this->set_rx_ignore(false);
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DmaChannel    = xarmlib::DmaChannel;
+        using DmaDescriptor = typename DmaChannel::Descriptor;
+        using DmaTransfer   = typename DmaChannel::Transfer;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static constexpr typename DmaChannel::Name get_dma_channel_name(const std::size_t channel_index)
+        {
+            return static_cast<typename DmaChannel::Name>(channel_index);
+        }
+
+        // Start the transmitter channel: the first count - 1 frames go to TXDAT and the last
+        // one is written to TXDATCTL together with the end of transfer control by a linked
+        // descriptor (the hardware deasserts slave select after it is shifted out)
+        void start_tx(const uint8_t* source, const typename DmaChannel::Increment source_increment, const int32_t count)
+        {
+            const uint8_t last_frame = (source_increment == DmaChannel::Increment::NONE) ? source[0] : source[count - 1];
+
+            // NOTE: The control word captures the receive ignore state of the transfer
+            m_eot_frame = this->get_data_control_end_of_transfer(last_frame);
+
+            DmaTransfer eot_transfer { &m_eot_frame, this->get_tx_data_control_address(), 1 };
+            eot_transfer.width                 = DmaChannel::Width::BITS_32;
+            eot_transfer.source_increment      = DmaChannel::Increment::NONE;
+            eot_transfer.destination_increment = DmaChannel::Increment::NONE;
+
+            DmaChannel::set_descriptor(m_eot_descriptor, eot_transfer);
+
+            if(count == 1)
+            {
+                m_dma_tx.start(m_eot_descriptor);
+                return;
+            }
+
+            DmaTransfer tx_transfer { source, this->get_tx_data_address(), count - 1 };
+            tx_transfer.source_increment      = source_increment;
+            tx_transfer.destination_increment = DmaChannel::Increment::NONE;
+            tx_transfer.interrupt             = DmaChannel::Interrupt::NONE;
+
+            DmaDescriptor tx_descriptor;
+
+            DmaChannel::set_descriptor(tx_descriptor, tx_transfer, &m_eot_descriptor);
+            m_dma_tx.start(tx_descriptor);
+        }
+
+        // Transmitter DMA channel IRQ handler (last frame loaded into TXDATCTL)
+        int32_t dma_tx_irq_handler(const DmaIrqFlags& irq_flags)
+        {
+            // Wait for the last frame to leave TXDAT before restoring the control bits
+            // for the next transfers (at most one frame time)
+            while(this->is_writable() == false);
+
+            this->clear_end_of_transfer();
+            this->set_rx_ignore(false);
+
+            if(m_dma_write_handler == nullptr)
+            {
+                // Dummy frames of an asynchronous read (completed by the receiver channel)
+                return 0;
+            }
+
+            const DmaHandler handler = m_dma_write_handler;
+            m_dma_write_handler = nullptr;
+
+            return handler(irq_flags);
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        DmaChannel    m_dma_rx;                 // Receiver DMA channel
+        DmaChannel    m_dma_tx;                 // Transmitter DMA channel
+        DmaDescriptor m_eot_descriptor;         // Linked descriptor of the last frame (16 byte aligned)
+        uint32_t      m_eot_frame { 0 };        // TXDATCTL word of the last frame (data + end of transfer)
+        DmaHandler    m_dma_write_handler;      // User handler of the ongoing asynchronous write
+        const uint8_t m_dma_dummy { 0xFF };     // Frame written during asynchronous reads
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_spi.hpp"
+
+namespace xarmlib
+{
+using SpiMasterDma = hal::SpiMasterDma<targets::lpc84x::Spi>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using SpiMasterDma = hal::SpiMasterDma<targets::other_target::Spi>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_SPI_DMA_HPP
@@ -65,6 +65,11 @@ class Timer : private TargetTimer
         using TargetTimer::stop;
         using TargetTimer::is_running;
 
+        // -------- RATE LIMITS -----------------------------------------------
+
+        using TargetTimer::get_min_rate_us;
+        using TargetTimer::get_max_rate_us;
+
         // -------- INTERRUPTS ------------------------------------------------
 
         using TargetTimer::enable_irq;
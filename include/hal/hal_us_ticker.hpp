@@ -53,6 +53,7 @@ class UsTicker : private TargetUsTicker
         // --------------------------------------------------------------------
 
         // Read the current ticker value
+        // NOTE: 64-bit monotonic time base (no wrap around in practice).
         using TargetUsTicker::now;
 
         // Wait for the supplied duration time
@@ -60,16 +61,14 @@ class UsTicker : private TargetUsTicker
         {
             const auto start = now();
 
-            while(static_cast<uint32_t>((now() - start).count()) <
-                  static_cast<uint32_t>(duration.count()))
+            while((now() - start) < duration)
             {}
         }
 
         static bool is_timeout(const std::chrono::microseconds start,
                                const std::chrono::microseconds duration)
         {
-            return static_cast<uint32_t>((now() - start).count()) >=
-                   static_cast<uint32_t>(duration.count());
+            return (now() - start) >= duration;
         }
 };
 
@@ -60,6 +60,12 @@ class Usart : private TargetUsart
         using StopBits = typename TargetUsart::StopBits;
         using Parity   = typename TargetUsart::Parity;
 
+        using ClockSource      = typename TargetUsart::ClockSource;
+        using BaudrateSettings = typename TargetUsart::BaudrateSettings;
+        using Config           = typename TargetUsart::Config;
+
+        using DriverEnablePolarity = typename TargetUsart::DriverEnablePolarity;
+
         using Status        = typename TargetUsart::Status;
         using StatusBitmask = typename TargetUsart::StatusBitmask;
 
@@ -75,14 +81,16 @@ class Usart : private TargetUsart
         Usart(const xarmlib::Pin::Name txd,
               const xarmlib::Pin::Name rxd,
               const int32_t            baudrate,
-              const DataBits           data_bits = DataBits::BITS_8,
-              const StopBits           stop_bits = StopBits::BITS_1,
-              const Parity             parity    = Parity::NONE) : TargetUsart(txd,
-                                                                               rxd,
-                                                                               baudrate,
-                                                                               data_bits,
-                                                                               stop_bits,
-                                                                               parity)
+              const DataBits           data_bits    = DataBits::BITS_8,
+              const StopBits           stop_bits    = StopBits::BITS_1,
+              const Parity             parity       = Parity::NONE,
+              const ClockSource        clock_source = ClockSource::FRG0) : TargetUsart(txd,
+                                                                                       rxd,
+                                                                                       baudrate,
+                                                                                       data_bits,
+                                                                                       stop_bits,
+                                                                                       parity,
+                                                                                       clock_source)
         {}
 
         // -------- FORMAT / BAUDRATE -----------------------------------------
@@ -92,6 +100,13 @@ class Usart : private TargetUsart
         using TargetUsart::set_stop_bits;
         using TargetUsart::set_parity;
         using TargetUsart::set_baudrate;
+        using TargetUsart::get_baudrate_settings;
+        using TargetUsart::get_clock_source;
+        using TargetUsart::solve_baudrate;
+
+        using TargetUsart::apply;
+        using TargetUsart::get_config;
+        using TargetUsart::make_config;
 
         // -------- ENABLE / DISABLE ------------------------------------------
 
@@ -206,6 +221,40 @@ class Usart : private TargetUsart
             return count;
         }
 
+        // -------- MULTIDROP / RS-485 ----------------------------------------
+
+        using TargetUsart::enable_address_match;
+        using TargetUsart::disable_address_match;
+        using TargetUsart::get_match_address;
+
+        using TargetUsart::enable_address_detect;
+        using TargetUsart::disable_address_detect;
+        using TargetUsart::is_address_detect_enabled;
+
+        using TargetUsart::enable_driver_enable;
+        using TargetUsart::disable_driver_enable;
+
+        // Write an address character (9th bit set) as soon as possible (with infinite timeout)
+        // NOTE: Requires 9 data bits.
+        void write_address(const uint8_t address)
+        {
+            write(0x100 | address);
+        }
+
+    protected:
+
+        // --------------------------------------------------------------------
+        // PROTECTED MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- DMA -------------------------------------------------------
+
+        // DMA request channels and data registers (used by UsartDma)
+        using TargetUsart::get_dma_rx_channel;
+        using TargetUsart::get_dma_tx_channel;
+        using TargetUsart::get_rx_data_address;
+        using TargetUsart::get_tx_data_address;
+
     private:
 
         // --------------------------------------------------------------------
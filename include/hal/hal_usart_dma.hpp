@@ -0,0 +1,202 @@
+// ----------------------------------------------------------------------------
+// @file    hal_usart_dma.hpp
+// @brief   USART HAL interface class with DMA transfers.
+// @date    3 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_USART_DMA_HPP
+#define __XARMLIB_HAL_USART_DMA_HPP
+
+#include "system/cassert"
+#include "system/gsl"
+#include "system/target"
+#include "hal/hal_dma.hpp"
+#include "hal/hal_usart.hpp"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+// USART with asynchronous reads / writes through its DMA request channels
+// NOTE: The two DMA channels are claimed by the constructor and kept for the
+//       lifetime of the object (Usart objects don't use any DMA resource).
+template <class TargetUsart>
+class UsartDma : public Usart<TargetUsart>
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DataBits    = typename Usart<TargetUsart>::DataBits;
+        using StopBits    = typename Usart<TargetUsart>::StopBits;
+        using Parity      = typename Usart<TargetUsart>::Parity;
+        using ClockSource = typename Usart<TargetUsart>::ClockSource;
+
+        using DmaIrqFlags = typename xarmlib::DmaChannel::IrqFlags;
+        using DmaHandler  = typename xarmlib::DmaChannel::IrqHandler;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        UsartDma(const xarmlib::Pin::Name txd,
+                 const xarmlib::Pin::Name rxd,
+                 const int32_t            baudrate,
+                 const DataBits           data_bits    = DataBits::BITS_8,
+                 const StopBits           stop_bits    = StopBits::BITS_1,
+                 const Parity             parity       = Parity::NONE,
+                 const ClockSource        clock_source = ClockSource::FRG0) : Usart<TargetUsart>(txd,
+                                                                                                 rxd,
+                                                                                                 baudrate,
+                                                                                                 data_bits,
+                                                                                                 stop_bits,
+                                                                                                 parity,
+                                                                                                 clock_source),
+                                                                              m_dma_rx(get_dma_channel_name(this->get_dma_rx_channel()), DmaChannel::Request::PERIPHERAL),
+                                                                              m_dma_tx(get_dma_channel_name(this->get_dma_tx_channel()), DmaChannel::Request::PERIPHERAL)
+        {
+            m_dma_rx.enable_irq();
+            m_dma_tx.enable_irq();
+        }
+
+        // -------- ASYNCHRONOUS READ / WRITE (DMA) ---------------------------
+
+        // Start reading a buffer through DMA, returning 'false' if a previous read is still in progress.
+        // NOTE: The handler is called from the DMA ISR when the buffer is full. The
+        //       buffer must remain valid until then.
+        bool read_async(const gsl::span<uint8_t> buffer, const DmaHandler& handler)
+        {
+            assert(buffer.size() >= 1 && buffer.size() <= DmaChannel::MAX_TRANSFER_COUNT);
+
+            DmaTransfer transfer { this->get_rx_data_address(), buffer.data(), static_cast<int32_t>(buffer.size()) };
+
+            transfer.source_increment = DmaChannel::Increment::NONE;
+
+            return start_dma(m_dma_rx, transfer, handler);
+        }
+
+        // Start writing a buffer through DMA, returning 'false' if a previous write is still in progress.
+        // NOTE: The handler is called from the DMA ISR when the last byte is loaded
+        //       into the transmitter (use is_tx_idle() to know when it was shifted out).
+        //       The buffer must remain valid until then.
+        bool write_async(const gsl::span<const uint8_t> buffer, const DmaHandler& handler)
+        {
+            assert(buffer.size() >= 1 && buffer.size() <= DmaChannel::MAX_TRANSFER_COUNT);
+
+            DmaTransfer transfer { buffer.data(), this->get_tx_data_address(), static_cast<int32_t>(buffer.size()) };
+
+            transfer.destination_increment = DmaChannel::Increment::NONE;
+
+            return start_dma(m_dma_tx, transfer, handler);
+        }
+
+        bool is_read_async_busy () const { return m_dma_rx.is_active(); }
+        bool is_write_async_busy() const { return m_dma_tx.is_active(); }
+
+        void abort_read_async () { m_dma_rx.abort(); }
+        void abort_write_async() { m_dma_tx.abort(); }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using DmaChannel  = xarmlib::DmaChannel;
+        using DmaTransfer = typename DmaChannel::Transfer;
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static constexpr typename DmaChannel::Name get_dma_channel_name(const std::size_t channel_index)
+        {
+            return static_cast<typename DmaChannel::Name>(channel_index);
+        }
+
+        // Start the supplied transfer if the channel is free
+        static bool start_dma(DmaChannel& dma_channel, const DmaTransfer& transfer, const DmaHandler& handler)
+        {
+            if(dma_channel.is_active() == true)
+            {
+                return false;
+            }
+
+            dma_channel.assign_irq_handler(handler);
+            dma_channel.start(transfer);
+
+            return true;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        DmaChannel m_dma_rx;    // Receiver DMA channel
+        DmaChannel m_dma_tx;    // Transmitter DMA channel
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_usart.hpp"
+
+namespace xarmlib
+{
+using UsartDma = hal::UsartDma<targets::lpc84x::Usart>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using UsartDma = hal::UsartDma<targets::other_target::Usart>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_USART_DMA_HPP
@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+// @file    hal_vector_table.hpp
+// @brief   Vector table HAL interface class.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_HAL_VECTOR_TABLE_HPP
+#define __XARMLIB_HAL_VECTOR_TABLE_HPP
+
+#include "system/target"
+
+namespace xarmlib
+{
+namespace hal
+{
+
+
+
+
+template <class TargetVectorTable>
+class VectorTable : private TargetVectorTable
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        using IrqHandlerPtr  = typename TargetVectorTable::IrqHandlerPtr;
+        using IrqHandlerType = typename TargetVectorTable::IrqHandlerType;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- RELOCATION ------------------------------------------------
+
+        using TargetVectorTable::relocate_to_ram;
+        using TargetVectorTable::relocate_to_flash;
+        using TargetVectorTable::is_in_ram;
+
+        // -------- HANDLER INSTALLATION --------------------------------------
+
+        // NOTE: Meant for hard real-time interrupts: the installed handler
+        //       replaces the library IRQ handler of the interrupt (and every
+        //       delegate assigned to the peripherals that share it).
+        using TargetVectorTable::set_handler;
+        using TargetVectorTable::restore_handler;
+        using TargetVectorTable::get_handler;
+};
+
+
+
+
+} // namespace hal
+} // namespace xarmlib
+
+
+
+
+#if defined __LPC84X__
+
+#include "targets/LPC84x/lpc84x_vector_table.hpp"
+
+namespace xarmlib
+{
+using VectorTable = hal::VectorTable<targets::lpc84x::VectorTable>;
+}
+
+#elif defined __OHER_TARGET__
+
+// Other target include files
+
+namespace xarmlib
+{
+using VectorTable = hal::VectorTable<targets::other_target::VectorTable>;
+}
+
+#endif
+
+
+
+
+#endif // __XARMLIB_HAL_VECTOR_TABLE_HPP
@@ -0,0 +1,341 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_host_core.hpp
+// @brief   Host simulation replacement of the Cortex-M0+ core peripherals header.
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_HOST_CORE_HPP
+#define __XARMLIB_TARGETS_LPC84X_HOST_CORE_HPP
+
+// NOTE: This file is only included by 'lpc84x_cmsis.hpp' (in place of the
+//       CMSIS 'core_cm0plus.h' file) when XARMLIB_HOST_SIMULATION is defined.
+//       It is included inside the CMSIS extern "C" block, so the C++ only
+//       parts are explicitly declared with C++ linkage.
+
+
+
+
+// ----------------------------------------------------------------------------
+// IO definitions (access restrictions to peripheral registers)
+// ----------------------------------------------------------------------------
+#define __I     volatile const      // Read only
+#define __O     volatile            // Write only
+#define __IO    volatile            // Read / write
+
+#define __IM    volatile const      // Read only structure member
+#define __OM    volatile            // Write only structure member
+#define __IOM   volatile            // Read / write structure member
+
+
+
+
+// ----------------------------------------------------------------------------
+// Simulator hooks (defined in 'lpc84x_host_simulator.cpp')
+// ----------------------------------------------------------------------------
+
+// Register file accesses (each access consumes bus cycles of the virtual clock)
+uint32_t xarmlib_host_read_register (const volatile void* address);
+void     xarmlib_host_write_register(volatile void* address, uint32_t value);
+void     xarmlib_host_write_register_byte(volatile void* address, uint8_t value);
+
+// Core state and execution
+uint32_t xarmlib_host_get_primask(void);
+void     xarmlib_host_set_primask(uint32_t primask);
+void     xarmlib_host_consume_cycles(uint32_t cycles);
+void     xarmlib_host_wait_for_interrupt(void);
+void     xarmlib_host_system_reset(void) __attribute__ ((noreturn));
+
+// Simulated address spaces
+extern uint32_t xarmlib_host_scs_memory[];      // System Control Space (SysTick, NVIC, SCB)
+extern uint32_t xarmlib_host_apb_memory[];      // APB peripherals
+extern uint32_t xarmlib_host_ahb_memory[];      // AHB peripherals
+extern uint32_t xarmlib_host_gpio_memory[];     // GPIO and pin interrupts
+
+
+
+
+extern "C++"
+{
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+namespace host
+{
+
+
+
+
+// 32-bit peripheral register of the simulated register files. It has the
+// same size and alignment as the register it replaces in the peripheral
+// structures, but every access is forwarded to the simulator, so reads and
+// writes carry the side effects of the real hardware (FIFOs, W1C flags...).
+class Register
+{
+    public:
+
+        operator uint32_t() const volatile
+        {
+            return xarmlib_host_read_register(this);
+        }
+
+        // Allow the drivers to cast a register read to their bit enumerations
+        template <typename Enum, typename = typename std::enable_if<std::is_enum<Enum>::value>::type>
+        explicit operator Enum() const volatile
+        {
+            return static_cast<Enum>(xarmlib_host_read_register(this));
+        }
+
+        void operator = (const uint32_t value) volatile
+        {
+            xarmlib_host_write_register(this, value);
+        }
+
+        void operator |= (const uint32_t value) volatile
+        {
+            xarmlib_host_write_register(this, xarmlib_host_read_register(this) | value);
+        }
+
+        void operator &= (const uint32_t value) volatile
+        {
+            xarmlib_host_write_register(this, xarmlib_host_read_register(this) & value);
+        }
+
+        void operator ^= (const uint32_t value) volatile
+        {
+            xarmlib_host_write_register(this, xarmlib_host_read_register(this) ^ value);
+        }
+
+    private:
+
+        // Storage is owned by the simulator (accessed through the hooks only)
+        uint32_t m_storage;
+};
+
+static_assert(sizeof(Register) == sizeof(uint32_t), "Simulated register size must match a hardware register.");
+
+
+
+
+} // namespace host
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+} // extern "C++"
+
+
+
+
+// ----------------------------------------------------------------------------
+// Core peripherals (same layout as the CMSIS Cortex-M0+ structures)
+// ----------------------------------------------------------------------------
+
+// Nested Vectored Interrupt Controller (NVIC)
+typedef struct
+{
+    __IOM xarmlib::targets::lpc84x::host::Register ISER[1];    // (offset: 0x000) Interrupt Set Enable Register
+          uint32_t                                 RESERVED0[31];
+    __IOM xarmlib::targets::lpc84x::host::Register ICER[1];    // (offset: 0x080) Interrupt Clear Enable Register
+          uint32_t                                 RESERVED1[31];
+    __IOM xarmlib::targets::lpc84x::host::Register ISPR[1];    // (offset: 0x100) Interrupt Set Pending Register
+          uint32_t                                 RESERVED2[31];
+    __IOM xarmlib::targets::lpc84x::host::Register ICPR[1];    // (offset: 0x180) Interrupt Clear Pending Register
+          uint32_t                                 RESERVED3[31];
+          uint32_t                                 RESERVED4[64];
+    __IOM xarmlib::targets::lpc84x::host::Register IP[8];      // (offset: 0x300) Interrupt Priority Register
+} NVIC_Type;
+
+// System Control Block (SCB)
+typedef struct
+{
+    __IM  xarmlib::targets::lpc84x::host::Register CPUID;      // (offset: 0x000) CPUID Base Register
+    __IOM xarmlib::targets::lpc84x::host::Register ICSR;       // (offset: 0x004) Interrupt Control and State Register
+    __IOM xarmlib::targets::lpc84x::host::Register VTOR;       // (offset: 0x008) Vector Table Offset Register
+    __IOM xarmlib::targets::lpc84x::host::Register AIRCR;      // (offset: 0x00C) Application Interrupt and Reset Control Register
+    __IOM xarmlib::targets::lpc84x::host::Register SCR;        // (offset: 0x010) System Control Register
+    __IOM xarmlib::targets::lpc84x::host::Register CCR;        // (offset: 0x014) Configuration Control Register
+          uint32_t                                 RESERVED1;
+    __IOM xarmlib::targets::lpc84x::host::Register SHP[2];     // (offset: 0x01C) System Handlers Priority Registers
+    __IOM xarmlib::targets::lpc84x::host::Register SHCSR;      // (offset: 0x024) System Handler Control and State Register
+} SCB_Type;
+
+// System Timer (SysTick)
+typedef struct
+{
+    __IOM xarmlib::targets::lpc84x::host::Register CTRL;       // (offset: 0x000) SysTick Control and Status Register
+    __IOM xarmlib::targets::lpc84x::host::Register LOAD;       // (offset: 0x004) SysTick Reload Value Register
+    __IOM xarmlib::targets::lpc84x::host::Register VAL;        // (offset: 0x008) SysTick Current Value Register
+    __IM  xarmlib::targets::lpc84x::host::Register CALIB;      // (offset: 0x00C) SysTick Calibration Register
+} SysTick_Type;
+
+// SysTick Control / Status Register bits
+#define SysTick_CTRL_COUNTFLAG_Msk  (1U << 16)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1U << 2)
+#define SysTick_CTRL_TICKINT_Msk    (1U << 1)
+#define SysTick_CTRL_ENABLE_Msk     (1U << 0)
+
+// Core peripherals memory map (simulated System Control Space)
+#define SCS_BASE                    (reinterpret_cast<uintptr_t>(xarmlib_host_scs_memory))
+#define SysTick_BASE                (SCS_BASE + 0x0010UL)
+#define NVIC_BASE                   (SCS_BASE + 0x0100UL)
+#define SCB_BASE                    (SCS_BASE + 0x0D00UL)
+
+#define SCB                         ((SCB_Type     *) SCB_BASE    )
+#define SysTick                     ((SysTick_Type *) SysTick_BASE)
+#define NVIC                        ((NVIC_Type    *) NVIC_BASE   )
+
+
+
+
+// ----------------------------------------------------------------------------
+// Core instructions
+// ----------------------------------------------------------------------------
+
+static inline void __NOP(void)          { xarmlib_host_consume_cycles(1); }
+static inline void __WFI(void)          { xarmlib_host_wait_for_interrupt(); }
+static inline void __WFE(void)          { xarmlib_host_wait_for_interrupt(); }
+static inline void __SEV(void)          {}
+static inline void __ISB(void)          { __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void)          { __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+static inline void __DMB(void)          { __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+
+static inline void __enable_irq(void)   { xarmlib_host_set_primask(0); }
+static inline void __disable_irq(void)  { xarmlib_host_set_primask(1); }
+
+static inline uint32_t __get_PRIMASK(void)           { return xarmlib_host_get_primask(); }
+static inline void     __set_PRIMASK(uint32_t primask) { xarmlib_host_set_primask(primask); }
+
+
+
+
+// ----------------------------------------------------------------------------
+// NVIC functions
+// ----------------------------------------------------------------------------
+
+#define NVIC_EnableIRQ              __NVIC_EnableIRQ
+#define NVIC_GetEnableIRQ           __NVIC_GetEnableIRQ
+#define NVIC_DisableIRQ             __NVIC_DisableIRQ
+#define NVIC_GetPendingIRQ          __NVIC_GetPendingIRQ
+#define NVIC_SetPendingIRQ          __NVIC_SetPendingIRQ
+#define NVIC_ClearPendingIRQ        __NVIC_ClearPendingIRQ
+#define NVIC_SetPriority            __NVIC_SetPriority
+#define NVIC_GetPriority            __NVIC_GetPriority
+#define NVIC_SystemReset            __NVIC_SystemReset
+
+static inline void __NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        NVIC->ISER[0] = 1UL << (static_cast<uint32_t>(IRQn) & 0x1F);
+    }
+}
+
+static inline uint32_t __NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        return ((NVIC->ISER[0] & (1UL << (static_cast<uint32_t>(IRQn) & 0x1F))) != 0) ? 1 : 0;
+    }
+
+    return 0;
+}
+
+static inline void __NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        NVIC->ICER[0] = 1UL << (static_cast<uint32_t>(IRQn) & 0x1F);
+    }
+}
+
+static inline uint32_t __NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        return ((NVIC->ISPR[0] & (1UL << (static_cast<uint32_t>(IRQn) & 0x1F))) != 0) ? 1 : 0;
+    }
+
+    return 0;
+}
+
+static inline void __NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        NVIC->ISPR[0] = 1UL << (static_cast<uint32_t>(IRQn) & 0x1F);
+    }
+}
+
+static inline void __NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        NVIC->ICPR[0] = 1UL << (static_cast<uint32_t>(IRQn) & 0x1F);
+    }
+}
+
+// NOTE: Only the device interrupts are simulated (core exception priorities are ignored)
+static inline void __NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        const uint32_t index = static_cast<uint32_t>(IRQn) >> 2;
+        const uint32_t shift = (static_cast<uint32_t>(IRQn) & 0x03) * 8;
+
+        NVIC->IP[index] = (NVIC->IP[index] & ~(0xFFUL << shift))
+                        | (((priority << (8 - __NVIC_PRIO_BITS)) & 0xFFUL) << shift);
+    }
+}
+
+static inline uint32_t __NVIC_GetPriority(IRQn_Type IRQn)
+{
+    if(static_cast<int32_t>(IRQn) >= 0)
+    {
+        const uint32_t index = static_cast<uint32_t>(IRQn) >> 2;
+        const uint32_t shift = (static_cast<uint32_t>(IRQn) & 0x03) * 8;
+
+        return ((NVIC->IP[index] >> shift) & 0xFFUL) >> (8 - __NVIC_PRIO_BITS);
+    }
+
+    return 0;
+}
+
+__attribute__ ((noreturn))
+static inline void __NVIC_SystemReset(void)
+{
+    xarmlib_host_system_reset();
+}
+
+
+
+
+#endif // __XARMLIB_TARGETS_LPC84X_HOST_CORE_HPP
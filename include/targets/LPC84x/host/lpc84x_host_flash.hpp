@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_host_flash.hpp
+// @brief   Host simulation of the LPC84x flash (Iap flash programming interface).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_HOST_FLASH_HPP
+#define __XARMLIB_TARGETS_LPC84X_HOST_FLASH_HPP
+
+#include "system/gsl"
+#include "targets/LPC84x/lpc84x_iap.hpp"
+
+#include <cstdint>
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// NOTE: Simulated flash memory with the flash programming functions of the
+//       Iap class (same geometry), so the classes with a flash backend
+//       template parameter run on the host (e.g. FlashKvStore<HostFlash>).
+//       Erasing sets all the bytes of a sector to 0xFF and programming can
+//       only clear bits. The contents survive the simulated MCU reset (only
+//       erase_all() clears them).
+//       A power failure can be injected after a number of page program /
+//       sector erase operations: the failing operation is left half done
+//       (a random number of bytes written) and every later operation fails
+//       until the power is restored.
+class HostFlash
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- FLASH INTERFACE -------------------------------------------
+
+        // Program already erased flash pages (size multiple of the page size)
+        static bool program_flash(const int32_t flash_address, const gsl::span<const uint8_t> buffer);
+
+        // Erase a range of flash sectors
+        static bool erase_flash_sectors(const int32_t first_sector, const int32_t last_sector);
+
+        static void read_flash(const int32_t flash_address, const gsl::span<uint8_t> buffer);
+
+        static constexpr int32_t get_page_size()
+        {
+            return Iap::get_page_size();
+        }
+
+        static constexpr int32_t get_sector_size()
+        {
+            return Iap::get_sector_size();
+        }
+
+        static constexpr int32_t get_sector_count()
+        {
+            return Iap::get_sector_count();
+        }
+
+        // -------- SIMULATION CONTROL ----------------------------------------
+
+        // Erase the whole flash and clear the counters (power restored)
+        static void erase_all();
+
+        // Fail the operation after the supplied number of successful ones
+        static void set_power_fail(const int32_t operation_count);
+
+        // Restore the power (and cancel a pending power failure)
+        static void restore_power();
+
+        static bool is_power_failed();
+
+        // -------- COUNTERS --------------------------------------------------
+
+        static int32_t get_sector_erase_count(const int32_t sector);
+        static int64_t get_page_program_count();
+
+        // Pages programmed again without an erase in between (not allowed by the flash)
+        static int64_t get_page_reprogram_count();
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_HOST_FLASH_HPP
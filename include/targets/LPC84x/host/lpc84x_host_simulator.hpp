@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_host_simulator.hpp
+// @brief   Host simulation of the LPC84x peripherals (virtual clock, register files and NVIC).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_HOST_SIMULATOR_HPP
+#define __XARMLIB_TARGETS_LPC84X_HOST_SIMULATOR_HPP
+
+#include "system/chrono"
+#include "system/delegate"
+#include "system/gsl"
+#include "targets/LPC84x/lpc84x_pin.hpp"
+
+#include <cstddef>
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// NOTE: Host simulation target (XARMLIB_HOST_SIMULATION defined on a Linux
+//       build). The peripheral register files are simulated and every
+//       register access advances a virtual clock (the instructions of the
+//       program itself take no time). Behavioural models exist for:
+//       - USART: RX line / holding register, TX holding / shift register,
+//         status flags, interrupts, 9-bit address detection and character
+//         times computed from the baudrate registers;
+//       - SPI: master transfers (loopback or a user responder), status
+//         flags and interrupts;
+//       - MRT: the 4 channels in repeat / one-shot modes with interrupts;
+//       - SCT: the unified counter with prescaler, match events and limit
+//         (enough for the microseconds ticker);
+//       - GPIO: direction, output latches, masked and unmasked port access
+//         and externally driven input levels;
+//       - PIN_INT: edge / level pin interrupts of the PINTSEL inputs and
+//         the pattern match engine (slices, product terms and sticky edges,
+//         driving the IRQs without setting IST);
+//       - CRC: the three polynomials with the input / sum bit reversal and
+//         complement options (word and byte writes);
+//       - DMA: descriptor chains (reload and trigger control) paced by the
+//         USART / SPI requests, with the A / B interrupt flags;
+//       - NVIC: enables, pending, priorities and PRIMASK, dispatching into
+//         the existing '*_IRQHandler' functions (nesting by priority).
+//       Every other register (SYSCON, SWM, IOCON...) is plain memory, except
+//       the system PLL always reports a lock. All peripheral clocks are
+//       assumed to run at the core clock, only the FRG multiplier is applied
+//       to the USART character times. IAP and FAIM aren't simulated
+//       (HostFlash replaces Iap as the flash backend of FlashKvStore).
+//       The simulated MCU is reset and the startup hooks (clock setup and
+//       microseconds ticker) run before the static constructors of the
+//       program, as 'mcu_startup()' does on the target.
+//       DMA descriptors and buffers are addressed with 32 bits, so they must
+//       be static (the host program is linked without PIE).
+//       The program must access a peripheral register (or call '__NOP()' /
+//       '__WFI()') when busy-waiting, otherwise the virtual time stops.
+class HostSimulator
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Virtual clock cycles consumed by each peripheral register access
+        static constexpr int32_t REGISTER_ACCESS_CYCLES { 2 };
+
+        // SPI slave response to each frame sent by the master (MISO data)
+        using SpiResponder = Delegate<uint32_t(const uint32_t)>;
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- CONTROL ---------------------------------------------------
+
+        // Advance the virtual clock, dispatching the interrupts on time
+        static void run_for(const std::chrono::microseconds duration);
+        static void run_cycles(const int64_t cycles);
+
+        // Elapsed virtual clock cycles / time since initialization
+        static int64_t                   get_cycles();
+        static std::chrono::microseconds get_time();
+
+        // -------- USART -----------------------------------------------------
+
+        // NOTE: The peripherals are selected by index (0 for USART0 / SPI0...)
+        //       since the target driver names aren't public.
+
+        // Queue characters on the USART RX line (received back-to-back)
+        static void receive_usart_data(const std::size_t usart_index, const gsl::span<const uint8_t> data);
+
+        // Queue a 9-bit address character (9th bit set) on the USART RX line
+        static void receive_usart_address(const std::size_t usart_index, const uint8_t address);
+
+        // Pop the characters already shifted out on the USART TX line
+        // (returns the number of characters read into the buffer)
+        static int32_t read_usart_transmitted(const std::size_t usart_index, gsl::span<uint8_t> buffer);
+
+        // -------- SPI -------------------------------------------------------
+
+        // Assign the SPI slave responder (all ones are received without one,
+        // unless the loopback mode is enabled in the SPI configuration)
+        static void set_spi_responder(const std::size_t spi_index, const SpiResponder& responder);
+
+        // Slave select state (asserted from the first frame until a frame with
+        // the end of transfer control is shifted out)
+        static bool is_spi_selected(const std::size_t spi_index);
+
+        // -------- GPIO ------------------------------------------------------
+
+        // Drive the level of an input pin (inputs are pulled-up by default)
+        static void set_pin_input_level(const Pin::Name pin_name, const bool level);
+
+        // Level of a pin (output latch when configured as output)
+        static bool get_pin_level(const Pin::Name pin_name);
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_HOST_SIMULATOR_HPP
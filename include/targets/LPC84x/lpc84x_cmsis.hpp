@@ -38,7 +38,14 @@
 #ifndef __XARMLIB_TARGETS_LPC84X_CMSIS_HPP
 #define __XARMLIB_TARGETS_LPC84X_CMSIS_HPP
 
+#include "system/target"
+
+#if defined __TARGET_HOST_SIMULATION__
+#include <cstdint>
+#include <type_traits>
+#else
 #include "cmsis_compiler.h"
+#endif
 #include "cmsis_version.h"
 
 #ifdef __cplusplus
@@ -111,6 +118,7 @@ typedef enum IRQn
 // Configuration of the Cortex-M0+ Processor and Core Peripherals
 #define __CM0PLUS_REV           0x0001
 #define __MPU_PRESENT           0           // MPU present or not
+#define __VTOR_PRESENT          1           // VTOR present or not
 #define __NVIC_PRIO_BITS        2           // Number of Bits used for Priority Levels
 #define __Vendor_SysTickConfig  0           // Set to 1 if different SysTick Config is used
 
@@ -127,7 +135,11 @@ void SystemCoreClockUpdate(void);
 
 
 
+#if defined __TARGET_HOST_SIMULATION__
+#include "targets/LPC84x/host/lpc84x_host_core.hpp" // Simulated Cortex-M0+ core peripherals
+#else
 #include "core_cm0plus.h"                   // Cortex-M0+ processor and core peripherals
+#endif
 
 
 
@@ -136,6 +148,19 @@ void SystemCoreClockUpdate(void);
 // Device Specific Peripheral Registers structures
 // ----------------------------------------------------------------------------
 
+#if defined __TARGET_HOST_SIMULATION__
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+namespace host
+{
+// Every 32-bit register of the structures below is a simulated register
+using uint32_t = Register;
+#endif
+
 
 
 // ------------ System Control (SYSCON) ---------------------------------------
@@ -1051,6 +1076,39 @@ typedef struct
     };
 } LPC_FAIM_T;
 
+#if defined __TARGET_HOST_SIMULATION__
+} // namespace host
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+using xarmlib::targets::lpc84x::host::LPC_SYSCON_T;
+using xarmlib::targets::lpc84x::host::LPC_IOCON_T;
+using xarmlib::targets::lpc84x::host::LPC_FMC_T;
+using xarmlib::targets::lpc84x::host::LPC_PMU_T;
+using xarmlib::targets::lpc84x::host::LPC_SWM_T;
+using xarmlib::targets::lpc84x::host::LPC_GPIO_T;
+using xarmlib::targets::lpc84x::host::LPC_PIN_INT_T;
+using xarmlib::targets::lpc84x::host::LPC_CRC_T;
+using xarmlib::targets::lpc84x::host::LPC_CMP_T;
+using xarmlib::targets::lpc84x::host::LPC_WKT_T;
+using xarmlib::targets::lpc84x::host::LPC_MRT_CHANNEL_T;
+using xarmlib::targets::lpc84x::host::LPC_MRT_T;
+using xarmlib::targets::lpc84x::host::LPC_USART_T;
+using xarmlib::targets::lpc84x::host::LPC_SPI_T;
+using xarmlib::targets::lpc84x::host::LPC_I2C_T;
+using xarmlib::targets::lpc84x::host::LPC_SCT_T;
+using xarmlib::targets::lpc84x::host::LPC_CTIMER_T;
+using xarmlib::targets::lpc84x::host::LPC_WWDT_T;
+using xarmlib::targets::lpc84x::host::LPC_INMUX_TRIGMUX_T;
+using xarmlib::targets::lpc84x::host::LPC_ADC_T;
+using xarmlib::targets::lpc84x::host::LPC_DMA_CHANNEL_T;
+using xarmlib::targets::lpc84x::host::LPC_DMA_T;
+using xarmlib::targets::lpc84x::host::LPC_DAC_T;
+using xarmlib::targets::lpc84x::host::LPC_CAPT_T;
+using xarmlib::targets::lpc84x::host::LPC_FAIM_T;
+#endif
+
 
 
 
@@ -1120,9 +1178,16 @@ typedef void (*LPC_ROM_IAP_ENTRY_T)(uint32_t command[], uint32_t result[]);
 #define LPC_FLASH_BASE          (0x00000000UL)
 #define LPC_ROM_BASE            (0x0F000000UL)
 #define LPC_RAM_BASE            (0x10000000UL)
+#if defined __TARGET_HOST_SIMULATION__
+// Peripheral address spaces owned by the host simulator
+#define LPC_APB_BASE            (reinterpret_cast<uintptr_t>(xarmlib_host_apb_memory))
+#define LPC_AHB_BASE            (reinterpret_cast<uintptr_t>(xarmlib_host_ahb_memory))
+#define LPC_GPIO_BASE           (reinterpret_cast<uintptr_t>(xarmlib_host_gpio_memory))
+#else
 #define LPC_APB_BASE            (0x40000000UL)
 #define LPC_AHB_BASE            (0x50000000UL)
 #define LPC_GPIO_BASE           (0xA0000000UL)
+#endif
 
 // ROM Driver table
 #define LPC_ROM_DRIVER_BASE     (LPC_ROM_BASE + 0x1FF8)
@@ -1174,6 +1239,17 @@ typedef void (*LPC_ROM_IAP_ENTRY_T)(uint32_t command[], uint32_t result[]);
 //-------------------------------------------------------------------------
 // Peripheral declarations
 //-------------------------------------------------------------------------
+#if defined __TARGET_HOST_SIMULATION__
+// ROM API and IAP entry provided by the host simulator
+extern const LPC_ROM_API_T* const xarmlib_host_rom_api;
+void xarmlib_host_iap_entry(uint32_t command[], uint32_t result[]);
+
+#define LPC_ROM_API             (xarmlib_host_rom_api)
+#define LPC_ROM_PWR_API         ((LPC_ROM_PWR_API_T  *)(LPC_ROM_API->PWR_BASE_PTR))
+#define LPC_ROM_DIV_API         ((LPC_ROM_DIV_API_T  *)(LPC_ROM_API->DIV_BASE_PTR))
+
+static const LPC_ROM_IAP_ENTRY_T iap_entry = xarmlib_host_iap_entry;
+#else
 // ROM API
 #define LPC_ROM_API            (*(LPC_ROM_API_T    * *) LPC_ROM_DRIVER_BASE)
 #define LPC_ROM_PWR_API         ((LPC_ROM_PWR_API_T  *)(LPC_ROM_API->PWR_BASE_PTR))
@@ -1181,6 +1257,7 @@ typedef void (*LPC_ROM_IAP_ENTRY_T)(uint32_t command[], uint32_t result[]);
 
 // IAP entry function pointer
 static const LPC_ROM_IAP_ENTRY_T iap_entry = (LPC_ROM_IAP_ENTRY_T)(LPC_ROM_IAP_BASE);
+#endif
 
 // APB0 peripherals
 #define LPC_WWDT                ((LPC_WWDT_T         *) LPC_WWDT_BASE)
@@ -0,0 +1,205 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_crc_engine.hpp
+// @brief   NXP LPC84x CRC engine class.
+// @date    9 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_CRC_ENGINE_HPP
+#define __XARMLIB_TARGETS_LPC84X_CRC_ENGINE_HPP
+
+#include "system/cassert"
+#include "system/gsl"
+#include "targets/LPC84x/lpc84x_cmsis.hpp"
+#include "targets/LPC84x/lpc84x_syscon_clock.hpp"
+#include "targets/LPC84x/lpc84x_syscon_power.hpp"
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// Single CRC engine shared by all the users. Each calculation in progress is
+// identified by an owner, so the engine is only reconfigured (mode and seed)
+// when a different calculation takes it over.
+// NOTE: Not reentrant. Do not share the engine between threads / ISRs.
+class CrcEngine
+{
+    protected:
+
+        // --------------------------------------------------------------------
+        // PROTECTED DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Supported polynomials (defined to map the MODE register directly)
+        enum class Polynomial
+        {
+            CRC_CCITT = 0,      // x^16 + x^12 + x^5 + 1            (0x1021)
+            CRC_16,             // x^16 + x^15 + x^2 + 1            (0x8005)
+            CRC_32              // x^32 + x^26 + x^23 + ... + 1     (0x04C11DB7)
+        };
+
+        // --------------------------------------------------------------------
+        // PROTECTED MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Check if the CRC type and polynomial are supported by the engine
+        template <typename Type, Type polynomial>
+        static constexpr bool is_supported()
+        {
+            return (sizeof(Type) == 2 && (polynomial == 0x1021 || polynomial == 0x8005))
+                || (sizeof(Type) == 4 && (polynomial == 0x04C11DB7));
+        }
+
+        template <typename Type, Type polynomial>
+        static constexpr Polynomial get_polynomial()
+        {
+            static_assert(is_supported<Type, polynomial>() == true, "Polynomial not supported by the CRC engine.");
+
+            return (sizeof(Type) == 4)      ? Polynomial::CRC_32 :
+                   (polynomial == 0x8005)   ? Polynomial::CRC_16 : Polynomial::CRC_CCITT;
+        }
+
+        // Configure the engine and load the seed (current remainder, not reflected)
+        static void configure(const Polynomial polynomial,
+                              const bool       reflect_input,
+                              const bool       reflect_output,
+                              const uint32_t   seed)
+        {
+            if(Clock::is_enabled(Clock::Peripheral::CRC) == false)
+            {
+                Clock::enable(Clock::Peripheral::CRC);
+                Power::reset(Power::ResetPeripheral::CRC);
+            }
+
+            LPC_CRC->MODE = static_cast<uint32_t>(polynomial)
+                          | (reflect_input  ? MODE_BIT_RVS_WR  : 0)
+                          | (reflect_output ? MODE_BIT_RVS_SUM : 0);
+
+            LPC_CRC->SEED = seed;
+        }
+
+        // Feed the engine with 32-bit writes (byte writes only for the unaligned head and tail)
+        // NOTE: Word writes are processed as 4 bytes in little-endian order.
+        static void write(const gsl::span<const uint8_t> buffer)
+        {
+            const uint8_t* data  = buffer.data();
+            std::size_t    count = static_cast<std::size_t>(buffer.size());
+
+            for(; count > 0 && (reinterpret_cast<uintptr_t>(data) & 0x03) != 0; --count, ++data)
+            {
+                write_byte(*data);
+            }
+
+            const uint32_t* data32 = reinterpret_cast<const uint32_t*>(data);
+
+            for(; count >= 4; count -= 4, ++data32)
+            {
+                LPC_CRC->WR_DATA = *data32;
+            }
+
+            for(data = reinterpret_cast<const uint8_t*>(data32); count > 0; --count, ++data)
+            {
+                write_byte(*data);
+            }
+        }
+
+        static uint32_t read_sum()
+        {
+            return LPC_CRC->SUM;
+        }
+
+        // -------- OWNERSHIP -------------------------------------------------
+
+        static bool is_owner(const void* const owner)
+        {
+            return (m_owner == owner);
+        }
+
+        static void set_owner(const void* const owner)
+        {
+            m_owner = owner;
+        }
+
+        // Release the engine if owned by the supplied owner (forces a reconfiguration on next use)
+        static void release(const void* const owner)
+        {
+            if(m_owner == owner)
+            {
+                m_owner = nullptr;
+            }
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // CRC Mode Register (MODE) bits
+        enum MODE : uint32_t
+        {
+            MODE_BIT_RVS_WR     = (1 << 2),     // Bit order reverse for WR_DATA (per byte)
+            MODE_CMPL_WR        = (1 << 3),     // 1's complement for WR_DATA
+            MODE_BIT_RVS_SUM    = (1 << 4),     // Bit order reverse for SUM
+            MODE_CMPL_SUM       = (1 << 5)      // 1's complement for SUM
+        };
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static void write_byte(const uint8_t data)
+        {
+#if defined __TARGET_HOST_SIMULATION__
+            // Byte wide access forwarded to the simulated engine
+            xarmlib_host_write_register_byte(&LPC_CRC->WR_DATA, data);
+#else
+            *reinterpret_cast<__O uint8_t*>(&LPC_CRC->WR_DATA) = data;
+#endif
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        static const void* m_owner;     // Calculation currently loaded in the engine
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_CRC_ENGINE_HPP
@@ -0,0 +1,483 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_dma.hpp
+// @brief   NXP LPC84x DMA channel class.
+// @date    3 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_DMA_HPP
+#define __XARMLIB_TARGETS_LPC84X_DMA_HPP
+
+#include "system/array"
+#include "system/cassert"
+#include "system/delegate"
+#include "targets/peripheral_ref_counter.hpp"
+#include "targets/LPC84x/lpc84x_cmsis.hpp"
+#include "targets/LPC84x/lpc84x_syscon_clock.hpp"
+#include "targets/LPC84x/lpc84x_syscon_power.hpp"
+
+
+
+
+// Forward declaration of IRQ handler
+extern "C" void DMA_IRQHandler(void);
+
+
+
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// Number of available DMA channels
+static constexpr std::size_t DMA_CHANNEL_COUNT { DMA_NUM_CHANNELS };
+
+class DmaChannel : private PeripheralRefCounter<DmaChannel, DMA_CHANNEL_COUNT>
+{
+        // --------------------------------------------------------------------
+        // FRIEND FUNCTIONS DECLARATIONS
+        // --------------------------------------------------------------------
+
+        // Friend IRQ handler C function to give access to private IRQ handler member function
+        friend void ::DMA_IRQHandler(void);
+
+    protected:
+
+        // --------------------------------------------------------------------
+        // PROTECTED DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Base class alias
+        using PeripheralDmaChannel = PeripheralRefCounter<DmaChannel, DMA_CHANNEL_COUNT>;
+
+        // DMA channel names (named after the peripheral request hardwired to each channel)
+        // NOTE: Any channel can be used for memory to memory transfers if
+        //       its peripheral request is not needed by the application.
+        enum class Name
+        {
+            USART0_RX = 0,
+            USART0_TX,
+            USART1_RX,
+            USART1_TX,
+            USART2_RX,
+            USART2_TX,
+            USART3_RX,
+            USART3_TX,
+            USART4_RX,
+            USART4_TX,
+            SPI0_RX,
+            SPI0_TX,
+            SPI1_RX,
+            SPI1_TX,
+            I2C0_SLV,
+            I2C0_MST,
+            I2C1_SLV,
+            I2C1_MST,
+            I2C2_SLV,
+            I2C2_MST,
+            I2C3_SLV,
+            I2C3_MST,
+            DAC0,
+            DAC1,
+            CAPT
+        };
+
+        // Transfer request selection (defined to map the channel CFG register directly)
+        enum class Request
+        {
+            SOFTWARE   = (0 << 0),      // Transfers run as fast as possible once triggered (memory to memory)
+            PERIPHERAL = (1 << 0)       // Each transfer is paced by the channel peripheral request
+        };
+
+        // Channel priority selection (defined to map the channel CFG register directly)
+        enum class Priority
+        {
+            HIGHEST = (0 << 16),
+            HIGH    = (2 << 16),
+            MEDIUM  = (4 << 16),
+            LOW     = (6 << 16),
+            LOWEST  = (7 << 16)
+        };
+
+        // Transfer width selection (defined to map the XFERCFG register directly)
+        enum class Width
+        {
+            BITS_8  = (0 << 8),
+            BITS_16 = (1 << 8),
+            BITS_32 = (2 << 8)
+        };
+
+        // Address increment selection (in multiples of the transfer width)
+        enum class Increment
+        {
+            NONE = 0,
+            X1,
+            X2,
+            X4
+        };
+
+        // Interrupt flag raised on descriptor completion (defined to map the XFERCFG register directly)
+        enum class Interrupt
+        {
+            NONE = 0,
+            A    = (1 << 4),
+            B    = (1 << 5)
+        };
+
+        // Transfer descriptor
+        // NOTE: Linked descriptors must be 16 byte aligned and remain
+        //       valid while the channel is running.
+        struct alignas(16) Descriptor
+        {
+            uint32_t xfercfg;           // Transfer configuration (reloaded into XFERCFG when linked)
+            uint32_t source_end;        // Address of the last source element
+            uint32_t destination_end;   // Address of the last destination element
+            uint32_t next;              // Address of the next linked descriptor (0 if none)
+        };
+
+        // Transfer parameters used to build a descriptor
+        struct Transfer
+        {
+            const volatile void* source;
+            volatile void*       destination;
+            int32_t              count;                                 // Number of elements [1..1024]
+            Width                width                 { Width::BITS_8 };
+            Increment            source_increment      { Increment::X1 };
+            Increment            destination_increment { Increment::X1 };
+            Interrupt            interrupt             { Interrupt::A };
+        };
+
+        class IrqFlags
+        {
+            public:
+
+                IrqFlags(const bool int_a, const bool int_b, const bool error) : m_int_a { int_a },
+                                                                                 m_int_b { int_b },
+                                                                                 m_error { error }
+                {}
+
+                bool is_interrupt_a() const { return m_int_a; }
+                bool is_interrupt_b() const { return m_int_b; }
+                bool is_error      () const { return m_error; }
+
+            private:
+
+                bool m_int_a;
+                bool m_int_b;
+                bool m_error;
+        };
+
+        // IRQ handler definition
+        using IrqHandlerType = int32_t(const IrqFlags& irq_flags);
+        using IrqHandler     = Delegate<IrqHandlerType>;
+
+        // Maximum number of elements moved by a single descriptor
+        static constexpr int32_t MAX_TRANSFER_COUNT { 1024 };
+
+        // --------------------------------------------------------------------
+        // PROTECTED MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- CONSTRUCTOR / DESTRUCTOR ----------------------------------
+
+        DmaChannel(const Name name, const Request request, const Priority priority) : PeripheralDmaChannel(*this, static_cast<std::size_t>(name))
+        {
+            // Enable DMA controller if this is the first channel created
+            if(get_used() == 1)
+            {
+                Clock::enable(Clock::Peripheral::DMA);
+                Power::reset(Power::ResetPeripheral::DMA);
+
+                LPC_DMA->SRAMBASE = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(m_descriptor_table.data()));
+                LPC_DMA->CTRL     = CTRL_ENABLE;
+
+                NVIC_EnableIRQ(DMA_IRQn);
+            }
+
+            const auto channel_index = get_index();
+
+            // Set pointer to the available channel structure and channel mask
+            m_channel = &LPC_DMA->CHANNEL[channel_index];
+            m_mask    = (1UL << channel_index);
+
+            m_channel->CFG = static_cast<uint32_t>(request) | static_cast<uint32_t>(priority);
+        }
+
+        ~DmaChannel()
+        {
+            abort();
+            disable_irq();
+
+            // Disable DMA controller if this the last channel deleted
+            if(get_used() == 1)
+            {
+                LPC_DMA->CTRL = 0;
+
+                Clock::disable(Clock::Peripheral::DMA);
+
+                NVIC_DisableIRQ(DMA_IRQn);
+            }
+        }
+
+        // -------- DESCRIPTORS -----------------------------------------------
+
+        // Fill a descriptor with the supplied transfer parameters, optionally linking it to a next descriptor
+        // NOTE: A channel reloads the next descriptor when the current one is exhausted. Linking
+        //       two descriptors to each other results in a continuous ping-pong transfer.
+        static void set_descriptor(Descriptor& descriptor, const Transfer& transfer, const Descriptor* next = nullptr)
+        {
+            assert(transfer.count >= 1 && transfer.count <= MAX_TRANSFER_COUNT);
+
+            const uint32_t width_bytes = 1UL << (static_cast<uint32_t>(transfer.width) >> 8);
+            const uint32_t last_offset = static_cast<uint32_t>(transfer.count - 1) * width_bytes;
+
+            descriptor.xfercfg = XFERCFG_CFGVALID
+                               | ((next != nullptr) ? XFERCFG_RELOAD : XFERCFG_CLRTRIG)
+                               | static_cast<uint32_t>(transfer.interrupt)
+                               | static_cast<uint32_t>(transfer.width)
+                               | (static_cast<uint32_t>(transfer.source_increment)      << 12)
+                               | (static_cast<uint32_t>(transfer.destination_increment) << 14)
+                               | (static_cast<uint32_t>(transfer.count - 1)             << 16);
+
+            descriptor.source_end      = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(transfer.source))
+                                       + last_offset * get_increment_factor(transfer.source_increment);
+            descriptor.destination_end = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(transfer.destination))
+                                       + last_offset * get_increment_factor(transfer.destination_increment);
+            descriptor.next            = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(next));
+        }
+
+        // -------- START / ABORT ---------------------------------------------
+
+        // Start the channel with the supplied (first) descriptor
+        void start(const Descriptor& descriptor)
+        {
+            assert(is_busy() == false);
+
+            // The channel table entry holds the first descriptor (its configuration goes to XFERCFG)
+            Descriptor& entry = m_descriptor_table[get_index()];
+
+            entry.source_end      = descriptor.source_end;
+            entry.destination_end = descriptor.destination_end;
+            entry.next            = descriptor.next;
+
+            LPC_DMA->ENABLESET0 = m_mask;
+
+            m_channel->XFERCFG = descriptor.xfercfg | XFERCFG_SWTRIG;
+        }
+
+        // Start a single (unlinked) transfer
+        void start(const Transfer& transfer)
+        {
+            Descriptor descriptor;
+
+            set_descriptor(descriptor, transfer);
+            start(descriptor);
+        }
+
+        // Stop any ongoing transfer
+        void abort()
+        {
+            LPC_DMA->ENABLECLR0 = m_mask;
+
+            while((LPC_DMA->BUSY0 & m_mask) != 0);
+
+            LPC_DMA->ABORT0 = m_mask;
+        }
+
+        // Gets the transfer state (a descriptor is being processed)
+        bool is_busy() const
+        {
+            return (LPC_DMA->BUSY0 & m_mask) != 0;
+        }
+
+        // Gets the channel state (valid configuration pending or transfer in progress)
+        bool is_active() const
+        {
+            return (LPC_DMA->ACTIVE0 & m_mask) != 0;
+        }
+
+        // Number of elements still to be moved by the current descriptor
+        int32_t get_remaining_count() const
+        {
+            if(is_active() == false)
+            {
+                return 0;
+            }
+
+            // NOTE: XFERCOUNT is decremented after each transfer and holds count - 1
+            return static_cast<int32_t>((m_channel->XFERCFG >> 16) & 0x3FF) + 1;
+        }
+
+        // -------- PRIORITY --------------------------------------------------
+
+        void set_priority(const Priority priority)
+        {
+            m_channel->CFG = (m_channel->CFG & ~CFG_CHPRIORITY_BITMASK) | static_cast<uint32_t>(priority);
+        }
+
+        // -------- INTERRUPTS ------------------------------------------------
+
+        void enable_irq()
+        {
+            LPC_DMA->INTENSET0 = m_mask;
+        }
+
+        void disable_irq()
+        {
+            LPC_DMA->INTENCLR0 = m_mask;
+        }
+
+        bool is_enabled_irq() const
+        {
+            return (LPC_DMA->INTENSET0 & m_mask) != 0;
+        }
+
+        static void set_dma_irq_priority(const uint32_t irq_priority)
+        {
+            NVIC_SetPriority(DMA_IRQn, irq_priority);
+        }
+
+        void assign_irq_handler(const IrqHandler& irq_handler)
+        {
+            assert(irq_handler != nullptr);
+
+            m_irq_handler = irq_handler;
+        }
+
+        void remove_irq_handler()
+        {
+            m_irq_handler = nullptr;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // DMA Control Register (CTRL) bits
+        enum CTRL : uint32_t
+        {
+            CTRL_ENABLE             = (1 << 0)
+        };
+
+        // DMA Channel Configuration Register (CFG) bits and masks
+        enum CFG : uint32_t
+        {
+            CFG_PERIPHREQEN         = (1 << 0),
+            CFG_HWTRIGEN            = (1 << 1),
+            CFG_CHPRIORITY_BITMASK  = (7 << 16)
+        };
+
+        // DMA Channel Transfer Configuration Register (XFERCFG) bits
+        enum XFERCFG : uint32_t
+        {
+            XFERCFG_CFGVALID        = (1 << 0),
+            XFERCFG_RELOAD          = (1 << 1),
+            XFERCFG_SWTRIG          = (1 << 2),
+            XFERCFG_CLRTRIG         = (1 << 3)
+        };
+
+        // Descriptor table (SRAMBASE) shared by all channels
+        // NOTE: Must be 512 byte aligned.
+        struct alignas(512) DescriptorTable : std::array<Descriptor, DMA_CHANNEL_COUNT>
+        {};
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Address increment in multiples of the transfer width
+        static constexpr uint32_t get_increment_factor(const Increment increment)
+        {
+            return (increment == Increment::NONE) ? 0 : (1UL << (static_cast<uint32_t>(increment) - 1));
+        }
+
+        // IRQ handler for all channels
+        // NOTE: Returns yield flag for FreeRTOS
+        inline __attribute__((always_inline))
+        static int32_t irq_handler()
+        {
+            int32_t yield = 0;  // Used by FreeRTOS
+
+            const uint32_t int_a = LPC_DMA->INTA0;
+            const uint32_t int_b = LPC_DMA->INTB0;
+            const uint32_t error = LPC_DMA->ERRINT0;
+
+            // Clear handled flags
+            LPC_DMA->INTA0   = int_a;
+            LPC_DMA->INTB0   = int_b;
+            LPC_DMA->ERRINT0 = error;
+
+            uint32_t pending = int_a | int_b | error;
+
+            while(pending != 0)
+            {
+                const std::size_t ch_index = __builtin_ctz(pending);
+                const uint32_t    ch_mask  = (1UL << ch_index);
+
+                pending &= ~ch_mask;
+
+                auto* const channel = get_pointer(ch_index);
+
+                if(channel != nullptr && channel->m_irq_handler != nullptr)
+                {
+                    const IrqFlags irq_flags { (int_a & ch_mask) != 0, (int_b & ch_mask) != 0, (error & ch_mask) != 0 };
+
+                    yield |= channel->m_irq_handler(irq_flags);
+                }
+            }
+
+            return yield;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        LPC_DMA_CHANNEL_T*     m_channel { nullptr };   // Pointer to the individual DMA channel structure
+        uint32_t               m_mask    { 0 };         // Channel bit mask (for the shared registers)
+
+        IrqHandler             m_irq_handler;           // User defined IRQ handler
+
+        static DescriptorTable m_descriptor_table;      // Channel descriptor table
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_DMA_HPP
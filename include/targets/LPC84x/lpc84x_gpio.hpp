@@ -288,6 +288,9 @@ class Gpio
             OUTPUT
         };
 
+        // GPIO port register type (word / direction registers)
+        using PortRegister = decltype(LPC_GPIO->DIR0);
+
         // --------------------------------------------------------------------
         // PRIVATE MEMBER FUNCTIONS
         // --------------------------------------------------------------------
@@ -349,8 +352,8 @@ class Gpio
 
         Pin::Name     		m_pin_name { Pin::Name::NC };
              uint32_t       m_pin_mask { 0 };
-        __IO uint32_t*      reg_w      { nullptr };
-        __IO uint32_t*      reg_dir    { nullptr };
+             PortRegister*  reg_w      { nullptr };
+             PortRegister*  reg_dir    { nullptr };
 };
 
 
@@ -32,9 +32,11 @@
 #ifndef __XARMLIB_TARGETS_LPC84X_IAP_HPP
 #define __XARMLIB_TARGETS_LPC84X_IAP_HPP
 
+#include "system/cassert"
 #include "system/gsl"
 #include "targets/LPC84x/lpc84x_cmsis.hpp"
 #include "targets/LPC84x/lpc84x_pin.hpp"
+#include "targets/LPC84x/lpc84x_vector_table.hpp"
 
 namespace xarmlib
 {
@@ -143,6 +145,10 @@ class Iap
         //                 This address should be a 64 byte boundary.
         // @ buffer:       Buffer span containing the data to be written.
         // NOTE:           Buffer size must be multiple of 64 bytes (page size).
+        //                 Pages that already hold the supplied data are skipped.
+        //                 Each run of consecutive changed pages is erased with
+        //                 the fewest erase commands (whole sectors when possible)
+        //                 and programmed with the largest allowed copy sizes.
         static bool write_flash(const int32_t flash_address, const gsl::span<const uint8_t> buffer)
         {
             // Check for valid buffer size (multiple of page size)
@@ -159,20 +165,109 @@ class Iap
             }
 
             // Get the page of the flash address
-            int32_t flash_page = get_page(flash_address);
+            const int32_t first_page = get_page(flash_address);
+            const int32_t page_count = static_cast<int32_t>(buffer.size() / m_page_size);
 
-            for(int32_t p = 0; p < buffer.size(); p += m_page_size)
+            int32_t page = 0;
+
+            while(page < page_count)
             {
-                // Write buffer one page at a time -> {0,63}, {64,127}, ...
-                if(write_flash_page(flash_page++, buffer.subspan(p, m_page_size)) == false)
+                // Skip the pages that already hold the supplied data
+                if(is_flash_page_equal(first_page + page, buffer.subspan(page * m_page_size, m_page_size)) == true)
+                {
+                    page++;
+                    continue;
+                }
+
+                // Find the end of the run of changed pages
+                int32_t run_end = page + 1;
+
+                while(run_end < page_count &&
+                      is_flash_page_equal(first_page + run_end, buffer.subspan(run_end * m_page_size, m_page_size)) == false)
+                {
+                    run_end++;
+                }
+
+                if(write_flash_pages(first_page + page, buffer.subspan(page * m_page_size, (run_end - page) * m_page_size)) == false)
                 {
                     return false;
                 }
+
+                page = run_end;
             }
 
             return true;
         }
 
+        // Program already erased flash pages (no erase is done)
+        // @flash_address: Destination flash address where data is to be written.
+        //                 This address should be a 64 byte boundary.
+        // @ buffer:       Buffer span (in RAM and word aligned) containing the data to be written.
+        // NOTE:           Buffer size must be multiple of 64 bytes (page size).
+        //                 A page can only be programmed once after being erased.
+        static bool program_flash(const int32_t flash_address, const gsl::span<const uint8_t> buffer)
+        {
+            // Check for valid buffer size (multiple of page size)
+            if(buffer.size() <= 0 || (buffer.size() % m_page_size) != 0)
+            {
+                return false;
+            }
+
+            // Check for valid address boundary
+            if(flash_address < 0 || (flash_address % m_page_size) != 0 ||
+              (flash_address + buffer.size()) > (m_page_count * m_page_size))
+            {
+                return false;
+            }
+
+            return copy_to_flash(flash_address, buffer);
+        }
+
+        // Erase a range of flash sectors (1kB each)
+        static bool erase_flash_sectors(const int32_t first_sector, const int32_t last_sector)
+        {
+            if(first_sector < 0 || first_sector > last_sector || last_sector >= get_sector_count())
+            {
+                return false;
+            }
+
+            // Prepare sectors for erasing
+            if(prepare_sectors(first_sector, last_sector) != StatusCode::CMD_SUCCESS)
+            {
+                return false;
+            }
+
+            return (erase_sectors(first_sector, last_sector) == StatusCode::CMD_SUCCESS);
+        }
+
+        // Read from flash
+        static void read_flash(const int32_t flash_address, const gsl::span<uint8_t> buffer)
+        {
+            assert(flash_address >= 0 && (flash_address + buffer.size()) <= (m_page_count * m_page_size));
+
+            const uint8_t* const flash = reinterpret_cast<const uint8_t*>(flash_address);
+
+            for(int32_t index = 0; index < buffer.size(); ++index)
+            {
+                buffer[index] = flash[index];
+            }
+        }
+
+        static constexpr int32_t get_page_size()
+        {
+            return m_page_size;
+        }
+
+        static constexpr int32_t get_sector_size()
+        {
+            return m_page_size * m_pages_per_sector;
+        }
+
+        static constexpr int32_t get_sector_count()
+        {
+            return m_page_count / m_pages_per_sector;
+        }
+
         // Read a FAIM word (the manual calls it FAIIM page)
         static bool read_faim_word(const int32_t faim_word, const uint32_t& faim_value)
         {
@@ -184,10 +279,10 @@ class Iap
             uint32_t result[5];
             uint32_t command[5] {      static_cast<uint32_t>(CommandCode::READ_FAIM_WORD),
                                        static_cast<uint32_t>(faim_word),
-                                  reinterpret_cast<uint32_t>(&faim_value)
+                                       static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&faim_value))
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             return (static_cast<StatusCode>(result[0]) == StatusCode::CMD_SUCCESS);
         }
@@ -210,10 +305,10 @@ class Iap
             uint32_t result[5];
             uint32_t command[5] {      static_cast<uint32_t>(CommandCode::WRITE_FAIM_WORD),
                                        static_cast<uint32_t>(faim_word),
-                                  reinterpret_cast<uint32_t>(&faim_value)
+                                       static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&faim_value))
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             if(static_cast<StatusCode>(result[0]) != StatusCode::CMD_SUCCESS)
             {
@@ -231,6 +326,42 @@ class Iap
             return (faim_value == faim_read_value);
         }
 
+        // Keep an interrupt running while IAP commands are executed (the flash
+        // can't be read while it is being erased / programmed). During the IAP
+        // commands the vector table is moved to RAM and the interrupts not
+        // selected here are disabled, so the selected IRQ handlers (and all
+        // the functions they call) must be placed in RAM.
+        // NOTE: Define XARMLIB_ENABLE_IAP_RAM_IRQS to place the library USART
+        //       and timer IRQ handlers in RAM and include 'lpc84x_ram_irqs.ld'
+        //       in the MCU linker script (it places the delegate trampolines
+        //       in RAM, see 'lpc845.ld'). The user handlers must be
+        //       non-template functions using the __RAMFUNC(RAM) section macro
+        //       (GCC ignores section attributes on templates). Constant data
+        //       read by the handlers (.rodata, switch lookup tables) and the
+        //       libgcc helpers they call (e.g. divisions) are in flash, so
+        //       they must be avoided or placed in RAM as well.
+        //       The SysTick interrupt is disabled during the IAP commands.
+        static void enable_ram_irq(const IRQn_Type irq)
+        {
+            assert(irq >= 0);
+
+            m_ram_irq_mask |= (1UL << irq);
+        }
+
+        static void disable_ram_irq(const IRQn_Type irq)
+        {
+            assert(irq >= 0);
+
+            m_ram_irq_mask &= ~(1UL << irq);
+        }
+
+        static bool is_enabled_ram_irq(const IRQn_Type irq)
+        {
+            assert(irq >= 0);
+
+            return (m_ram_irq_mask & (1UL << irq)) != 0;
+        }
+
     private:
 
         // --------------------------------------------------------------------
@@ -249,6 +380,161 @@ class Iap
             return (flash_address >> 6);        // 64B page (0x40 each)
         }
 
+        // Check if a flash page already holds the supplied data
+        static bool is_flash_page_equal(const int32_t flash_page, const gsl::span<const uint8_t> buffer)
+        {
+            const uint8_t* const flash = reinterpret_cast<const uint8_t*>(flash_page * m_page_size);
+
+            for(int32_t index = 0; index < m_page_size; ++index)
+            {
+                if(flash[index] != buffer[index])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Erase and write a run of consecutive flash pages
+        // NOTE: Buffer size must be multiple of 64 bytes (page size).
+        static bool write_flash_pages(const int32_t first_page, const gsl::span<const uint8_t> buffer)
+        {
+            const int32_t last_page = first_page + static_cast<int32_t>(buffer.size() / m_page_size) - 1;
+
+            if(erase_flash_pages(first_page, last_page) == false)
+            {
+                return false;
+            }
+
+            return copy_to_flash(first_page * m_page_size, buffer);
+        }
+
+        // Copy a buffer to erased flash pages with the largest allowed copy sizes
+        // NOTE: Buffer size must be multiple of 64 bytes (page size).
+        static bool copy_to_flash(const int32_t first_address, const gsl::span<const uint8_t> buffer)
+        {
+            for(int32_t offset = 0; offset < buffer.size(); )
+            {
+                const int32_t flash_address = first_address + offset;
+                const int32_t remaining     = static_cast<int32_t>(buffer.size()) - offset;
+
+                // Use the largest copy size that fits the remaining data and is
+                // aligned to the destination address (never crosses a sector)
+                int32_t count = m_max_copy_size;
+
+                while(count > m_page_size && (count > remaining || (flash_address % count) != 0))
+                {
+                    count /= 2;
+                }
+
+                // Prepare sector for writing
+                if(prepare_sectors(get_sector(flash_address), get_sector(flash_address)) != StatusCode::CMD_SUCCESS)
+                {
+                    return false;
+                }
+
+                // Write to flash
+                if(copy_ram_to_flash(flash_address, buffer.subspan(offset, count)) != StatusCode::CMD_SUCCESS)
+                {
+                    return false;
+                }
+
+                offset += count;
+            }
+
+            return true;
+        }
+
+        // Erase a range of flash pages (whole sectors are erased with a single sector erase)
+        static bool erase_flash_pages(const int32_t first_page, const int32_t last_page)
+        {
+            int32_t page = first_page;
+
+            while(page <= last_page)
+            {
+                const int32_t sector           = get_sector(page * m_page_size);
+                const int32_t sector_last_page = (sector + 1) * m_pages_per_sector - 1;
+
+                if((page % m_pages_per_sector) == 0 && sector_last_page <= last_page)
+                {
+                    // Erase all the whole sectors of the range at once
+                    const int32_t sector_end = get_sector((last_page + 1) * m_page_size) - 1;
+
+                    if(prepare_sectors(sector, sector_end) != StatusCode::CMD_SUCCESS)
+                    {
+                        return false;
+                    }
+
+                    if(erase_sectors(sector, sector_end) != StatusCode::CMD_SUCCESS)
+                    {
+                        return false;
+                    }
+
+                    page = (sector_end + 1) * m_pages_per_sector;
+                }
+                else
+                {
+                    // Erase the pages of a partial sector
+                    const int32_t page_end = (sector_last_page < last_page) ? sector_last_page : last_page;
+
+                    if(prepare_sectors(sector, sector) != StatusCode::CMD_SUCCESS)
+                    {
+                        return false;
+                    }
+
+                    if(erase_pages(page, page_end) != StatusCode::CMD_SUCCESS)
+                    {
+                        return false;
+                    }
+
+                    page = page_end + 1;
+                }
+            }
+
+            return true;
+        }
+
+        // Call the IAP ROM routine keeping the RAM interrupts (if any) running
+        static void execute_command(uint32_t* const command, uint32_t* const result)
+        {
+            if(m_ram_irq_mask == 0)
+            {
+                iap_entry(command, result);
+                return;
+            }
+
+            const bool vector_table_in_ram = VectorTable::is_in_ram();
+
+            // Disable the interrupts that have handlers in flash
+            const uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            const uint32_t enabled_irqs = NVIC->ISER[0];
+            NVIC->ICER[0] = enabled_irqs & ~m_ram_irq_mask;
+
+            const uint32_t systick_irq = SysTick->CTRL & SysTick_CTRL_TICKINT_Msk;
+            SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+
+            VectorTable::relocate_to_ram();
+
+            __set_PRIMASK(primask);
+
+            iap_entry(command, result);
+
+            __disable_irq();
+
+            if(vector_table_in_ram == false)
+            {
+                VectorTable::relocate_to_flash();
+            }
+
+            SysTick->CTRL |= systick_irq;
+            NVIC->ISER[0] = enabled_irqs & ~m_ram_irq_mask;
+
+            __set_PRIMASK(primask);
+        }
+
         // Prepare flash sector(s) for erase / writing
         static StatusCode prepare_sectors(const int32_t sector_start, const int32_t sector_end)
         {
@@ -258,7 +544,7 @@ class Iap
                                   static_cast<uint32_t>(sector_end)
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             return static_cast<StatusCode>(result[0]);
         }
@@ -273,7 +559,7 @@ class Iap
                                   SystemCoreClock / 1000    // CPU Clock Frequency in kHz
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             return static_cast<StatusCode>(result[0]);
         }
@@ -288,7 +574,7 @@ class Iap
                                   SystemCoreClock / 1000    // CPU Clock Frequency in kHz
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             return static_cast<StatusCode>(result[0]);
         }
@@ -300,12 +586,12 @@ class Iap
             uint32_t result[5];
             uint32_t command[5] {      static_cast<uint32_t>(CommandCode::COPY_RAM_TO_FLASH),
                                        static_cast<uint32_t>(flash_address),
-                                  reinterpret_cast<uint32_t>(&buffer[0]),
+                                       static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&buffer[0])),
                                        static_cast<uint32_t>(buffer.size()),
                                   SystemCoreClock / 1000    // CPU Clock Frequency in kHz
                                 };
 
-            iap_entry(command, result);
+            execute_command(command, result);
 
             return static_cast<StatusCode>(result[0]);
         }
@@ -320,6 +606,10 @@ class Iap
         static constexpr int32_t m_page_count = 1024; //1024 pages * 64 bytes
         // Flash page size is 64 bytes
         static constexpr int32_t m_page_size = 64;
+        // Flash sector size is 1024 bytes (16 pages)
+        static constexpr int32_t m_pages_per_sector = 16;
+        // Maximum byte count of a single copy RAM to flash command
+        static constexpr int32_t m_max_copy_size = 1024;
 
         // Command codes for IAP
         enum class CommandCode
@@ -338,6 +628,12 @@ class Iap
             READ_FAIM_WORD     = 80,
             WRITE_FAIM_WORD    = 81
         };
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        static uint32_t m_ram_irq_mask;     // Interrupts kept running during IAP commands
 };
 
 
@@ -0,0 +1,484 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_pin_interrupt.hpp
+// @brief   NXP LPC84x pin interrupt (PINT) and pattern match class.
+// @date    7 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_PIN_INTERRUPT_HPP
+#define __XARMLIB_TARGETS_LPC84X_PIN_INTERRUPT_HPP
+
+#include "system/cassert"
+#include "system/delegate"
+#include "targets/peripheral_ref_counter.hpp"
+#include "targets/LPC84x/lpc84x_cmsis.hpp"
+#include "targets/LPC84x/lpc84x_pin.hpp"
+#include "targets/LPC84x/lpc84x_syscon_clock.hpp"
+#include "targets/LPC84x/lpc84x_syscon_power.hpp"
+
+
+
+
+// Forward declaration of IRQ handlers
+extern "C" void PININT0_IRQHandler(void);
+extern "C" void PININT1_IRQHandler(void);
+extern "C" void PININT2_IRQHandler(void);
+extern "C" void PININT3_IRQHandler(void);
+extern "C" void PININT4_IRQHandler(void);
+extern "C" void PININT5_DAC1_IRQHandler(void);   // Pin Interrupt 5 / DAC1 shared handler
+extern "C" void PININT6_USART3_IRQHandler(void); // Pin Interrupt 6 / USART3 shared handler
+extern "C" void PININT7_USART4_IRQHandler(void); // Pin Interrupt 7 / USART4 shared handler
+
+
+
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// Number of available pin interrupt channels
+static constexpr std::size_t PIN_INTERRUPT_COUNT { 8 };
+
+class PinInterrupt : private PeripheralRefCounter<PinInterrupt, PIN_INTERRUPT_COUNT>
+{
+        // --------------------------------------------------------------------
+        // FRIEND FUNCTIONS DECLARATIONS
+        // --------------------------------------------------------------------
+
+        // Friend IRQ handler C functions to give access to private IRQ handler member function
+        friend void ::PININT0_IRQHandler(void);
+        friend void ::PININT1_IRQHandler(void);
+        friend void ::PININT2_IRQHandler(void);
+        friend void ::PININT3_IRQHandler(void);
+        friend void ::PININT4_IRQHandler(void);
+        friend void ::PININT5_DAC1_IRQHandler(void);   // Pin Interrupt 5 / DAC1 shared handler
+        friend void ::PININT6_USART3_IRQHandler(void); // Pin Interrupt 6 / USART3 shared handler
+        friend void ::PININT7_USART4_IRQHandler(void); // Pin Interrupt 7 / USART4 shared handler
+
+    protected:
+
+        // --------------------------------------------------------------------
+        // PROTECTED DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Base class alias
+        using PeripheralPinInterrupt = PeripheralRefCounter<PinInterrupt, PIN_INTERRUPT_COUNT>;
+
+        // Pin interrupt channels
+        // NOTE: Channels 5, 6 and 7 share their IRQ with DAC1, USART3 and USART4.
+        enum class Channel
+        {
+            CH0 = 0,
+            CH1,
+            CH2,
+            CH3,
+            CH4,
+            CH5,    // Shared with DAC1
+            CH6,    // Shared with USART3
+            CH7     // Shared with USART4
+        };
+
+        // Interrupt trigger selection
+        enum class Mode
+        {
+            EDGE_RISING = 0,
+            EDGE_FALLING,
+            EDGE_BOTH,
+            LEVEL_LOW,
+            LEVEL_HIGH
+        };
+
+        // Pattern match bit slice configuration (defined to map the PMCFG CFGn field directly)
+        enum class SliceConfig
+        {
+            CONSTANT_HIGH = 0,          // Always true (slice disabled in the product term)
+            STICKY_RISING,              // Sticky rising edge
+            STICKY_FALLING,             // Sticky falling edge
+            STICKY_RISING_FALLING,      // Sticky rising or falling edge
+            HIGH_LEVEL,                 // Input high level
+            LOW_LEVEL,                  // Input low level
+            CONSTANT_LOW,               // Always false (product term never true)
+            EVENT                       // Non-sticky rising or falling edge (one clock pulse)
+        };
+
+        // Number of pattern match bit slices
+        static constexpr std::size_t SLICE_COUNT { 8 };
+
+        // IRQ handlers definition
+        using IrqHandlerType = int32_t();
+        using IrqHandler     = Delegate<IrqHandlerType>;
+
+        // --------------------------------------------------------------------
+        // PROTECTED MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // -------- CONSTRUCTORS / DESTRUCTOR ---------------------------------
+
+        // Use the first available channel
+        PinInterrupt(const Pin::Name pin_name, const Mode mode) : PeripheralPinInterrupt(*this)
+        {
+            initialize(pin_name, mode);
+        }
+
+        // Use a specific channel (e.g. to avoid the shared IRQs or to select a pattern match input)
+        PinInterrupt(const Channel channel, const Pin::Name pin_name, const Mode mode) : PeripheralPinInterrupt(*this, static_cast<std::size_t>(channel))
+        {
+            initialize(pin_name, mode);
+        }
+
+        ~PinInterrupt()
+        {
+            const uint32_t channel_mask = get_channel_mask();
+
+            LPC_PIN_INT->CIENR = channel_mask;
+            LPC_PIN_INT->CIENF = channel_mask;
+
+            clear_pending_irq();
+
+            // Shared IRQs are left enabled for the other peripheral
+            if(get_index() < static_cast<std::size_t>(Channel::CH5))
+            {
+                NVIC_DisableIRQ(get_irqn());
+            }
+
+            // Disable pin interrupts if this the last channel deleted
+            if(get_used() == 1)
+            {
+                Clock::disable(Clock::Peripheral::GPIOINT);
+            }
+        }
+
+        // -------- CONFIGURATION ---------------------------------------------
+
+        Channel get_channel() const
+        {
+            return static_cast<Channel>(get_index());
+        }
+
+        void set_mode(const Mode mode)
+        {
+            const uint32_t channel_mask = get_channel_mask();
+
+            // Disable the interrupt while it is being reconfigured
+            LPC_PIN_INT->CIENR = channel_mask;
+            LPC_PIN_INT->CIENF = channel_mask;
+
+            if(mode == Mode::LEVEL_LOW || mode == Mode::LEVEL_HIGH)
+            {
+                LPC_PIN_INT->ISEL |= channel_mask;
+            }
+            else
+            {
+                LPC_PIN_INT->ISEL &= ~channel_mask;
+
+                // Discard edges detected with the previous configuration
+                LPC_PIN_INT->IST = channel_mask;
+            }
+
+            m_mode = mode;
+        }
+
+        // -------- EDGE DETECTION --------------------------------------------
+
+        bool is_rising_edge_detected() const
+        {
+            return ((LPC_PIN_INT->RISE & get_channel_mask()) != 0);
+        }
+
+        bool is_falling_edge_detected() const
+        {
+            return ((LPC_PIN_INT->FALL & get_channel_mask()) != 0);
+        }
+
+        // -------- INTERRUPTS ------------------------------------------------
+
+        void enable_irq()
+        {
+            const uint32_t channel_mask = get_channel_mask();
+
+            switch(m_mode)
+            {
+                case Mode::EDGE_RISING:  LPC_PIN_INT->SIENR = channel_mask;                                    break;
+                case Mode::EDGE_FALLING: LPC_PIN_INT->SIENF = channel_mask;                                    break;
+                case Mode::EDGE_BOTH:    LPC_PIN_INT->SIENR = channel_mask; LPC_PIN_INT->SIENF = channel_mask; break;
+                // NOTE: In level mode IENR enables the interrupt and IENF selects the active level
+                case Mode::LEVEL_LOW:    LPC_PIN_INT->CIENF = channel_mask; LPC_PIN_INT->SIENR = channel_mask; break;
+                case Mode::LEVEL_HIGH:   LPC_PIN_INT->SIENF = channel_mask; LPC_PIN_INT->SIENR = channel_mask; break;
+            }
+
+            NVIC_EnableIRQ(get_irqn());
+        }
+
+        void disable_irq()
+        {
+            // NOTE: Only the channel is disabled. The NVIC IRQ is kept
+            //       enabled because it may be shared with other peripherals.
+            LPC_PIN_INT->CIENR = get_channel_mask();
+
+            if(m_mode != Mode::LEVEL_LOW && m_mode != Mode::LEVEL_HIGH)
+            {
+                LPC_PIN_INT->CIENF = get_channel_mask();
+            }
+        }
+
+        bool is_enabled_irq() const
+        {
+            const uint32_t channel_mask = get_channel_mask();
+
+            if(m_mode == Mode::LEVEL_LOW || m_mode == Mode::LEVEL_HIGH)
+            {
+                return ((LPC_PIN_INT->IENR & channel_mask) != 0);
+            }
+
+            return (((LPC_PIN_INT->IENR | LPC_PIN_INT->IENF) & channel_mask) != 0);
+        }
+
+        bool is_pending_irq() const
+        {
+            return ((LPC_PIN_INT->IST & get_channel_mask()) != 0);
+        }
+
+        // Clear the detected edges (edge mode only)
+        // NOTE: In level mode writing to IST toggles the active level, so the
+        //       interrupt must be disabled (or the level removed) instead.
+        void clear_pending_irq()
+        {
+            if(m_mode != Mode::LEVEL_LOW && m_mode != Mode::LEVEL_HIGH)
+            {
+                LPC_PIN_INT->IST = get_channel_mask();
+            }
+        }
+
+        void set_irq_priority(const int32_t irq_priority)
+        {
+            NVIC_SetPriority(get_irqn(), irq_priority);
+        }
+
+        void assign_irq_handler(const IrqHandler& irq_handler)
+        {
+            assert(irq_handler != nullptr);
+
+            m_irq_handler = irq_handler;
+        }
+
+        void remove_irq_handler()
+        {
+            m_irq_handler = nullptr;
+        }
+
+        // -------- PATTERN MATCH ENGINE --------------------------------------
+
+        // Configure a pattern match bit slice. The slice input is one of the
+        // pin interrupt channels. A slice marked as endpoint terminates a
+        // product term (minterm) and, when the term is true, requests the pin
+        // interrupt with the same number as the slice (slice 7 is always an
+        // endpoint). The boolean result is the OR of all the product terms.
+        // NOTE: Writing the configuration clears all the sticky edge detections.
+        static void set_pattern_slice(const std::size_t   slice,
+                                      const Channel       input,
+                                      const SliceConfig   config,
+                                      const bool          endpoint)
+        {
+            assert(slice < SLICE_COUNT);
+
+            const uint32_t src_shift = PMSRC_SRC_SHIFT + 3 * slice;
+            const uint32_t cfg_shift = PMCFG_CFG_SHIFT + 3 * slice;
+
+            LPC_PIN_INT->PMSRC = (LPC_PIN_INT->PMSRC & ~(PMSRC_SRC_MASK << src_shift)) | (static_cast<uint32_t>(input) << src_shift);
+
+            uint32_t pmcfg = (LPC_PIN_INT->PMCFG & ~(PMCFG_CFG_MASK << cfg_shift)) | (static_cast<uint32_t>(config) << cfg_shift);
+
+            if(slice < SLICE_COUNT - 1)
+            {
+                if(endpoint == true)
+                {
+                    pmcfg |= (1UL << slice);
+                }
+                else
+                {
+                    pmcfg &= ~(1UL << slice);
+                }
+            }
+
+            LPC_PIN_INT->PMCFG = pmcfg;
+        }
+
+        // Route the pin interrupts through the pattern match engine
+        // (optionally also drive the RXEV output to wake the core from WFE)
+        static void enable_pattern_match(const bool enable_rxev = false)
+        {
+            LPC_PIN_INT->PMCTRL = (LPC_PIN_INT->PMCTRL & ~(PMCTRL_SEL_PMATCH | PMCTRL_ENA_RXEV))
+                                | PMCTRL_SEL_PMATCH
+                                | (enable_rxev ? PMCTRL_ENA_RXEV : 0);
+        }
+
+        // Route the pin interrupts directly from the pins
+        static void disable_pattern_match()
+        {
+            LPC_PIN_INT->PMCTRL &= ~(PMCTRL_SEL_PMATCH | PMCTRL_ENA_RXEV);
+        }
+
+        static bool is_enabled_pattern_match()
+        {
+            return ((LPC_PIN_INT->PMCTRL & PMCTRL_SEL_PMATCH) != 0);
+        }
+
+        // Get the current state of the product terms (bit n set if the term ending in slice n is true)
+        static uint32_t get_pattern_match_state()
+        {
+            return (LPC_PIN_INT->PMCTRL >> PMCTRL_PMAT_SHIFT) & 0xFF;
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Pattern Match Interrupt Control Register (PMCTRL) bits
+        enum PMCTRL : uint32_t
+        {
+            PMCTRL_SEL_PMATCH   = (1 << 0),
+            PMCTRL_ENA_RXEV     = (1 << 1),
+            PMCTRL_PMAT_SHIFT   = 24
+        };
+
+        // Pattern Match Interrupt Bit-Slice Source Register (PMSRC) fields
+        enum PMSRC : uint32_t
+        {
+            PMSRC_SRC_SHIFT     = 8,
+            PMSRC_SRC_MASK      = 0x07
+        };
+
+        // Pattern Match Interrupt Bit Slice Configuration Register (PMCFG) fields
+        enum PMCFG : uint32_t
+        {
+            PMCFG_CFG_SHIFT     = 8,
+            PMCFG_CFG_MASK      = 0x07
+        };
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        void initialize(const Pin::Name pin_name, const Mode mode)
+        {
+            assert(pin_name != Pin::Name::NC);
+
+            // Enable pin interrupts if this is the first channel created
+            if(get_used() == 1)
+            {
+                Clock::enable(Clock::Peripheral::GPIOINT);
+                Power::reset(Power::ResetPeripheral::GPIOINT);
+            }
+
+            // Select the pin as the channel input
+            LPC_SYSCON->PINTSEL[get_index()] = static_cast<uint32_t>(pin_name);
+
+            set_mode(mode);
+        }
+
+        uint32_t get_channel_mask() const
+        {
+            return (1UL << get_index());
+        }
+
+        IRQn_Type get_irqn() const
+        {
+            return static_cast<IRQn_Type>(PININT0_IRQn + get_index());
+        }
+
+        // Check if the channel requested the (possibly shared) IRQ
+        // NOTE: With PMCTRL SEL_PMATCH set the pin interrupts are driven by
+        //       the pattern matches instead of the standard pin interrupt
+        //       function, so the IST flags are not set. A dedicated IRQ is
+        //       only requested by its product term; on the shared IRQs
+        //       (channels 5, 6 and 7) the current product term state is
+        //       checked instead (an EVENT slice pulse can't be detected).
+        bool is_requesting_irq() const
+        {
+            if(is_enabled_pattern_match() == true)
+            {
+                return get_index() < static_cast<std::size_t>(Channel::CH5)
+                    || (get_pattern_match_state() & get_channel_mask()) != 0;
+            }
+
+            return is_pending_irq();
+        }
+
+        // IRQ handler called directly by the interrupt C functions
+        // NOTE: Returns yield flag for FreeRTOS. The request is checked
+        //       because channels 5, 6 and 7 share their IRQ.
+        // NOTE: With the pattern match engine selected, the IRQ handler must
+        //       remove the matched pattern (e.g. re-write the slice with
+        //       set_pattern_slice() to clear a sticky edge), otherwise the
+        //       product term keeps requesting the interrupt.
+        inline __attribute__((always_inline))
+        static int32_t irq_handler(const Channel channel)
+        {
+            auto* const pin_interrupt = get_pointer(static_cast<std::size_t>(channel));
+
+            int32_t yield = 0;  // Used by FreeRTOS
+
+            if(pin_interrupt != nullptr && pin_interrupt->is_requesting_irq() == true)
+            {
+                if(is_enabled_pattern_match() == false)
+                {
+                    pin_interrupt->clear_pending_irq();
+                }
+
+                if(pin_interrupt->m_irq_handler != nullptr)
+                {
+                    yield = pin_interrupt->m_irq_handler();
+                }
+            }
+
+            return yield;
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        Mode       m_mode { Mode::EDGE_RISING };    // Interrupt trigger mode
+        IrqHandler m_irq_handler;                   // User defined IRQ handler
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_PIN_INTERRUPT_HPP
@@ -151,6 +151,33 @@ class Port
         {
             LPC_GPIO->MPIN[static_cast<std::size_t>(port)] = value;
         }
+
+        // Write only the pins selected by the supplied mask. All the selected
+        // pins change on the same MPIN store (glitch-free parallel output).
+        // NOTE: The port MASK register is left loaded with the inverted mask.
+        static void write_masked(const Name port, const uint32_t mask, const uint32_t value)
+        {
+            LPC_GPIO->MASK[static_cast<std::size_t>(port)] = ~mask;
+            LPC_GPIO->MPIN[static_cast<std::size_t>(port)] = value;
+        }
+
+        // Set the pins selected by the supplied mask (ones in the mask)
+        static void set(const Name port, const uint32_t mask)
+        {
+            LPC_GPIO->SET[static_cast<std::size_t>(port)] = mask;
+        }
+
+        // Clear the pins selected by the supplied mask (ones in the mask)
+        static void clear(const Name port, const uint32_t mask)
+        {
+            LPC_GPIO->CLR[static_cast<std::size_t>(port)] = mask;
+        }
+
+        // Toggle the pins selected by the supplied mask (ones in the mask)
+        static void toggle(const Name port, const uint32_t mask)
+        {
+            LPC_GPIO->NOT[static_cast<std::size_t>(port)] = mask;
+        }
 };
 
 
@@ -314,6 +314,48 @@ class Spi : private PeripheralRefCounter<Spi, SPI_COUNT>
             m_spi->TXDAT = value & 0x0000FFFF;
         }
 
+        // Write data to be transmitted as the last frame of a transfer (slave select is deasserted after it)
+        // NOTE: Data and control are written simultaneously (TXDATCTL). The end of transfer
+        //       control is kept for the following frames until cleared.
+        void write_data_end_of_transfer(const uint32_t value)
+        {
+            m_spi->TXDATCTL = get_data_control_end_of_transfer(value);
+        }
+
+        // Get the TXDATCTL word that writes data as the last frame of a transfer
+        // (current control bits plus end of transfer)
+        uint32_t get_data_control_end_of_transfer(const uint32_t value) const
+        {
+            return (m_spi->TXCTL & TXCTL_CONTROL_BITMASK) | TXCTL_EOT | (value & 0x0000FFFF);
+        }
+
+        // Clear the end of transfer control bit for the next written data
+        void clear_end_of_transfer()
+        {
+            m_spi->TXCTL &= ~TXCTL_EOT;
+        }
+
+        // Set or clear the receive ignore control bit for the next written data
+        // NOTE: When set, received data is discarded and the transmitter does
+        //       not wait for RXDAT to be read (write only transfers).
+        void set_rx_ignore(const bool rx_ignore)
+        {
+            m_spi->TXCTL = (rx_ignore == true) ? (m_spi->TXCTL | TXCTL_RXIGNORE) : (m_spi->TXCTL & ~TXCTL_RXIGNORE);
+        }
+
+        // -------- DMA -------------------------------------------------------
+
+        // DMA channels hardwired to the receiver / transmitter requests
+        std::size_t get_dma_rx_channel() const { return 10 + get_index() * 2; }
+        std::size_t get_dma_tx_channel() const { return 11 + get_index() * 2; }
+
+        // Data registers addresses (DMA source / destination)
+        const volatile void* get_rx_data_address() const { return &m_spi->RXDAT; }
+        volatile void*       get_tx_data_address()       { return &m_spi->TXDAT; }
+
+        // Data and control register address (DMA destination of the last frame of a transfer)
+        volatile void*       get_tx_data_control_address() { return &m_spi->TXDATCTL; }
+
         // -------- ENABLE / DISABLE ------------------------------------------
 
         // Enable peripheral
@@ -469,6 +511,15 @@ class Spi : private PeripheralRefCounter<Spi, SPI_COUNT>
             STAT_MSTIDLE     = (1 << 8)     // Master idle status flag
         };
 
+        // SPI Transmitter Control Register (TXCTL) bits
+        enum TXCTL : uint32_t
+        {
+            TXCTL_EOT             = (1 << 20),      // End of Transfer (slave select is deasserted after the frame)
+            TXCTL_EOF             = (1 << 21),      // End of Frame (frame delay is inserted after the frame)
+            TXCTL_RXIGNORE        = (1 << 22),      // Receive Ignore (received data is ignored)
+            TXCTL_CONTROL_BITMASK = 0x0F7F0000      // TXSSELn, EOT, EOF, RXIGNORE and LEN control bits
+        };
+
         // SPI Interrupt Enable get, set and clear bits (defined to map INTENSET and INTENCLR registers directly)
         enum INTEN : uint32_t
         {
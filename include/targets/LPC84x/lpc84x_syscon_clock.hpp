@@ -690,6 +690,19 @@ class Clock
             }
         }
 
+        // Get clock fractional divider numerator (MULT)
+        static uint8_t get_frg_clock_mult(const FrgClockSelect frg)
+        {
+            if(frg == FrgClockSelect::FRG0)
+            {
+                return static_cast<uint8_t>(LPC_SYSCON->FRG0MULT & 0xFF);
+            }
+            else
+            {
+                return static_cast<uint8_t>(LPC_SYSCON->FRG1MULT & 0xFF);
+            }
+        }
+
         // Get clock input frequency
         static int32_t get_frg_clock_in_frequency(const FrgClockSelect frg)
         {
@@ -35,6 +35,7 @@
 #include "system/cassert"
 #include "system/chrono"
 #include "system/delegate"
+#include "system/tick_converter"
 #include "targets/peripheral_ref_counter.hpp"
 #include "targets/LPC84x/lpc84x_cmsis.hpp"
 #include "targets/LPC84x/lpc84x_syscon_clock.hpp"
@@ -71,6 +72,9 @@ class Timer : private PeripheralRefCounter<Timer, TIMER_COUNT>
         // Friend IRQ handler C function to give access to private IRQ handler member function
         friend void ::MRT_IRQHandler(void);
 
+        // Friend CMSIS C function to give access to the private tick converter update
+        friend void ::SystemCoreClockUpdate(void);
+
     protected:
 
         // --------------------------------------------------------------------
@@ -139,7 +143,7 @@ class Timer : private PeripheralRefCounter<Timer, TIMER_COUNT>
             assert(rate_us.count() >= get_min_rate_us());
             assert(rate_us.count() <= get_max_rate_us());
 
-            m_interval = convert_us_to_interval(rate_us.count());
+            m_interval = convert_us_to_interval(rate_us);
 
             set_mode(mode);
             set_interval(m_interval);
@@ -165,6 +169,24 @@ class Timer : private PeripheralRefCounter<Timer, TIMER_COUNT>
             return ((m_channel->STAT & STAT_RUN) != 0);
         }
 
+        // -------- RATE LIMITS -----------------------------------------------
+
+        // Get the minimum allowed rate in microseconds
+        static int64_t get_min_rate_us()
+        {
+            const uint32_t min_interval = 0x01;
+
+            return get_tick_converter().to_duration(min_interval).count();
+        }
+
+        // Get the maximum allowed rate in microseconds
+        static int64_t get_max_rate_us()
+        {
+            const uint32_t max_interval = 0x7FFFFFFF;
+
+            return get_tick_converter().to_duration(max_interval).count();
+        }
+
         // -------- INTERRUPTS ------------------------------------------------
 
         void enable_irq()
@@ -255,26 +277,34 @@ class Timer : private PeripheralRefCounter<Timer, TIMER_COUNT>
             m_channel->INTVAL = timer_interval | INTVAL_LOAD;
         }
 
-        // Get timer interval value (ready to load into INTVAL register) based on supplied rate in microseconds
-        static uint32_t convert_us_to_interval(const int64_t rate_us)
+        // Get the microseconds / timer ticks converter of the current system clock
+        // NOTE: Read only (safe from any context). Updated by SystemCoreClockUpdate().
+        static const TickConverter& get_tick_converter()
         {
-            return static_cast<uint32_t>(SystemCoreClock * rate_us / 1000000UL);
+            assert(m_tick_converter.get_frequency() == SystemCoreClock);
+
+            return m_tick_converter;
         }
 
-        // Get the minimum allowed rate in microseconds
-        static int64_t get_min_rate_us()
+        // Compute the converter ratios (the only divisions) of the current system clock
+        // NOTE: Called by SystemCoreClockUpdate() when the system clock frequency changes.
+        //       Written with the interrupts disabled so an IRQ handler never reads a torn ratio.
+        static void update_tick_converter()
         {
-            const int64_t min_interval = 0x01;
+            const TickConverter tick_converter(SystemCoreClock);
+
+            const uint32_t primask = __get_PRIMASK();
+            __disable_irq();
 
-            return (min_interval * 1000000UL / SystemCoreClock);
+            m_tick_converter = tick_converter;
+
+            __set_PRIMASK(primask);
         }
 
-        // Get the maximum allowed rate in microseconds
-        static int64_t get_max_rate_us()
+        // Get timer interval value (ready to load into INTVAL register) based on supplied rate in microseconds
+        static uint32_t convert_us_to_interval(const std::chrono::microseconds& rate_us)
         {
-            const int64_t max_interval = 0x7FFFFFFF;
-
-            return (max_interval * 1000000UL / SystemCoreClock);
+            return static_cast<uint32_t>(get_tick_converter().to_ticks(rate_us));
         }
 
         // IRQ handler for all channels
@@ -313,6 +343,8 @@ class Timer : private PeripheralRefCounter<Timer, TIMER_COUNT>
         uint32_t           m_interval { 0 };        // Last loaded interval value
 
         IrqHandler         m_irq_handler;           // User defined IRQ handler
+
+        static TickConverter m_tick_converter;      // Converter of the last used system clock
 };
 
 
@@ -33,9 +33,19 @@
 #define __XARMLIB_TARGETS_LPC84X_US_TICKER_HPP
 
 #include "system/chrono"
+#include "targets/LPC84x/lpc84x_cmsis.hpp"
 #include "targets/LPC84x/lpc84x_syscon_clock.hpp"
 #include "targets/LPC84x/lpc84x_syscon_power.hpp"
 
+
+
+
+// Forward declaration of IRQ handler
+extern "C" void SCT_IRQHandler(void);
+
+
+
+
 namespace xarmlib
 {
 namespace targets
@@ -46,34 +56,84 @@ namespace lpc84x
 
 
 
+// Forward declaration of the startup hook that initializes the ticker
+extern "C" void mcu_startup_initialize_hardware();
+
+
+
+
+// NOTE: 64-bit microseconds ticker. The 32-bit SCT counter is extended
+//       by counting its overflows (SCT event 0 is reserved for that).
 class UsTicker
 {
+        // --------------------------------------------------------------------
+        // FRIEND FUNCTIONS DECLARATIONS
+        // --------------------------------------------------------------------
+
+        // Friend IRQ handler C function to give access to private IRQ handler member function
+        friend void ::SCT_IRQHandler(void);
+
+        // Friend startup hook C function to give access to private initialization member function
+        friend void mcu_startup_initialize_hardware();
+
     protected:
 
         // --------------------------------------------------------------------
         // PROTECTED MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
+        // Read the current ticker value
+        // NOTE: Initialized on startup (no initialization check needed).
         static std::chrono::microseconds now()
         {
-            if(m_initialized == false)
+            uint32_t high;
+            uint32_t low;
+            bool     overflow_pending;
+
+            // Read again if the overflow IRQ handler ran in between
+            do
             {
-                initialize();
+                high             = m_high;
+                low              = LPC_SCT->COUNT;
+                overflow_pending = (LPC_SCT->EVFLAG & EVFLAG_OVERFLOW) != 0;
+            } while(high != m_high);
+
+            // The counter already wrapped around but the overflow IRQ handler
+            // didn't run yet (interrupts disabled or higher priority context)
+            if(overflow_pending == true && low < 0x80000000)
+            {
+                high++;
+            }
+            // The overflow event fires while the counter still holds its
+            // maximum value, so the IRQ handler may have already counted the
+            // wrap around that didn't happen yet
+            else if(overflow_pending == false && low == 0xFFFFFFFF)
+            {
+                high--;
             }
 
-            return std::chrono::microseconds(LPC_SCT->COUNT);
+            return std::chrono::microseconds((static_cast<int64_t>(high) << 32) | low);
         }
 
     private:
 
+        // --------------------------------------------------------------------
+        // PRIVATE DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // SCT Event Flag Register (EVFLAG) bits
+        enum EVFLAG : uint32_t
+        {
+            EVFLAG_OVERFLOW = (1 << 0)      // Event 0: counter reached its maximum value
+        };
+
         // --------------------------------------------------------------------
         // PRIVATE MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
+        // Called by the startup hook after the system clock is configured
         static void initialize()
         {
-            m_initialized = true;
-
             // Enable and reset the SCT clock
             Clock::enable(Clock::Peripheral::SCT);
             Power::reset(Power::ResetPeripheral::SCT);
@@ -87,15 +147,37 @@ class UsTicker
             // System Clock -> us_ticker 1MHz
             LPC_SCT->CTRL |= ((SystemCoreClock / 1000000 - 1) << 5);
 
+            // Overflow event: match 0 at the maximum counter value (the counter rolls over to 0)
+            // NOTE: the event (and IRQ) happens one tick before the wrap around (see now())
+            LPC_SCT->MATCH[0].U    = 0xFFFFFFFF;
+            LPC_SCT->MATCHREL[0].U = 0xFFFFFFFF;
+
+            LPC_SCT->EVENT[0].STATE = (1 << 0);     // Event happens in state 0
+            LPC_SCT->EVENT[0].CTRL  = (0 << 0)      // Match register 0
+                                    | (1 << 12);    // Match condition only
+
+            LPC_SCT->EVFLAG = EVFLAG_OVERFLOW;
+            LPC_SCT->EVEN   = EVFLAG_OVERFLOW;
+
+            NVIC_EnableIRQ(SCT_IRQn);
+
             // Unhalt the counter - clearing bit 2 of the CTRL register
             LPC_SCT->CTRL &= ~(1 << 2);
         }
 
+        // IRQ handler called directly by the interrupt C function
+        static void irq_handler()
+        {
+            LPC_SCT->EVFLAG = EVFLAG_OVERFLOW;
+
+            m_high = m_high + 1;
+        }
+
         // --------------------------------------------------------------------
         // PRIVATE MEMBER VARIABLES
         // --------------------------------------------------------------------
 
-        inline static bool m_initialized { false };
+        inline static volatile uint32_t m_high { 0 };   // Counter overflows (high word of the ticker)
 };
 
 
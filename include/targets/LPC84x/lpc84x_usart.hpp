@@ -1,6 +1,6 @@
 // ----------------------------------------------------------------------------
 // @file    lpc84x_usart.hpp
-// @brief   NXP LPC84x USART class (takes control of FRG0).
+// @brief   NXP LPC84x USART class (clocked by FRG0, FRG1 or the main clock).
 // @notes   Synchronous mode not implemented.
 // @date    21 June 2018
 // ----------------------------------------------------------------------------
@@ -33,8 +33,6 @@
 #ifndef __XARMLIB_TARGETS_LPC84X_USART_HPP
 #define __XARMLIB_TARGETS_LPC84X_USART_HPP
 
-#include <cmath>
-
 #include "system/bitmask"
 #include "system/delegate"
 #include "system/target"
@@ -198,6 +196,45 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
             ODD  = (3 << 4)     // USART odd parity select
         };
 
+        // USART clock source selection
+        // NOTE: The FRG multiplier is chosen by the baudrate solver unless the
+        //       FRG is also used by another USART (its multiplier is kept).
+        enum class ClockSource
+        {
+            FRG0 = 0,           // Fractional rate generator 0 (main clock input)
+            FRG1,               // Fractional rate generator 1 (main clock input)
+            MAIN_CLK            // Main clock (no fractional rate generator)
+        };
+
+        // Baudrate generator settings found by the baudrate solver
+        struct BaudrateSettings
+        {
+            int32_t frg_mult;       // FRG multiplier (clock * 256 / (256 + MULT))
+            int32_t oversampling;   // Clocks per bit (5 to 16)
+            int32_t brg_div;        // Baudrate generator divider (1 to 65536)
+            int32_t baudrate;       // Achieved baudrate
+            int32_t error_ppm;      // Achieved baudrate error (parts per million)
+        };
+
+        // RS-485 driver enable (RTS output) polarity selection (defined to map the CFG register directly)
+        enum class DriverEnablePolarity
+        {
+            ACTIVE_LOW  = (0 << 21),    // RTS is driven low while transmitting
+            ACTIVE_HIGH = (1 << 21)     // RTS is driven high while transmitting
+        };
+
+        // Complete USART configuration (format and baudrate) written in a single step
+        // NOTE: Can be precomputed at compile time with make_config() and cached.
+        struct Config
+        {
+            ClockSource      clock_source;      // Clock source the baudrate was solved for
+            int32_t          clock_freq;        // Clock source input frequency the baudrate was solved for
+            DataBits         data_bits;
+            StopBits         stop_bits;
+            Parity           parity;
+            BaudrateSettings baudrate_settings;
+        };
+
         // Type safe accessor to STAT register
         using Status        = private_usart::Status;
         using StatusBitmask = bitmask::bitmask<Status>;
@@ -216,18 +253,16 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 
         // -------- CONSTRUCTOR / DESTRUCTOR ----------------------------------
 
-        Usart(const Pin::Name txd,
-              const Pin::Name rxd,
-              const int32_t   baudrate,
-              const DataBits  data_bits,
-              const StopBits  stop_bits,
-              const Parity    parity) : PeripheralUsart(*this)
+        Usart(const Pin::Name   txd,
+              const Pin::Name   rxd,
+              const int32_t     baudrate,
+              const DataBits    data_bits,
+              const StopBits    stop_bits,
+              const Parity      parity,
+              const ClockSource clock_source) : PeripheralUsart(*this),
+                                                m_clock_source { clock_source }
         {
-            // Initialize and configure FRG0 if this is the first USART peripheral instantiation
-            if(get_used() == 1)
-            {
-                initialize_frg0();
-            }
+            const auto clock_source_select = get_peripheral_clock_source();
 
             const Name name = static_cast<Name>(get_index());
 
@@ -235,7 +270,7 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
             {
                 case Name::USART0: m_usart = LPC_USART0;
                                    Clock::set_peripheral_clock_source(Clock::PeripheralClockSelect::USART0,
-                                                                      Clock::PeripheralClockSource::FRG0_CLK);
+                                                                      clock_source_select);
                                    Clock::enable(Clock::Peripheral::USART0);
                                    Power::reset(Power::ResetPeripheral::USART0);
                                    Swm::assign(Swm::PinMovable::U0_RXD_I, rxd);
@@ -244,7 +279,7 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 
                 case Name::USART1: m_usart = LPC_USART1;
                                    Clock::set_peripheral_clock_source(Clock::PeripheralClockSelect::USART1,
-                                                                      Clock::PeripheralClockSource::FRG0_CLK);
+                                                                      clock_source_select);
                                    Clock::enable(Clock::Peripheral::USART1);
                                    Power::reset(Power::ResetPeripheral::USART1);
                                    Swm::assign(Swm::PinMovable::U1_RXD_I, rxd);
@@ -253,7 +288,7 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 #ifdef __LPC845__
                 case Name::USART2: m_usart = LPC_USART2;
                                    Clock::set_peripheral_clock_source(Clock::PeripheralClockSelect::USART2,
-                                                                      Clock::PeripheralClockSource::FRG0_CLK);
+                                                                      clock_source_select);
                                    Clock::enable(Clock::Peripheral::USART2);
                                    Power::reset(Power::ResetPeripheral::USART2);
                                    Swm::assign(Swm::PinMovable::U2_RXD_I, rxd);
@@ -262,7 +297,7 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 
                 case Name::USART3: m_usart = LPC_USART3;
                                    Clock::set_peripheral_clock_source(Clock::PeripheralClockSelect::USART3,
-                                                                      Clock::PeripheralClockSource::FRG0_CLK);
+                                                                      clock_source_select);
                                    Clock::enable(Clock::Peripheral::USART3);
                                    Power::reset(Power::ResetPeripheral::USART3);
                                    Swm::assign(Swm::PinMovable::U3_RXD_I, rxd);
@@ -271,7 +306,7 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 
                 case Name::USART4: m_usart = LPC_USART4;
                                    Clock::set_peripheral_clock_source(Clock::PeripheralClockSelect::USART4,
-                                                                      Clock::PeripheralClockSource::FRG0_CLK);
+                                                                      clock_source_select);
                                    Clock::enable(Clock::Peripheral::USART4);
                                    Power::reset(Power::ResetPeripheral::USART4);
                                    Swm::assign(Swm::PinMovable::U4_RXD_I, rxd);
@@ -329,118 +364,212 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
 
         void set_format(const DataBits data_bits, const StopBits stop_bits, const Parity parity)
         {
-            set_data_bits(data_bits);
-            set_stop_bits(stop_bits);
-            set_parity(parity);
+            const bool enabled = disable_for_reconfiguration();
+
+            // Set new data bits, stop bits and parity
+            m_usart->CFG = (m_usart->CFG & ~(CFG_DATALEN_BITMASK | CFG_STOPLEN_BITMASK | CFG_PARITY_BITMASK))
+                         | static_cast<uint32_t>(data_bits)
+                         | static_cast<uint32_t>(stop_bits)
+                         | static_cast<uint32_t>(parity);
+
+            restore_after_reconfiguration(enabled);
         }
 
         void set_data_bits(const DataBits data_bits)
         {
-            const bool enabled = is_enabled();
-
-            if(enabled == true)
-            {
-                // USART enabled...
-
-                // Make sure the USART is not currently sending or receiving data
-                while(is_tx_idle() == false || is_rx_idle() == false)
-                {}
-
-                // Disable USART
-                disable();
-            }
+            const bool enabled = disable_for_reconfiguration();
 
             // Set new data bits
             m_usart->CFG = (m_usart->CFG & ~CFG_DATALEN_BITMASK) | static_cast<uint32_t>(data_bits);
 
-            if(enabled == true)
-            {
-                // If previously enabled, re-enable.
-                enable();
-            }
+            restore_after_reconfiguration(enabled);
         }
 
         void set_stop_bits(const StopBits stop_bits)
         {
-            const bool enabled = is_enabled();
-
-            if(enabled == true)
-            {
-                // USART enabled...
-
-                // Make sure the USART is not currently sending or receiving data
-                while(is_tx_idle() == false || is_rx_idle() == false)
-                {}
-
-                // Disable USART
-                disable();
-            }
+            const bool enabled = disable_for_reconfiguration();
 
             // Set new stop bits
             m_usart->CFG = (m_usart->CFG & ~CFG_STOPLEN_BITMASK) | static_cast<uint32_t>(stop_bits);
 
-            if(enabled == true)
-            {
-                // If previously enabled, re-enable.
-                enable();
-            }
+            restore_after_reconfiguration(enabled);
         }
 
         void set_parity(const Parity parity)
         {
-            const bool enabled = is_enabled();
-
-            if(enabled == true)
-            {
-                // USART enabled...
-
-                // Make sure the USART is not currently sending or receiving data
-                while(is_tx_idle() == false || is_rx_idle() == false)
-                {}
-
-                // Disable USART
-                disable();
-            }
+            const bool enabled = disable_for_reconfiguration();
 
             // Set new parity
             m_usart->CFG = (m_usart->CFG & ~CFG_PARITY_BITMASK) | static_cast<uint32_t>(parity);
 
-            if(enabled == true)
-            {
-                // If previously enabled, re-enable.
-                enable();
-            }
+            restore_after_reconfiguration(enabled);
         }
 
         void set_baudrate(const int32_t baudrate)
         {
             assert(baudrate > 0);
 
-            const bool enabled = is_enabled();
+            const bool enabled = disable_for_reconfiguration();
 
-            if(enabled == true)
-            {
-                // USART enabled...
+            m_baudrate_settings = configure_baudrate_clock(baudrate);
 
-                // Make sure the USART is not currently sending or receiving data
-                while(is_tx_idle() == false || is_rx_idle() == false)
-                {}
+            // Set oversampling and baudrate generator registers
+            m_usart->OSR = m_baudrate_settings.oversampling - 1;
+            m_usart->BRG = m_baudrate_settings.brg_div - 1;
 
-                // Disable USART
-                disable();
+            restore_after_reconfiguration(enabled);
+        }
+
+        // Apply a complete configuration (CFG, OSR and BRG) with a single
+        // wait for idle / disable / enable cycle
+        void apply(const Config& config)
+        {
+            assert(config.clock_source == m_clock_source);
+
+            const bool enabled = disable_for_reconfiguration();
+
+            if(m_clock_source != ClockSource::MAIN_CLK)
+            {
+                if(is_frg_shared() == true)
+                {
+                    // The multiplier used by the other USART(s) cannot be changed
+                    assert(Clock::get_frg_clock_mult(get_frg_select()) == config.baudrate_settings.frg_mult);
+                }
+                else
+                {
+                    set_frg_clock(config.baudrate_settings.frg_mult);
+                }
             }
 
-            const int32_t div = get_baudrate_generator_div(baudrate);
-            assert(div >= 1 && div <= 65536);
+            // The configuration must have been solved for the current clock frequency
+            assert(get_clock_source_frequency() == config.clock_freq);
 
-            // Set baudrate generator register
-            m_usart->BRG = div - 1;
+            m_usart->CFG = (m_usart->CFG & ~(CFG_DATALEN_BITMASK | CFG_STOPLEN_BITMASK | CFG_PARITY_BITMASK))
+                         | static_cast<uint32_t>(config.data_bits)
+                         | static_cast<uint32_t>(config.stop_bits)
+                         | static_cast<uint32_t>(config.parity);
 
-            if(enabled == true)
+            m_usart->OSR = config.baudrate_settings.oversampling - 1;
+            m_usart->BRG = config.baudrate_settings.brg_div - 1;
+
+            m_baudrate_settings = config.baudrate_settings;
+
+            restore_after_reconfiguration(enabled);
+        }
+
+        // Get the current configuration (to restore it later with apply())
+        Config get_config() const
+        {
+            const uint32_t cfg = m_usart->CFG;
+
+            return { m_clock_source,
+                     get_clock_source_frequency(),
+                     static_cast<DataBits>(cfg & CFG_DATALEN_BITMASK),
+                     static_cast<StopBits>(cfg & CFG_STOPLEN_BITMASK),
+                     static_cast<Parity>(cfg & CFG_PARITY_BITMASK),
+                     m_baudrate_settings };
+        }
+
+        // Solve a complete configuration for the supplied clock source input frequency
+        // NOTE: The FRG multiplier is part of the solution, so a configuration
+        //       for a FRG shared by several USARTs should come from get_config().
+        static constexpr Config make_config(const int32_t     clock_freq,
+                                            const int32_t     baudrate,
+                                            const DataBits    data_bits    = DataBits::BITS_8,
+                                            const StopBits    stop_bits    = StopBits::BITS_1,
+                                            const Parity      parity       = Parity::NONE,
+                                            const ClockSource clock_source = ClockSource::FRG0)
+        {
+            const int32_t max_frg_mult = (clock_source == ClockSource::MAIN_CLK) ? 0 : 255;
+
+            return { clock_source,
+                     clock_freq,
+                     data_bits,
+                     stop_bits,
+                     parity,
+                     solve_baudrate(clock_freq, baudrate, 0, max_frg_mult) };
+        }
+
+        ClockSource get_clock_source() const
+        {
+            return m_clock_source;
+        }
+
+        // Get the settings (and the achieved baudrate) used by the last baudrate set
+        const BaudrateSettings& get_baudrate_settings() const
+        {
+            return m_baudrate_settings;
+        }
+
+        // Find the FRG multiplier (in the supplied range), oversampling and
+        // baudrate generator divider that give the minimum baudrate error
+        // NOTE: Runs at compile time when used in a constant expression. The
+        //       search stops on the first exact solution (highest oversampling
+        //       is preferred).
+        static constexpr BaudrateSettings solve_baudrate(const int32_t clock_freq,
+                                                         const int32_t baudrate,
+                                                         const int32_t min_frg_mult = 0,
+                                                         const int32_t max_frg_mult = 255)
+        {
+            assert(clock_freq > 0 && baudrate >= 110);
+            assert(min_frg_mult >= 0 && min_frg_mult <= max_frg_mult && max_frg_mult <= 255);
+
+            // Baudrate = clock * 256 / ((256 + MULT) * OSR * BRG)
+            const uint64_t target = static_cast<uint64_t>(clock_freq) * 256;
+
+            // Total divider (scaled by 256) for the exact baudrate
+            const uint32_t ideal_div = static_cast<uint32_t>(target / static_cast<uint32_t>(baudrate));
+
+            BaudrateSettings best { min_frg_mult, 16, 1, 0, 0 };
+            uint64_t         best_error = UINT64_MAX;   // |target - baudrate * total_div|
+            uint64_t         best_total = 1;            // (256 + MULT) * OSR * BRG
+
+            for(int32_t oversampling = 16; oversampling >= 5 && best_error != 0; --oversampling)
             {
-                // If previously enabled, re-enable.
-                enable();
+                for(int32_t mult = min_frg_mult; mult <= max_frg_mult && best_error != 0; ++mult)
+                {
+                    const uint32_t frg_osr_div = static_cast<uint32_t>((256 + mult) * oversampling);
+
+                    // The best divider is one of the two around the ideal one
+                    const int32_t brg_low = static_cast<int32_t>(ideal_div / frg_osr_div);
+
+                    for(int32_t brg_div = brg_low; brg_div <= brg_low + 1; ++brg_div)
+                    {
+                        if(brg_div < 1 || brg_div > 65536)
+                        {
+                            continue;
+                        }
+
+                        const uint64_t total  = static_cast<uint64_t>(frg_osr_div) * brg_div;
+                        const uint64_t actual = total * static_cast<uint32_t>(baudrate);
+
+                        // Ignore dividers with more than 50% error (keeps the comparison below in 64 bits)
+                        if(actual > target * 2 || actual * 2 < target)
+                        {
+                            continue;
+                        }
+
+                        const uint64_t error = (actual > target) ? actual - target : target - actual;
+
+                        // Compare the baudrate errors: error / total (without divisions)
+                        if(error * best_total < best_error * total)
+                        {
+                            best       = { mult, oversampling, brg_div, 0, 0 };
+                            best_error = error;
+                            best_total = total;
+                        }
+                    }
+                }
             }
+
+            assert(best_error != UINT64_MAX);
+
+            const int64_t actual = static_cast<int64_t>(best_total) * baudrate;
+
+            best.baudrate  = static_cast<int32_t>((target + best_total / 2) / best_total);
+            best.error_ppm = static_cast<int32_t>((static_cast<int64_t>(target) - actual) * 1000000 / actual);
+
+            return best;
         }
 
         // -------- ENABLE / DISABLE ------------------------------------------
@@ -586,6 +715,114 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
             m_usart->TXDAT = value & 0x000001FF;
         }
 
+        // -------- MULTIDROP / RS-485 ----------------------------------------
+
+        // Enable the hardware address match used with the address detect mode
+        // NOTE: In address detect mode, received characters with the 9th bit
+        //       cleared are ignored and only addresses equal to the supplied one
+        //       set the receiver ready flag (and request an interrupt).
+        void enable_address_match(const uint8_t address)
+        {
+            const bool enabled = disable_for_reconfiguration();
+
+            m_usart->ADDR = address;
+            m_usart->CFG |= CFG_AUTOADDR;
+
+            restore_after_reconfiguration(enabled);
+        }
+
+        void disable_address_match()
+        {
+            const bool enabled = disable_for_reconfiguration();
+
+            m_usart->CFG &= ~CFG_AUTOADDR;
+
+            restore_after_reconfiguration(enabled);
+        }
+
+        uint8_t get_match_address() const
+        {
+            return static_cast<uint8_t>(m_usart->ADDR & 0xFF);
+        }
+
+        // Address detect mode (can be changed from the IRQ handler, e.g. after
+        // receiving a matching address to start receiving the frame data)
+        void enable_address_detect()
+        {
+            m_usart->CTL |= CTL_ADDRDET;
+        }
+
+        void disable_address_detect()
+        {
+            m_usart->CTL &= ~CTL_ADDRDET;
+        }
+
+        bool is_address_detect_enabled() const
+        {
+            return (m_usart->CTL & CTL_ADDRDET) != 0;
+        }
+
+        // Enable the RS-485 driver enable output on the RTS pin
+        // NOTE: The RTS output is asserted by hardware while transmitting. With
+        //       turnaround enabled, it is kept asserted for one more character
+        //       time after the last stop bit. USART3 and USART4 have no RTS output.
+        void enable_driver_enable(const Pin::Name            rts,
+                                  const DriverEnablePolarity polarity,
+                                  const bool                 turnaround = false)
+        {
+            const Name name = static_cast<Name>(get_index());
+
+            switch(name)
+            {
+                case Name::USART0: Swm::assign(Swm::PinMovable::U0_RTS_O, rts); break;
+                case Name::USART1: Swm::assign(Swm::PinMovable::U1_RTS_O, rts); break;
+#ifdef __LPC845__
+                case Name::USART2: Swm::assign(Swm::PinMovable::U2_RTS_O, rts); break;
+#endif
+                default:           assert(false);                                break;
+            }
+
+            const bool enabled = disable_for_reconfiguration();
+
+            m_usart->CFG = (m_usart->CFG & ~(CFG_OESEL | CFG_OEPOL | CFG_OETA))
+                         | CFG_OESEL
+                         | static_cast<uint32_t>(polarity)
+                         | ((turnaround == true) ? CFG_OETA : 0);
+
+            restore_after_reconfiguration(enabled);
+        }
+
+        void disable_driver_enable()
+        {
+            const bool enabled = disable_for_reconfiguration();
+
+            m_usart->CFG &= ~(CFG_OESEL | CFG_OEPOL | CFG_OETA);
+
+            restore_after_reconfiguration(enabled);
+
+            const Name name = static_cast<Name>(get_index());
+
+            switch(name)
+            {
+                case Name::USART0: Swm::unassign(Swm::PinMovable::U0_RTS_O); break;
+                case Name::USART1: Swm::unassign(Swm::PinMovable::U1_RTS_O); break;
+#ifdef __LPC845__
+                case Name::USART2: Swm::unassign(Swm::PinMovable::U2_RTS_O); break;
+#endif
+                default:                                                      break;
+            }
+        }
+
+        // -------- DMA -------------------------------------------------------
+
+        // DMA channels hardwired to the receiver / transmitter requests
+        std::size_t get_dma_rx_channel() const { return get_index() * 2;     }
+        std::size_t get_dma_tx_channel() const { return get_index() * 2 + 1; }
+
+        // Data registers addresses (DMA source / destination)
+        const volatile void* get_rx_data_address() const { return &m_usart->RXDAT; }
+        volatile void*       get_tx_data_address()       { return &m_usart->TXDAT; }
+
     private:
 
         // --------------------------------------------------------------------
@@ -598,49 +835,145 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
             CFG_ENABLE          = (1 << 0),     // USART enable
             CFG_DATALEN_BITMASK = (3 << 2),     // USART data mode bitmask
             CFG_STOPLEN_BITMASK = (1 << 6),     // USART stop bits bitmask
-            CFG_PARITY_BITMASK  = (3 << 4)      // USART parity bitmask
+            CFG_PARITY_BITMASK  = (3 << 4),     // USART parity bitmask
+            CFG_OETA            = (1 << 18),    // Output enable turnaround time enable for RS-485 operation
+            CFG_AUTOADDR        = (1 << 19),    // Automatic address matching enable
+            CFG_OESEL           = (1 << 20),    // Output enable select (RTS used as RS-485 driver enable)
+            CFG_OEPOL           = (1 << 21)     // Output enable polarity (high) for RS-485 operation
+        };
+
+        // USART Control Register (CTL) bits
+        enum CTL : uint32_t
+        {
+            CTL_ADDRDET         = (1 << 2)      // Address detect mode enable
         };
 
         // --------------------------------------------------------------------
         // PRIVATE MEMBER FUNCTIONS
         // --------------------------------------------------------------------
 
-        // -------- FRG0 CONFIGURATION ----------------------------------------
+        // -------- CLOCK / BAUDRATE CONFIGURATION ----------------------------
 
-        // Configure the FRG0 to be used and shared by all USART peripherals.
-        // NOTE: implemented on the CPP file because it uses parameters from
-        //       the library configuration file (xarmlib_config.h).
-        void initialize_frg0();
+        Clock::PeripheralClockSource get_peripheral_clock_source() const
+        {
+            switch(m_clock_source)
+            {
+                case ClockSource::FRG0:     return Clock::PeripheralClockSource::FRG0_CLK; break;
+                case ClockSource::FRG1:     return Clock::PeripheralClockSource::FRG1_CLK; break;
+                case ClockSource::MAIN_CLK:
+                default:                    return Clock::PeripheralClockSource::MAIN_CLK; break;
+            }
+        }
 
-        // Return the FRG MUL value for the supplied USART and main clock frequencies
-        static constexpr uint8_t get_frg_mul(const int32_t usart_freq, const int32_t main_clk_freq)
+        // Check if the FRG selected by this USART is also used by another USART
+        bool is_frg_shared() const
         {
-            const float mul = std::round((static_cast<float>(main_clk_freq) * 256 / static_cast<float>(usart_freq)) - 256);
+            for(std::size_t index = 0; index < USART_COUNT; ++index)
+            {
+                const auto* const usart = get_pointer(index);
+
+                if(usart != nullptr && usart != this && usart->m_clock_source == m_clock_source)
+                {
+                    return true;
+                }
+            }
 
-            return static_cast<uint8_t>(mul);
+            return false;
         }
 
-        // Return the maximum USART frequency that can be used to generate a
-        // standard baudrate frequency for the supplied main clock frequency.
-        static constexpr int32_t get_max_standard_frequency(const int32_t main_clk_freq)
+        // FRG selected by this USART (only valid when the clock source is not the main clock)
+        Clock::FrgClockSelect get_frg_select() const
         {
-            // 58.982400MHz is the maximum attainable frequency from a 60MHz clock source
-            int32_t max_standard_freq = 58982400;
+            return (m_clock_source == ClockSource::FRG0) ? Clock::FrgClockSelect::FRG0
+                                                         : Clock::FrgClockSelect::FRG1;
+        }
 
-            while(max_standard_freq > main_clk_freq)
+        // Clock source input frequency (the FRG input frequency when using a FRG)
+        int32_t get_clock_source_frequency() const
+        {
+            if(m_clock_source == ClockSource::MAIN_CLK)
             {
-                max_standard_freq /= 2;
+                return Clock::get_main_clock_pll_frequency();
             }
 
-            return max_standard_freq;
+            return Clock::get_frg_clock_in_frequency(get_frg_select());
+        }
+
+        // Select the main clock as the FRG source and set its multiplier
+        void set_frg_clock(const int32_t mult)
+        {
+            assert(mult >= 0 && mult <= 255);
+
+            const auto frg = get_frg_select();
+
+            Clock::set_frg_clock_source(frg, Clock::FrgClockSource::MAIN_CLK);
+
+            // NOTE: DIV is always 0xFF to use with the fractional baudrate generator
+            Clock::set_frg_clock_divider(frg, static_cast<uint8_t>(mult), 0xFF);
         }
 
-        // Return the USART frequency divider (baudrate generator divider) to obtain the supplied baudrate frequency
-        static int32_t get_baudrate_generator_div(const int32_t baudrate);
+        // Solve the baudrate for the selected clock source and configure its FRG (if not shared)
+        BaudrateSettings configure_baudrate_clock(const int32_t baudrate)
+        {
+            if(m_clock_source == ClockSource::MAIN_CLK)
+            {
+                return solve_baudrate(get_clock_source_frequency(), baudrate, 0, 0);
+            }
+
+            if(is_frg_shared() == true)
+            {
+                // Keep the multiplier used by the other USART(s)
+                const int32_t mult = Clock::get_frg_clock_mult(get_frg_select());
+
+                return solve_baudrate(get_clock_source_frequency(), baudrate, mult, mult);
+            }
+
+            // Use the main clock as the FRG input and solve the multiplier too
+            Clock::set_frg_clock_source(get_frg_select(), Clock::FrgClockSource::MAIN_CLK);
+
+            const BaudrateSettings settings = solve_baudrate(get_clock_source_frequency(), baudrate);
+
+            set_frg_clock(settings.frg_mult);
+
+            return settings;
+        }
+
+        // -------- RECONFIGURATION -------------------------------------------
+
+        // Wait until the USART is not sending or receiving data and disable it
+        // NOTE: Returns the previous enable state.
+        bool disable_for_reconfiguration()
+        {
+            const bool enabled = is_enabled();
+
+            if(enabled == true)
+            {
+                // USART enabled...
+
+                // Make sure the USART is not currently sending or receiving data
+                while(is_tx_idle() == false || is_rx_idle() == false)
+                {}
+
+                // Disable USART
+                disable();
+            }
+
+            return enabled;
+        }
+
+        void restore_after_reconfiguration(const bool enabled)
+        {
+            if(enabled == true)
+            {
+                // If previously enabled, re-enable.
+                enable();
+            }
+        }
 
         // -------- PRIVATE IRQ HANDLERS --------------------------------------
 
         // IRQ handler private implementation (call user IRQ handler)
+        inline __attribute__((always_inline))
         int32_t irq_handler()
         {
             int32_t yield = 0;  // User in FreeRTOS
@@ -654,20 +987,25 @@ class Usart : private PeripheralRefCounter<Usart, USART_COUNT>
         }
 
         // IRQ handler called directly by the interrupt C functions
-        // NOTE: Returns yield flag for FreeRTOS
+        // NOTE: Returns yield flag for FreeRTOS. The USART may not be in use
+        //       when a shared IRQ (USART3 / USART4) is requested by a pin interrupt.
+        inline __attribute__((always_inline))
         static int32_t irq_handler(const Name name)
         {
-            const auto index = static_cast<std::size_t>(name);
+            auto* const usart = Usart::get_pointer(static_cast<std::size_t>(name));
 
-            return Usart::get_reference(index).irq_handler();
+            return (usart != nullptr) ? usart->irq_handler() : 0;
         }
 
         // --------------------------------------------------------------------
         // PRIVATE MEMBER VARIABLES
         // --------------------------------------------------------------------
 
-        LPC_USART_T* m_usart { nullptr };   // Pointer to the CMSIS USART structure
-        IrqHandler   m_irq_handler;         // User defined IRQ handler
+        LPC_USART_T*     m_usart { nullptr };   // Pointer to the CMSIS USART structure
+        IrqHandler       m_irq_handler;         // User defined IRQ handler
+
+        const ClockSource m_clock_source;       // USART clock source
+        BaudrateSettings  m_baudrate_settings { 0, 16, 1, 0, 0 };
 };
 
 
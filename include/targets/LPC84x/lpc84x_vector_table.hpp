@@ -0,0 +1,219 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_vector_table.hpp
+// @brief   NXP LPC84x vector table relocation class.
+// @date    11 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef __XARMLIB_TARGETS_LPC84X_VECTOR_TABLE_HPP
+#define __XARMLIB_TARGETS_LPC84X_VECTOR_TABLE_HPP
+
+#include "system/array"
+#include "system/cassert"
+#include "targets/LPC84x/lpc84x_cmsis.hpp"
+
+
+
+
+// Flash vector table start address (defined in the linker script)
+extern "C" const uint32_t __vectors_start__[];
+
+
+
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+class VectorTable
+{
+    public:
+
+        // --------------------------------------------------------------------
+        // PUBLIC DEFINITIONS
+        // --------------------------------------------------------------------
+
+        // Core level (CM0+) exceptions + chip level (LPC84x) interrupts
+        static constexpr std::size_t VECTOR_COUNT { 16 + 32 };
+
+        // Interrupt handler installed directly in the vector table
+        using IrqHandlerPtr = void (*)(void);
+
+        // Interrupt handler bound at compile-time (returns the yield flag like
+        // the peripheral delegate IRQ handlers)
+        using IrqHandlerType = int32_t();
+
+        // --------------------------------------------------------------------
+        // PUBLIC MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        // Use the RAM vector table (initialized with a copy of the flash
+        // vector table the first time it is used)
+        static void relocate_to_ram()
+        {
+            if(m_ram_table_initialized == false)
+            {
+                for(std::size_t vector = 0; vector < VECTOR_COUNT; ++vector)
+                {
+                    m_ram_table[vector] = __vectors_start__[vector];
+                }
+
+                m_ram_table_initialized = true;
+            }
+
+            set_table_address(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(m_ram_table.data())));
+        }
+
+        // Use the flash vector table
+        static void relocate_to_flash()
+        {
+            set_table_address(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(__vectors_start__)));
+        }
+
+        static bool is_in_ram()
+        {
+            return (SCB->VTOR == static_cast<uint32_t>(reinterpret_cast<uintptr_t>(m_ram_table.data())));
+        }
+
+        // -------- HANDLER INSTALLATION --------------------------------------
+
+        // Install a handler directly in the RAM vector table (relocated when
+        // needed), bypassing the library IRQ handler of the interrupt. The
+        // handler is responsible for clearing the peripheral interrupt flags.
+        // NOTE: The flash vector table is used again if 'relocate_to_flash()'
+        //       is called, dropping the installed handlers until the next
+        //       relocation to RAM.
+        static void set_handler(const IRQn_Type irq, const IrqHandlerPtr handler)
+        {
+            assert(irq >= 0 && static_cast<std::size_t>(irq) < VECTOR_COUNT - 16);
+            assert(handler != nullptr);
+
+            if(is_in_ram() == false)
+            {
+                relocate_to_ram();
+            }
+
+            // Single word store (an interrupt taken in between uses either
+            // the old or the new handler)
+            m_ram_table[get_vector(irq)] = reinterpret_cast<uintptr_t>(handler);
+
+            __DSB();
+        }
+
+        // Install a compile-time bound handler: the handler is called from its
+        // own vector entry, without the delegate and the peripheral lookup of
+        // the library IRQ handlers (shared vectors are not demultiplexed)
+        // NOTE: GCC doesn't honour section attributes on function templates,
+        //       so this entry stays in flash. Handlers that must keep running
+        //       while IAP programs the flash (XARMLIB_ENABLE_IAP_RAM_IRQS)
+        //       are installed with the overload above from a RAM function.
+        template <IrqHandlerType* handler>
+        static void set_handler(const IRQn_Type irq)
+        {
+            set_handler(irq, &irq_handler<handler>);
+        }
+
+        // Reinstall the handler of the flash vector table (library IRQ handler)
+        static void restore_handler(const IRQn_Type irq)
+        {
+            assert(irq >= 0 && static_cast<std::size_t>(irq) < VECTOR_COUNT - 16);
+
+            if(m_ram_table_initialized == true)
+            {
+                m_ram_table[get_vector(irq)] = __vectors_start__[get_vector(irq)];
+
+                __DSB();
+            }
+        }
+
+        // Handler of the vector table in use
+        static IrqHandlerPtr get_handler(const IRQn_Type irq)
+        {
+            assert(irq >= 0 && static_cast<std::size_t>(irq) < VECTOR_COUNT - 16);
+
+            const uintptr_t address = (is_in_ram() == true) ? m_ram_table[get_vector(irq)]
+                                                            : __vectors_start__[get_vector(irq)];
+
+            return reinterpret_cast<IrqHandlerPtr>(address);
+        }
+
+    private:
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER FUNCTIONS
+        // --------------------------------------------------------------------
+
+        static constexpr std::size_t get_vector(const IRQn_Type irq)
+        {
+            return 16 + static_cast<std::size_t>(irq);
+        }
+
+        template <IrqHandlerType* handler>
+        static void irq_handler(void)
+        {
+            const int32_t yield = handler();
+
+#ifdef XARMLIB_USE_FREERTOS
+            portEND_SWITCHING_ISR(yield);
+#else
+            (void)yield;
+#endif
+        }
+
+        static void set_table_address(const uint32_t address)
+        {
+            SCB->VTOR = address;
+
+            // Ensure the new table is used by the next exception
+            __DSB();
+            __ISB();
+        }
+
+        // --------------------------------------------------------------------
+        // PRIVATE MEMBER VARIABLES
+        // --------------------------------------------------------------------
+
+        // NOTE: VTOR[7:0] are reserved (table aligned to 256 bytes). The
+        //       entries are 32-bit on the target (pointer sized on the host).
+        alignas(256) static std::array<uintptr_t, VECTOR_COUNT> m_ram_table;
+        static bool                                            m_ram_table_initialized;
+};
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __XARMLIB_TARGETS_LPC84X_VECTOR_TABLE_HPP
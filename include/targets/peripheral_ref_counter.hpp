@@ -33,9 +33,12 @@
 #ifndef __XARMLIB_TARGETS_PERIPHERAL_REF_COUNTER_HPP
 #define __XARMLIB_TARGETS_PERIPHERAL_REF_COUNTER_HPP
 
+#include <cstdint>
+
 #include "system/array"
 #include "system/cassert"
 #include "system/non_copyable"
+#include "system/target"
 
 namespace xarmlib
 {
@@ -65,6 +68,15 @@ class PeripheralRefCounter : private NonCopyable<PeripheralRefCounter<Peripheral
             m_peripherals[m_index] = &peripheral;
         }
 
+        // Reference a specific peripheral index (for peripherals with fixed hardware assignments)
+        PeripheralRefCounter(Peripheral& peripheral, const std::size_t index) : m_index { index }
+        {
+            assert(index < PERIPHERAL_COUNT && is_used(index) == false);
+
+            m_used_mask |= (1 << m_index);
+            m_peripherals[m_index] = &peripheral;
+        }
+
         ~PeripheralRefCounter()
         {
             m_used_mask &= ~(1 << m_index);
@@ -83,13 +95,20 @@ class PeripheralRefCounter : private NonCopyable<PeripheralRefCounter<Peripheral
             return *m_peripherals[index];
         }
 
-        static Peripheral* get_pointer(const std::size_t index)
+        __TARGET_IRQ_INLINE static Peripheral* get_pointer(const std::size_t index)
         {
             assert(index < PERIPHERAL_COUNT);
 
             return m_peripherals[index];
         }
 
+        static bool is_used(const std::size_t index)
+        {
+            assert(index < PERIPHERAL_COUNT);
+
+            return (m_used_mask & (1 << index)) != 0;
+        }
+
         static int32_t get_used()
         {
             // Count the number of bits set
@@ -32,25 +32,51 @@
 #ifndef __XARMLIB_HPP
 #define __XARMLIB_HPP
 
+// System memory allocators (block pools and bump arena)
+#include "system/memory_pool"
+
 // HAL interface to peripherals
+#include "hal/hal_crc_engine.hpp"
+#include "hal/hal_dma.hpp"
 #include "hal/hal_faim.hpp"
 #include "hal/hal_gpio.hpp"
+#include "hal/hal_iap.hpp"
 #include "hal/hal_pin.hpp"
+#include "hal/hal_pin_interrupt.hpp"
 #include "hal/hal_port.hpp"
 #include "hal/hal_spi.hpp"
+#include "hal/hal_spi_dma.hpp"
 #include "hal/hal_system.hpp"
 #include "hal/hal_timer.hpp"
 #include "hal/hal_us_ticker.hpp"
 #include "hal/hal_usart.hpp"
+#include "hal/hal_usart_dma.hpp"
+#include "hal/hal_vector_table.hpp"
 #include "hal/hal_watchdog.hpp"
 
 // API interface
+#include "api/api_binary_logger.hpp"
+#include "api/api_buffered_usart.hpp"
 #include "api/api_crc.hpp"
 #include "api/api_digital_in.hpp"
 #include "api/api_digital_in_bus.hpp"
 #include "api/api_digital_out.hpp"
+#include "api/api_digital_out_bus.hpp"
+#include "api/api_flash_kv_store.hpp"
+#include "api/api_frame_usart.hpp"
 #include "api/api_input_scanner.hpp"
+#include "api/api_memory_monitor.hpp"
+#include "api/api_multidrop_usart.hpp"
 #include "api/api_pin_bus.hpp"
+#include "api/api_port_debouncer.hpp"
+#include "api/api_timer_wheel.hpp"
+#include "api/api_usart_gap_timer.hpp"
+
+// Host simulation control (virtual clock and peripheral models)
+#if defined __TARGET_HOST_SIMULATION__
+#include "targets/LPC84x/host/lpc84x_host_flash.hpp"
+#include "targets/LPC84x/host/lpc84x_host_simulator.hpp"
+#endif
 
 
 
@@ -37,10 +37,19 @@ namespace xarmlib
 
 
 
+// Storage of the input handlers registered at run-time (no heap allocation)
+static std::array<InputScanner::InputHandler, XARMLIB_CONFIG_INPUT_SCANNER_SOURCE_COUNT> input_handlers;
+
+
+
+
 // Static initialization
-Timer                                InputScanner::m_timer;
-dynarray<InputScanner::InputHandler> InputScanner::m_input_handlers(XARMLIB_CONFIG_INPUT_SCANNER_SOURCE_COUNT);
-InputScanner::PinChangeHandler       InputScanner::m_pin_change_handler;
+Timer                                       InputScanner::m_timer;
+Timer::IrqHandler                           InputScanner::m_timer_irq_handler;
+const gsl::span<InputScanner::InputHandler> InputScanner::m_input_handlers(input_handlers);
+std::size_t                                 InputScanner::m_input_handler_count { 0 };
+InputScanner::PinChangeHandler              InputScanner::m_pin_change_handler;
+InputScanner::ScanHook                      InputScanner::m_scan_hook;
 
 
 
@@ -0,0 +1,134 @@
+// ----------------------------------------------------------------------------
+// @file    api_memory_monitor.cpp
+// @brief   API memory monitor class (stack / heap usage and stack guard).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "xarmlib_config.hpp"
+#include "system/startup"
+
+#if !defined __TARGET_HOST_SIMULATION__
+#include "system/cmsis"
+#endif
+
+namespace xarmlib
+{
+
+
+
+
+#if !defined __TARGET_HOST_SIMULATION__
+
+// Stack region limits defined in the linker script
+#ifdef MCUXPRESSO_MANAGED_LINKER_SCRIPTS
+extern "C" uint32_t _vStackBase;
+extern "C" uint32_t _vStackTop;
+#define __STACK_BASE _vStackBase
+#define __STACK_TOP  _vStackTop
+#else // Custom Linker Scripts
+extern "C" uint32_t __stack_base;
+extern "C" uint32_t __stack_top;
+#define __STACK_BASE __stack_base
+#define __STACK_TOP  __stack_top
+#endif // MCUXPRESSO_MANAGED_LINKER_SCRIPTS
+
+#endif // !defined __TARGET_HOST_SIMULATION__
+
+
+
+
+// ----------------------------------------------------------------------------
+// PUBLIC MEMBER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+MemoryStats MemoryMonitor::get_stack_stats()
+{
+#if defined __TARGET_HOST_SIMULATION__
+    // The host program runs on its own stack
+    return MemoryStats {};
+#else
+    const uint32_t* const stack_base = &__STACK_BASE;
+    const uint32_t* const stack_top  = &__STACK_TOP;
+
+    const std::size_t capacity = static_cast<std::size_t>(stack_top - stack_base) * sizeof(uint32_t);
+    const std::size_t used     = reinterpret_cast<uint32_t>(stack_top) - __get_MSP();
+
+    std::size_t high_water_mark = 0;
+
+#ifdef XARMLIB_ENABLE_STACK_PAINTING
+    // Look for the first overwritten word above the canary
+    const uint32_t* addr = stack_base + MCU_STACK_CANARY_WORDS;
+
+    while(addr < stack_top && *addr == MCU_STACK_PAINT_PATTERN)
+    {
+        ++addr;
+    }
+
+    high_water_mark = static_cast<std::size_t>(stack_top - addr) * sizeof(uint32_t);
+#endif
+
+    return MemoryStats { capacity, used, high_water_mark, (is_stack_canary_intact() == true) ? 0U : 1U };
+#endif
+}
+
+
+
+
+bool MemoryMonitor::is_stack_canary_intact()
+{
+#if defined __TARGET_HOST_SIMULATION__
+    return true;
+#else
+    const uint32_t* const stack_base = &__STACK_BASE;
+
+    for(std::size_t i = 0; i < MCU_STACK_CANARY_WORDS; ++i)
+    {
+        if(stack_base[i] != MCU_STACK_CANARY)
+        {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// STATIC INITIALIZATION
+// ----------------------------------------------------------------------------
+
+std::optional<Timer>                MemoryMonitor::m_stack_guard_timer;
+MemoryMonitor::StackOverflowHandler MemoryMonitor::m_stack_overflow_handler;
+
+
+
+
+} // namespace xarmlib
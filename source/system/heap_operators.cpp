@@ -1,7 +1,8 @@
 // ----------------------------------------------------------------------------
 // @file    heap_operators.cpp
-// @brief   Minimal implementations of the new/delete operators. Optional null
-//          stubs for malloc/free (only used if symbol CPP_NO_HEAP is defined).
+// @brief   Minimal implementations of the new/delete operators (newlib malloc,
+//          fixed-size block pools or bump arena heap). Optional null stubs for
+//          malloc/free (only used if symbol CPP_NO_HEAP is defined).
 // @date    28 March 2018
 // ----------------------------------------------------------------------------
 //
@@ -30,6 +31,8 @@
 //
 // ----------------------------------------------------------------------------
 
+#include "xarmlib_config.hpp"
+
 #include <cstdlib>
 
 
@@ -37,62 +40,138 @@
 
 #ifndef CPP_NO_HEAP
 
+// ----------------------------------------------------------------------------
+// HEAP SELECTION (XARMLIB_HEAP_POOLS / XARMLIB_HEAP_ARENA / newlib malloc)
+// ----------------------------------------------------------------------------
+
+#if defined (XARMLIB_HEAP_POOLS) && defined (XARMLIB_HEAP_ARENA)
+#error "Only one of XARMLIB_HEAP_POOLS or XARMLIB_HEAP_ARENA can be defined!"
+#endif
+
+#if defined (XARMLIB_HEAP_POOLS)
+
+// Constant initialized: ready for the static constructors
+static xarmlib::XARMLIB_CONFIG_HEAP_POOLS heap;
+
+#elif defined (XARMLIB_HEAP_ARENA)
+
+// Constant initialized: ready for the static constructors
+static xarmlib::MemoryArena<xarmlib::XARMLIB_CONFIG_HEAP_ARENA_SIZE> heap;
+
+#else
+
+static std::size_t heap_failures { 0 };
+
+#if !defined (MCUXPRESSO_MANAGED_LINKER_SCRIPTS)
+// Forward declaration of the heap region statistics function defined in 'newlib_stubs.cpp' file.
+extern "C" xarmlib::MemoryStats mcu_sbrk_get_stats();
+#endif
+
+#endif
+
+
+
+
+static inline void* heap_allocate(std::size_t size)
+{
+#if defined (XARMLIB_HEAP_POOLS) || defined (XARMLIB_HEAP_ARENA)
+    return heap.allocate(size);
+#else
+    void* ptr = malloc(size);
+
+    if(ptr == nullptr)
+    {
+        heap_failures++;
+    }
+
+    return ptr;
+#endif
+}
+
+static inline void heap_free(void* ptr)
+{
+#if defined (XARMLIB_HEAP_POOLS) || defined (XARMLIB_HEAP_ARENA)
+    heap.deallocate(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+
+
+
+namespace xarmlib
+{
+
+MemoryStats get_heap_stats()
+{
+#if defined (XARMLIB_HEAP_POOLS) || defined (XARMLIB_HEAP_ARENA)
+    return heap.get_stats();
+#elif !defined (MCUXPRESSO_MANAGED_LINKER_SCRIPTS)
+    // Heap region taken by malloc and the failed allocations
+    MemoryStats stats = mcu_sbrk_get_stats();
+
+    stats.failures = heap_failures;
+
+    return stats;
+#else
+    return { 0, 0, 0, heap_failures };
+#endif
+}
+
+} // namespace xarmlib
+
+
+
+
+// ----------------------------------------------------------------------------
+// NEW / DELETE OPERATORS
+// ----------------------------------------------------------------------------
+
 void* operator new(std::size_t size) noexcept
 {
-    return malloc(size);
+    return heap_allocate(size);
 }
 
 void* operator new[](std::size_t size) noexcept
 {
-    return malloc(size);
+    return heap_allocate(size);
 }
 
 void operator delete(void* ptr) noexcept
 {
-    free(ptr);
+    heap_free(ptr);
 }
 
 void operator delete(void* ptr, std::size_t size __attribute__((unused))) noexcept
 {
-    free(ptr);
+    heap_free(ptr);
 }
 
 void operator delete[](void* ptr) noexcept
 {
-    free(ptr);
+    heap_free(ptr);
 }
 
 void operator delete[](void* ptr, std::size_t size __attribute__((unused))) noexcept
 {
-    free(ptr);
+    heap_free(ptr);
 }
 
+// NOTE: The placement versions of operator new / delete are the standard
+//       ones declared in <new> (included by the configuration header).
 
+#else // CPP_NO_HEAP
 
-
-// Default placement versions of operator new.
-inline void* operator new(std::size_t size __attribute__((unused)),
-                          void* ptr) noexcept
+namespace xarmlib
 {
-    return ptr;
-}
 
-inline void* operator new[](std::size_t size __attribute__((unused)),
-                            void* ptr) noexcept
+MemoryStats get_heap_stats()
 {
-    return ptr;
+    return { 0, 0, 0, 0 };
 }
 
-// Default placement versions of operator delete.
-inline void operator delete(void* ptr __attribute__((unused)),
-                            void* place __attribute__((unused))) noexcept
-{}
-
-inline void operator delete[](void* ptr __attribute__((unused)),
-                              void* place __attribute__((unused))) noexcept
-{}
-
-#else // CPP_NO_HEAP
+} // namespace xarmlib
 
 extern "C" void* malloc(size_t size __attribute__((unused)))
 {
@@ -35,6 +35,10 @@
 // Copyright (c) 2016 Liviu Ionescu.
 // ----------------------------------------------------------------------------
 
+#include "system/cmsis"
+#include "system/startup"
+
+#include <cstddef>
 #include <cstdint>
 
 extern "C"
@@ -43,15 +47,112 @@ extern "C"
 
 
 
+// ----------------------------------------------------------------------------
+// Startup stage timestamps.
+// ----------------------------------------------------------------------------
+McuStartupTimestamps mcu_startup_timestamps;
+
+
+
+
+// ----------------------------------------------------------------------------
+// Start the SysTick counting core clock cycles (startup instrumentation).
+// ----------------------------------------------------------------------------
+inline __attribute__((always_inline))
+static void mcu_start_cycle_counter()
+{
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// Core clock cycles elapsed since the SysTick was started.
+// ----------------------------------------------------------------------------
+inline __attribute__((always_inline))
+static uint32_t mcu_get_cycle_counter()
+{
+    return SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// Release the SysTick (back to its reset state) for the application.
+// ----------------------------------------------------------------------------
+inline __attribute__((always_inline))
+static void mcu_stop_cycle_counter()
+{
+    SysTick->CTRL = 0;
+    SysTick->LOAD = 0;
+    SysTick->VAL  = 0;
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// Write the stack guard canary and paint the unused stack (optional).
+// ----------------------------------------------------------------------------
+inline __attribute__((always_inline))
+static void mcu_initialize_stack()
+{
+    // Defined in the linker script (lowest address of the stack region)
+#ifdef MCUXPRESSO_MANAGED_LINKER_SCRIPTS
+    extern uint32_t _vStackBase;
+    uint32_t* region_addr = &_vStackBase;
+#else // Custom Linker Scripts
+    extern uint32_t __stack_base;
+    uint32_t* region_addr = &__stack_base;
+#endif
+
+    for(std::size_t i = 0; i < MCU_STACK_CANARY_WORDS; ++i)
+    {
+        *region_addr++ = MCU_STACK_CANARY;
+    }
+
+#ifdef XARMLIB_ENABLE_STACK_PAINTING
+    // Paint everything below the current stack pointer (only the startup
+    // frame is in use this early)
+    const uint32_t* region_end = reinterpret_cast<uint32_t*>(__get_MSP());
+
+    while(region_addr < region_end)
+    {
+        *region_addr++ = MCU_STACK_PAINT_PATTERN;
+    }
+#endif
+}
+
+
+
+
 // ----------------------------------------------------------------------------
 // Copy the specified DATA section from flash to SRAM.
 // ----------------------------------------------------------------------------
 inline __attribute__((always_inline))
 static void mcu_initialize_data(uint32_t* from, uint32_t* region_addr, const uint32_t region_size)
 {
-    // Iterate and copy word by word.
+    // Iterate and copy 4 words at a time (LDM / STM), then word by word.
     // It is assumed that the pointers are word aligned.
-    const uint32_t* region_end = region_addr + (region_size / sizeof(uint32_t));
+    const uint32_t* region_end   = region_addr + (region_size / sizeof(uint32_t));
+    const uint32_t* region_end_4 = region_addr + ((region_size / sizeof(uint32_t)) & ~3UL);
+
+    while(region_addr < region_end_4)
+    {
+        // Low registers only (Thumb-1 LDM / STM with write-back)
+        __asm volatile
+        (
+            "ldmia %[from]!, {r3, r4, r5, r6} \n"
+            "stmia %[to]!,   {r3, r4, r5, r6} \n"
+            : [from] "+l" (from), [to] "+l" (region_addr)
+            :
+            : "r3", "r4", "r5", "r6", "memory"
+        );
+    }
 
     while(region_addr < region_end)
     {
@@ -68,9 +169,30 @@ static void mcu_initialize_data(uint32_t* from, uint32_t* region_addr, const uin
 inline __attribute__((always_inline))
 static void mcu_initialize_bss(uint32_t* region_addr, const uint32_t region_size)
 {
-    // Iterate and clear word by word.
+    // Iterate and clear 4 words at a time (STM), then word by word.
     // It is assumed that the pointers are word aligned.
-    const uint32_t* region_end = region_addr + (region_size / sizeof(uint32_t));
+    // NOTE: Variables that don't need to be zeroed (large buffers always
+    //       written before being read) can be placed in the NOLOAD
+    //       '.noinit' section with the __NOINIT(RAM) section macro.
+    const uint32_t* region_end   = region_addr + (region_size / sizeof(uint32_t));
+    const uint32_t* region_end_4 = region_addr + ((region_size / sizeof(uint32_t)) & ~3UL);
+
+    // Low registers only (Thumb-1 STM with write-back)
+    register uint32_t zero0 __asm("r3") = 0;
+    register uint32_t zero1 __asm("r4") = 0;
+    register uint32_t zero2 __asm("r5") = 0;
+    register uint32_t zero3 __asm("r6") = 0;
+
+    while(region_addr < region_end_4)
+    {
+        __asm volatile
+        (
+            "stmia %[to]!, {r3, r4, r5, r6} \n"
+            : [to] "+l" (region_addr)
+            : "l" (zero0), "l" (zero1), "l" (zero2), "l" (zero3)
+            : "memory"
+        );
+    }
 
     while(region_addr < region_end)
     {
@@ -158,8 +280,17 @@ void mcu_startup()
     extern void mcu_startup_initialize_hardware_early();
     extern void mcu_startup_initialize_hardware();
 
+    // Stack guard canary and stack painting (before any deeper call)
+    mcu_initialize_stack();
+
+    // Count the core clock cycles spent in each startup stage (the stage
+    // timestamps are stored only after the .bss sections are zero filled)
+    mcu_start_cycle_counter();
+
     mcu_startup_initialize_hardware_early();
 
+    const uint32_t hardware_early_timestamp = mcu_get_cycle_counter();
+
     // Copy the data sections from flash to SRAM
     for(uint32_t* p = &__data_section_table; p < &__data_section_table_end; )
     {
@@ -170,6 +301,8 @@ void mcu_startup()
         mcu_initialize_data(from, region_addr, region_size);
     }
 
+    const uint32_t data_timestamp = mcu_get_cycle_counter();
+
     // Zero fill all BSS sections
     for(uint32_t *p = &__bss_section_table; p < &__bss_section_table_end; )
     {
@@ -179,14 +312,24 @@ void mcu_startup()
         mcu_initialize_bss(region_addr, region_size);
     }
 
+    mcu_startup_timestamps.hardware_early = hardware_early_timestamp;
+    mcu_startup_timestamps.data           = data_timestamp;
+    mcu_startup_timestamps.bss            = mcu_get_cycle_counter();
+
     // Hook to continue the initializations. Usually compute and store the
     // clock frequency in the global CMSIS variable, configure IOs, etc...
     mcu_startup_initialize_hardware();
 
+    mcu_startup_timestamps.hardware = mcu_get_cycle_counter();
+
     // Call the standard library initialization (mandatory for C++ to
     // execute the constructors for the static objects).
     mcu_cpp_init_array();
 
+    mcu_startup_timestamps.cpp_init = mcu_get_cycle_counter();
+
+    mcu_stop_cycle_counter();
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
     // ISO C++ forbids taking address of function '::main' [-Wpedantic]
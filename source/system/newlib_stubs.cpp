@@ -31,6 +31,9 @@
 // ----------------------------------------------------------------------------
 
 #include "system/cmsis"
+#include "system/memory_pool"
+
+#include <cstddef>
 
 extern "C"
 {
@@ -43,6 +46,11 @@ extern "C"
 #include <sys/types.h>
 #include <errno.h>
 
+// Heap region growth accounting (read by 'mcu_sbrk_get_stats()')
+static char*       current_heap_end;
+static std::size_t heap_high_water_mark;
+static std::size_t heap_failures;
+
 // ----------------------------------------------------------------------------
 // The function below is taken from the µOS++ IIIe project.
 // (https://github.com/micro-os-plus)
@@ -54,7 +62,6 @@ caddr_t _sbrk(int incr)
     extern char __heap_begin;   // Defined in the linker script
     extern char __heap_limit;   // Defined in the linker script
 
-    static char* current_heap_end;
     char* current_block_address;
 
     if(current_heap_end == 0)
@@ -70,6 +77,8 @@ caddr_t _sbrk(int incr)
     incr = (incr + 3) & (~3); // Align value to 4
     if(current_heap_end + incr > &__heap_limit)
     {
+        heap_failures++;
+
         // Some of the libstdc++-v3 tests rely upon detecting
         // out of memory errors, so do not abort here.
 #if 0
@@ -87,8 +96,27 @@ caddr_t _sbrk(int incr)
 
     current_heap_end += incr;
 
+    const std::size_t used = current_heap_end - &__heap_begin;
+
+    if(used > heap_high_water_mark)
+    {
+        heap_high_water_mark = used;
+    }
+
     return (caddr_t)current_block_address;
 }
+
+// Heap region statistics: memory taken by malloc from the heap region
+// (newlib doesn't give it back, so it is close to the high-water mark)
+xarmlib::MemoryStats mcu_sbrk_get_stats()
+{
+    extern char __heap_begin;   // Defined in the linker script
+    extern char __heap_limit;   // Defined in the linker script
+
+    const std::size_t used = (current_heap_end == 0) ? 0 : (current_heap_end - &__heap_begin);
+
+    return { static_cast<std::size_t>(&__heap_limit - &__heap_begin), used, heap_high_water_mark, heap_failures };
+}
 // ----------------------------------------------------------------------------
 #endif // !MCUXPRESSO_MANAGED_LINKER_SCRITS && !CPP_NO_HEAP
 
@@ -0,0 +1,318 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_host_flash.cpp
+// @brief   Host simulation of the LPC84x flash (Iap flash programming interface).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "system/target"
+
+#ifdef __TARGET_HOST_SIMULATION__
+
+#include "targets/LPC84x/host/lpc84x_host_flash.hpp"
+#include "system/cassert"
+
+#include <algorithm>
+#include <cstring>
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+namespace
+{
+
+
+
+
+// ----------------------------------------------------------------------------
+// FLASH MODEL
+// ----------------------------------------------------------------------------
+
+class FlashModel
+{
+    public:
+
+        static constexpr int32_t PAGE_SIZE    { HostFlash::get_page_size() };
+        static constexpr int32_t SECTOR_SIZE  { HostFlash::get_sector_size() };
+        static constexpr int32_t SECTOR_COUNT { HostFlash::get_sector_count() };
+        static constexpr int32_t FLASH_SIZE   { SECTOR_SIZE * SECTOR_COUNT };
+        static constexpr int32_t PAGE_COUNT   { FLASH_SIZE / PAGE_SIZE };
+
+        FlashModel()
+        {
+            erase_all();
+        }
+
+        void erase_all()
+        {
+            std::fill(std::begin(m_memory), std::end(m_memory), 0xFF);
+            std::fill(std::begin(m_page_programmed), std::end(m_page_programmed), false);
+            std::fill(std::begin(m_sector_erase_count), std::end(m_sector_erase_count), 0);
+
+            m_page_program_count   = 0;
+            m_page_reprogram_count = 0;
+
+            restore_power();
+        }
+
+        bool program(const int32_t address, const gsl::span<const uint8_t> buffer)
+        {
+            if(buffer.size() <= 0 || (buffer.size() % PAGE_SIZE) != 0 ||
+               address < 0 || (address % PAGE_SIZE) != 0 || (address + buffer.size()) > FLASH_SIZE)
+            {
+                return false;
+            }
+
+            for(int32_t offset = 0; offset < buffer.size(); offset += PAGE_SIZE)
+            {
+                const int32_t page = (address + offset) / PAGE_SIZE;
+                const int32_t size = consume_operation() ? PAGE_SIZE : get_torn_size(PAGE_SIZE);
+
+                if(size < 0)
+                {
+                    return false;
+                }
+
+                // Programming can only clear bits
+                for(int32_t index = 0; index < size; ++index)
+                {
+                    m_memory[address + offset + index] &= buffer[offset + index];
+                }
+
+                if(size < PAGE_SIZE)
+                {
+                    return false;
+                }
+
+                m_page_reprogram_count += m_page_programmed[page] ? 1 : 0;
+                m_page_programmed[page] = true;
+                m_page_program_count++;
+            }
+
+            return true;
+        }
+
+        bool erase(const int32_t first_sector, const int32_t last_sector)
+        {
+            if(first_sector < 0 || first_sector > last_sector || last_sector >= SECTOR_COUNT)
+            {
+                return false;
+            }
+
+            for(int32_t sector = first_sector; sector <= last_sector; ++sector)
+            {
+                const int32_t size = consume_operation() ? SECTOR_SIZE : get_torn_size(SECTOR_SIZE);
+
+                if(size < 0)
+                {
+                    return false;
+                }
+
+                std::memset(&m_memory[sector * SECTOR_SIZE], 0xFF, size);
+
+                // Pages completely erased can be programmed again
+                const int32_t first_page = sector * SECTOR_SIZE / PAGE_SIZE;
+
+                std::fill(&m_page_programmed[first_page], &m_page_programmed[first_page + size / PAGE_SIZE], false);
+
+                if(size < SECTOR_SIZE)
+                {
+                    return false;
+                }
+
+                m_sector_erase_count[sector]++;
+            }
+
+            return true;
+        }
+
+        void read(const int32_t address, const gsl::span<uint8_t> buffer) const
+        {
+            assert(address >= 0 && (address + buffer.size()) <= FLASH_SIZE);
+
+            std::memcpy(buffer.data(), &m_memory[address], buffer.size());
+        }
+
+        void set_power_fail(const int32_t operation_count)
+        {
+            assert(operation_count >= 0);
+
+            m_operations_left = operation_count;
+        }
+
+        void restore_power()
+        {
+            m_operations_left = -1;
+            m_power_failed    = false;
+        }
+
+        bool is_power_failed() const
+        {
+            return m_power_failed;
+        }
+
+        int32_t get_sector_erase_count(const int32_t sector) const
+        {
+            assert(sector >= 0 && sector < SECTOR_COUNT);
+
+            return m_sector_erase_count[sector];
+        }
+
+        int64_t get_page_program_count() const
+        {
+            return m_page_program_count;
+        }
+
+        int64_t get_page_reprogram_count() const
+        {
+            return m_page_reprogram_count;
+        }
+
+    private:
+
+        // Returns false when this operation is the one the power fails in
+        bool consume_operation()
+        {
+            if(m_power_failed == true || m_operations_left < 0)
+            {
+                return true;
+            }
+
+            if(m_operations_left-- > 0)
+            {
+                return true;
+            }
+
+            return false;
+        }
+
+        // Bytes written by the operation the power fails in (-1 if it was already off)
+        int32_t get_torn_size(const int32_t size)
+        {
+            if(m_power_failed == true)
+            {
+                return -1;
+            }
+
+            m_power_failed = true;
+
+            m_random = m_random * 1664525UL + 1013904223UL;
+
+            return static_cast<int32_t>((m_random >> 8) % size);
+        }
+
+        uint8_t  m_memory[FLASH_SIZE];
+        bool     m_page_programmed[PAGE_COUNT];
+        int32_t  m_sector_erase_count[SECTOR_COUNT];
+
+        int64_t  m_page_program_count   { 0 };
+        int64_t  m_page_reprogram_count { 0 };
+
+        int32_t  m_operations_left      { -1 };     // Operations before the power fails (-1 if disabled)
+        bool     m_power_failed         { false };
+        uint32_t m_random               { 1 };      // Torn operation size generator
+};
+
+
+
+
+__attribute__ ((init_priority(101))) FlashModel g_flash;
+
+
+
+
+} // namespace
+
+
+
+
+// ----------------------------------------------------------------------------
+// PUBLIC MEMBER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+bool HostFlash::program_flash(const int32_t flash_address, const gsl::span<const uint8_t> buffer)
+{
+    return g_flash.program(flash_address, buffer);
+}
+
+bool HostFlash::erase_flash_sectors(const int32_t first_sector, const int32_t last_sector)
+{
+    return g_flash.erase(first_sector, last_sector);
+}
+
+void HostFlash::read_flash(const int32_t flash_address, const gsl::span<uint8_t> buffer)
+{
+    g_flash.read(flash_address, buffer);
+}
+
+void HostFlash::erase_all()
+{
+    g_flash.erase_all();
+}
+
+void HostFlash::set_power_fail(const int32_t operation_count)
+{
+    g_flash.set_power_fail(operation_count);
+}
+
+void HostFlash::restore_power()
+{
+    g_flash.restore_power();
+}
+
+bool HostFlash::is_power_failed()
+{
+    return g_flash.is_power_failed();
+}
+
+int32_t HostFlash::get_sector_erase_count(const int32_t sector)
+{
+    return g_flash.get_sector_erase_count(sector);
+}
+
+int64_t HostFlash::get_page_program_count()
+{
+    return g_flash.get_page_program_count();
+}
+
+int64_t HostFlash::get_page_reprogram_count()
+{
+    return g_flash.get_page_reprogram_count();
+}
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+#endif // __TARGET_HOST_SIMULATION__
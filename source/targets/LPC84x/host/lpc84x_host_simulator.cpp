@@ -0,0 +1,2482 @@
+// ----------------------------------------------------------------------------
+// @file    lpc84x_host_simulator.cpp
+// @brief   Host simulation of the LPC84x peripherals (virtual clock, register files and NVIC).
+// @date    16 July 2018
+// ----------------------------------------------------------------------------
+//
+// Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+// Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+//
+// See README.md file for additional credits and acknowledgments.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+// ----------------------------------------------------------------------------
+
+#include "system/target"
+
+#ifdef __TARGET_HOST_SIMULATION__
+
+#include "targets/LPC84x/host/lpc84x_host_simulator.hpp"
+#include "targets/LPC84x/lpc84x_vector_table.hpp"
+#include "system/cassert"
+#include "system/memory_pool"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+
+
+
+
+// ----------------------------------------------------------------------------
+// SIMULATED ADDRESS SPACES AND LINKER SCRIPT SYMBOLS
+// ----------------------------------------------------------------------------
+
+extern "C"
+{
+
+alignas(256) uint32_t xarmlib_host_scs_memory [0x01000 / 4];  // SysTick, NVIC and SCB
+alignas(256) uint32_t xarmlib_host_apb_memory [0x78000 / 4];  // WWDT (0x00000) ... USART4 (0x74000)
+alignas(256) uint32_t xarmlib_host_ahb_memory [0x14000 / 4];  // CRC (0x00000) ... FAIM (0x10000)
+alignas(256) uint32_t xarmlib_host_gpio_memory[0x05000 / 4];  // GPIO (0x0000) and PIN_INT (0x4000)
+
+// The host program has its own stack and never uses the flash vector table
+// (the interrupts are dispatched by the simulated NVIC)
+unsigned int   __stack_top;
+const uint32_t __vectors_start__[xarmlib::targets::lpc84x::VectorTable::VECTOR_COUNT] {};
+
+// Interrupt handlers (defined or aliased to the default handler in 'lpc84x_interrupts.cpp')
+void SPI0_IRQHandler          (void);
+void SPI1_IRQHandler          (void);
+void DAC0_IRQHandler          (void);
+void USART0_IRQHandler        (void);
+void USART1_IRQHandler        (void);
+void USART2_IRQHandler        (void);
+void FAIM_IRQHandler          (void);
+void I2C1_IRQHandler          (void);
+void I2C0_IRQHandler          (void);
+void SCT_IRQHandler           (void);
+void MRT_IRQHandler           (void);
+void CMP_CAPT_IRQHandler      (void);
+void WDT_IRQHandler           (void);
+void BOD_IRQHandler           (void);
+void FLASH_IRQHandler         (void);
+void WKT_IRQHandler           (void);
+void ADC_SEQA_IRQHandler      (void);
+void ADC_SEQB_IRQHandler      (void);
+void ADC_THCMP_IRQHandler     (void);
+void ADC_OVR_IRQHandler       (void);
+void DMA_IRQHandler           (void);
+void I2C2_IRQHandler          (void);
+void I2C3_IRQHandler          (void);
+void CTIMER_IRQHandler        (void);
+void PININT0_IRQHandler       (void);
+void PININT1_IRQHandler       (void);
+void PININT2_IRQHandler       (void);
+void PININT3_IRQHandler       (void);
+void PININT4_IRQHandler       (void);
+void PININT5_DAC1_IRQHandler  (void);
+void PININT6_USART3_IRQHandler(void);
+void PININT7_USART4_IRQHandler(void);
+
+// Startup hooks (defined in 'lpc84x_startup_hooks.cpp')
+void mcu_startup_initialize_hardware_early();
+void mcu_startup_initialize_hardware();
+
+} // extern "C"
+
+
+
+
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+namespace
+{
+
+
+
+
+// ----------------------------------------------------------------------------
+// DEFINITIONS
+// ----------------------------------------------------------------------------
+
+constexpr int64_t NO_EVENT { std::numeric_limits<int64_t>::max() };
+
+// APB peripherals are 16 KB apart (block index = offset / 0x4000)
+enum class ApbBlock : uint32_t
+{
+    MRT     = 0x04000 >> 14,
+    SYSCON  = 0x48000 >> 14,
+    SPI0    = 0x58000 >> 14,
+    SPI1    = 0x5C000 >> 14,
+    USART0  = 0x64000 >> 14,
+    USART4  = 0x74000 >> 14
+};
+
+// AHB peripherals are 16 KB apart (block index = offset / 0x4000)
+enum class AhbBlock : uint32_t
+{
+    CRC     = 0x00000 >> 14,
+    SCT     = 0x04000 >> 14,
+    DMA     = 0x08000 >> 14
+};
+
+// System Control Space offsets
+enum SCS : uint32_t
+{
+    SCS_NVIC_ISER = 0x100 + offsetof(NVIC_Type, ISER),
+    SCS_NVIC_ICER = 0x100 + offsetof(NVIC_Type, ICER),
+    SCS_NVIC_ISPR = 0x100 + offsetof(NVIC_Type, ISPR),
+    SCS_NVIC_ICPR = 0x100 + offsetof(NVIC_Type, ICPR)
+};
+
+using IrqHandler = void (*)(void);
+
+constexpr IrqHandler IRQ_HANDLERS[32] =
+{
+    SPI0_IRQHandler,       SPI1_IRQHandler,       DAC0_IRQHandler,          USART0_IRQHandler,
+    USART1_IRQHandler,     USART2_IRQHandler,     FAIM_IRQHandler,          I2C1_IRQHandler,
+    I2C0_IRQHandler,       SCT_IRQHandler,        MRT_IRQHandler,           CMP_CAPT_IRQHandler,
+    WDT_IRQHandler,        BOD_IRQHandler,        FLASH_IRQHandler,         WKT_IRQHandler,
+    ADC_SEQA_IRQHandler,   ADC_SEQB_IRQHandler,   ADC_THCMP_IRQHandler,     ADC_OVR_IRQHandler,
+    DMA_IRQHandler,        I2C2_IRQHandler,       I2C3_IRQHandler,          CTIMER_IRQHandler,
+    PININT0_IRQHandler,    PININT1_IRQHandler,    PININT2_IRQHandler,       PININT3_IRQHandler,
+    PININT4_IRQHandler,    PININT5_DAC1_IRQHandler, PININT6_USART3_IRQHandler, PININT7_USART4_IRQHandler
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// PLAIN MEMORY ACCESS
+// ----------------------------------------------------------------------------
+
+uint32_t& get_word(uint32_t* memory, const uint32_t offset)
+{
+    return memory[offset / sizeof(uint32_t)];
+}
+
+uint32_t& get_syscon_word(const std::size_t offset)
+{
+    return get_word(xarmlib_host_apb_memory, 0x48000 + offset);
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// USART MODEL
+// ----------------------------------------------------------------------------
+
+class UsartModel
+{
+    public:
+
+        void reset(const std::size_t index, const IRQn_Type irqn)
+        {
+            *this = UsartModel {};
+
+            m_index = index;
+            m_irqn  = irqn;
+        }
+
+        IRQn_Type get_irqn() const { return m_irqn; }
+
+        bool is_irq_asserted() const { return get_intstat() != 0; }
+
+        int64_t get_cycles_to_next_event() const
+        {
+            int64_t cycles = NO_EVENT;
+
+            if(m_rx_remaining > 0) cycles = m_rx_remaining;
+            if(m_tx_remaining > 0 && m_tx_remaining < cycles) cycles = m_tx_remaining;
+
+            return cycles;
+        }
+
+        void advance(const int64_t cycles)
+        {
+            if(m_rx_remaining > 0)
+            {
+                m_rx_remaining -= cycles;
+
+                if(m_rx_remaining <= 0)
+                {
+                    m_rx_remaining = 0;
+                    complete_rx_character();
+                }
+            }
+
+            if(m_tx_remaining > 0)
+            {
+                m_tx_remaining -= cycles;
+
+                if(m_tx_remaining <= 0)
+                {
+                    m_tx_remaining = 0;
+                    complete_tx_character();
+                }
+            }
+
+            start_characters();
+        }
+
+        uint32_t read(const uint32_t offset)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_USART_T, CFG):       return m_cfg;
+                case offsetof(LPC_USART_T, CTL):       return m_ctl;
+                case offsetof(LPC_USART_T, STAT):      return get_stat();
+                case offsetof(LPC_USART_T, INTENSET):  return m_inten;
+                case offsetof(LPC_USART_T, INTSTAT):   return get_intstat();
+                case offsetof(LPC_USART_T, BRG):       return m_brg;
+                case offsetof(LPC_USART_T, OSR):       return m_osr;
+                case offsetof(LPC_USART_T, ADDR):      return m_addr;
+                case offsetof(LPC_USART_T, TXDAT):     return m_tx_holding;
+                case offsetof(LPC_USART_T, RXDAT):
+                case offsetof(LPC_USART_T, RXDATSTAT): m_rx_ready = false;
+                                                       return m_rx_data;
+                default:                               return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_USART_T, CFG):      m_cfg = value;
+                                                      if(is_enabled() == false)
+                                                      {
+                                                          // Disabling the USART aborts any transfer in progress
+                                                          m_rx_line.clear();
+                                                          m_rx_remaining      = 0;
+                                                          m_tx_remaining      = 0;
+                                                          m_tx_holding_full   = false;
+                                                      }
+                                                      break;
+                case offsetof(LPC_USART_T, CTL):      m_ctl = value;                       break;
+                case offsetof(LPC_USART_T, STAT):     m_flags &= ~(value & STAT_W1C_MASK); break;
+                case offsetof(LPC_USART_T, INTENSET): m_inten |=  value;                   break;
+                case offsetof(LPC_USART_T, INTENCLR): m_inten &= ~value;                   break;
+                case offsetof(LPC_USART_T, BRG):      m_brg = value & 0xFFFF;              break;
+                case offsetof(LPC_USART_T, OSR):      m_osr = value & 0x000F;              break;
+                case offsetof(LPC_USART_T, ADDR):     m_addr = value & 0x00FF;             break;
+                case offsetof(LPC_USART_T, TXDAT):    m_tx_holding      = value & 0x01FF;
+                                                      m_tx_holding_full = true;
+                                                      break;
+                default:                                                                   break;
+            }
+
+            start_characters();
+        }
+
+        void receive(const uint16_t character)
+        {
+            if(is_enabled() == true)
+            {
+                m_rx_line.push_back(character);
+                start_characters();
+            }
+        }
+
+        int32_t read_transmitted(gsl::span<uint8_t> buffer)
+        {
+            int32_t count = 0;
+
+            while(count < buffer.size() && m_tx_line.empty() == false)
+            {
+                buffer[count++] = static_cast<uint8_t>(m_tx_line.front());
+                m_tx_line.pop_front();
+            }
+
+            return count;
+        }
+
+    private:
+
+        // Status register bits
+        enum STAT : uint32_t
+        {
+            STAT_RXRDY      = (1 << 0),
+            STAT_RXIDLE     = (1 << 1),
+            STAT_TXRDY      = (1 << 2),
+            STAT_TXIDLE     = (1 << 3),
+            STAT_TXDISSTAT  = (1 << 6),
+            STAT_OVERRUNINT = (1 << 8),
+            STAT_START      = (1 << 12),
+            STAT_W1C_MASK   = 0x1F920,
+            STAT_INT_MASK   = 0x1F96D
+        };
+
+        enum CFG : uint32_t
+        {
+            CFG_ENABLE   = (1 << 0),
+            CFG_AUTOADDR = (1 << 19)
+        };
+
+        enum CTL : uint32_t
+        {
+            CTL_ADDRDET = (1 << 2),
+            CTL_TXDIS   = (1 << 6)
+        };
+
+        bool is_enabled() const { return (m_cfg & CFG_ENABLE) != 0; }
+
+        uint32_t get_stat() const
+        {
+            uint32_t stat = m_flags;
+
+            if(m_rx_ready == true)                                stat |= STAT_RXRDY;
+            if(m_rx_remaining == 0)                               stat |= STAT_RXIDLE;
+            if(m_tx_holding_full == false)                        stat |= STAT_TXRDY;
+            if(m_tx_holding_full == false && m_tx_remaining == 0) stat |= STAT_TXIDLE;
+            if((m_ctl & CTL_TXDIS) != 0 && m_tx_remaining == 0)   stat |= STAT_TXDISSTAT;
+
+            return stat;
+        }
+
+        uint32_t get_intstat() const { return get_stat() & m_inten & STAT_INT_MASK; }
+
+        // Character time in core clock cycles (start + data + parity + stop bits)
+        int64_t get_character_cycles() const
+        {
+            const int32_t data_bits   = (((m_cfg >> 2) & 0x03) == 0) ? 7 : ((((m_cfg >> 2) & 0x03) == 2) ? 9 : 8);
+            const int32_t parity_bits = (((m_cfg >> 4) & 0x03) >= 2) ? 1 : 0;
+            const int32_t stop_bits   = (((m_cfg >> 6) & 0x01) != 0) ? 2 : 1;
+
+            int64_t cycles = static_cast<int64_t>(1 + data_bits + parity_bits + stop_bits) * (m_osr + 1) * (m_brg + 1);
+
+            // Apply the fractional divider when the USART is clocked by FRG0 / FRG1
+            const uint32_t clock_select = get_syscon_word(offsetof(LPC_SYSCON_T, FCLKSEL) + m_index * sizeof(uint32_t)) & 0x07;
+
+            if(clock_select == 2 || clock_select == 3)
+            {
+                const std::size_t mult_offset = (clock_select == 2) ? offsetof(LPC_SYSCON_T, FRG0MULT) : offsetof(LPC_SYSCON_T, FRG1MULT);
+
+                cycles = cycles * (256 + (get_syscon_word(mult_offset) & 0xFF)) / 256;
+            }
+
+            return cycles;
+        }
+
+        uint16_t get_data_mask() const
+        {
+            switch((m_cfg >> 2) & 0x03)
+            {
+                case 0:  return 0x07F;
+                case 2:  return 0x1FF;
+                default: return 0x0FF;
+            }
+        }
+
+        void start_characters()
+        {
+            if(is_enabled() == false)
+            {
+                return;
+            }
+
+            if(m_rx_remaining == 0 && m_rx_line.empty() == false)
+            {
+                m_rx_remaining  = get_character_cycles();
+                m_flags        |= STAT_START;
+            }
+
+            if(m_tx_remaining == 0 && m_tx_holding_full == true && (m_ctl & CTL_TXDIS) == 0)
+            {
+                m_tx_shift        = m_tx_holding;
+                m_tx_holding_full = false;
+                m_tx_remaining    = get_character_cycles();
+            }
+        }
+
+        void complete_rx_character()
+        {
+            const uint16_t character = m_rx_line.front() & get_data_mask();
+
+            m_rx_line.pop_front();
+
+            // Address detect mode: discard data characters (and the addresses
+            // not matching the automatic address when enabled)
+            if((m_ctl & CTL_ADDRDET) != 0)
+            {
+                if((character & 0x100) == 0)
+                {
+                    return;
+                }
+
+                if((m_cfg & CFG_AUTOADDR) != 0 && (character & 0xFF) != m_addr)
+                {
+                    return;
+                }
+            }
+
+            if(m_rx_ready == true)
+            {
+                // The new character is lost
+                m_flags |= STAT_OVERRUNINT;
+            }
+            else
+            {
+                m_rx_data  = character;
+                m_rx_ready = true;
+            }
+        }
+
+        void complete_tx_character()
+        {
+            m_tx_line.push_back(m_tx_shift);
+        }
+
+        std::size_t          m_index           { 0 };
+        IRQn_Type            m_irqn            { USART0_IRQn };
+
+        uint32_t             m_cfg             { 0 };
+        uint32_t             m_ctl             { 0 };
+        uint32_t             m_flags           { 0 };       // Latched (W1C) status flags
+        uint32_t             m_inten           { 0 };
+        uint32_t             m_brg             { 0 };
+        uint32_t             m_osr             { 0x0F };
+        uint32_t             m_addr            { 0 };
+
+        std::deque<uint16_t> m_rx_line;                     // Characters waiting on the RX line
+        int64_t              m_rx_remaining    { 0 };       // Cycles until the incoming character is received
+        uint16_t             m_rx_data         { 0 };
+        bool                 m_rx_ready        { false };
+
+        uint16_t             m_tx_holding      { 0 };
+        bool                 m_tx_holding_full { false };
+        uint16_t             m_tx_shift        { 0 };
+        int64_t              m_tx_remaining    { 0 };       // Cycles until the outgoing character is shifted out
+        std::deque<uint16_t> m_tx_line;                     // Characters already transmitted
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// SPI MODEL (MASTER MODE)
+// ----------------------------------------------------------------------------
+
+class SpiModel
+{
+    public:
+
+        void reset(const IRQn_Type irqn)
+        {
+            *this = SpiModel {};
+
+            m_irqn = irqn;
+        }
+
+        IRQn_Type get_irqn() const { return m_irqn; }
+
+        bool is_irq_asserted() const { return get_intstat() != 0; }
+
+        void set_responder(const HostSimulator::SpiResponder& responder) { m_responder = responder; }
+
+        bool is_ssel_asserted() const { return m_ssel_asserted; }
+
+        int64_t get_cycles_to_next_event() const
+        {
+            return (m_remaining > 0) ? m_remaining : NO_EVENT;
+        }
+
+        void advance(const int64_t cycles)
+        {
+            if(m_remaining > 0)
+            {
+                m_remaining -= cycles;
+
+                if(m_remaining <= 0)
+                {
+                    m_remaining = 0;
+                    complete_frame();
+                }
+            }
+
+            start_frame();
+        }
+
+        uint32_t read(const uint32_t offset)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_SPI_T, CFG):      return m_cfg;
+                case offsetof(LPC_SPI_T, DLY):      return m_dly;
+                case offsetof(LPC_SPI_T, STAT):     return get_stat();
+                case offsetof(LPC_SPI_T, INTENSET): return m_inten;
+                case offsetof(LPC_SPI_T, TXCTL):    return m_txctl;
+                case offsetof(LPC_SPI_T, DIV):      return m_div;
+                case offsetof(LPC_SPI_T, INTSTAT):  return get_intstat();
+                case offsetof(LPC_SPI_T, RXDAT):    return read_rx_data();
+                default:                            return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_SPI_T, CFG):      m_cfg = value;                       break;
+                case offsetof(LPC_SPI_T, DLY):      m_dly = value;                       break;
+                case offsetof(LPC_SPI_T, STAT):     m_flags &= ~(value & STAT_W1C_MASK);
+                                                    if((value & STAT_ENDTRANSFER) != 0 && is_idle() == true)
+                                                    {
+                                                        deassert_ssel();
+                                                    }
+                                                    break;
+                case offsetof(LPC_SPI_T, INTENSET): m_inten |=  value;                   break;
+                case offsetof(LPC_SPI_T, INTENCLR): m_inten &= ~value;                   break;
+                case offsetof(LPC_SPI_T, TXCTL):    m_txctl = value & TXCTL_MASK;        break;
+                case offsetof(LPC_SPI_T, DIV):      m_div = value & 0xFFFF;              break;
+                case offsetof(LPC_SPI_T, TXDATCTL): m_txctl = value & TXCTL_MASK;
+                                                    push_frame(value & 0xFFFF);
+                                                    break;
+                case offsetof(LPC_SPI_T, TXDAT):    push_frame(value & 0xFFFF);          break;
+                default:                                                                 break;
+            }
+
+            start_frame();
+        }
+
+    private:
+
+        enum STAT : uint32_t
+        {
+            STAT_RXRDY       = (1 << 0),
+            STAT_TXRDY       = (1 << 1),
+            STAT_SSA         = (1 << 4),
+            STAT_SSD         = (1 << 5),
+            STAT_STALLED     = (1 << 6),
+            STAT_ENDTRANSFER = (1 << 7),
+            STAT_MSTIDLE     = (1 << 8),
+            STAT_W1C_MASK    = 0x3C,
+            STAT_INT_MASK    = 0x3F
+        };
+
+        enum CFG : uint32_t
+        {
+            CFG_ENABLE = (1 << 0),
+            CFG_MASTER = (1 << 2),
+            CFG_LOOP   = (1 << 7)
+        };
+
+        enum TXCTL : uint32_t
+        {
+            TXCTL_EOT      = (1 << 20),
+            TXCTL_RXIGNORE = (1 << 22),
+            TXCTL_MASK     = 0x0F7F0000
+        };
+
+        enum RXDAT : uint32_t
+        {
+            RXDAT_RXSSELN = (0x0F << 16),
+            RXDAT_SOT     = (1 << 20)
+        };
+
+        bool is_idle() const { return m_holding_full == false && m_remaining == 0 && m_stalled == false; }
+
+        uint32_t get_stat() const
+        {
+            uint32_t stat = m_flags;
+
+            if(m_rx_ready == true)                                   stat |= STAT_RXRDY;
+            if(m_holding_full == false)                              stat |= STAT_TXRDY;
+            if(m_stalled == true)                                    stat |= STAT_STALLED;
+            if((m_cfg & CFG_MASTER) != 0 && is_idle() == true)       stat |= STAT_MSTIDLE;
+
+            return stat;
+        }
+
+        uint32_t get_intstat() const { return get_stat() & m_inten & STAT_INT_MASK; }
+
+        void push_frame(const uint32_t data)
+        {
+            // A full holding register is overwritten (the previous frame is lost)
+            m_holding      = data | m_txctl;
+            m_holding_full = true;
+        }
+
+        void start_frame()
+        {
+            if((m_cfg & (CFG_ENABLE | CFG_MASTER)) != (CFG_ENABLE | CFG_MASTER)
+               || m_holding_full == false || m_remaining != 0 || m_stalled == true)
+            {
+                return;
+            }
+
+            m_shift        = m_holding;
+            m_holding_full = false;
+
+            const int64_t frame_bits = ((m_shift >> 24) & 0x0F) + 1;
+
+            m_remaining = frame_bits * (m_div + 1);
+
+            if(m_ssel_asserted == false)
+            {
+                m_ssel_asserted  = true;
+                m_start_of_frame = true;
+                m_flags         |= STAT_SSA;
+            }
+        }
+
+        void complete_frame()
+        {
+            const uint32_t frame_bits = ((m_shift >> 24) & 0x0F) + 1;
+            const uint32_t data_mask  = (1UL << frame_bits) - 1;
+            const uint32_t tx_data    = m_shift & data_mask;
+
+            uint32_t rx_data = data_mask;
+
+            if((m_cfg & CFG_LOOP) != 0)
+            {
+                rx_data = tx_data;
+            }
+            else if(m_responder != nullptr)
+            {
+                rx_data = m_responder(tx_data) & data_mask;
+            }
+
+            if((m_shift & TXCTL_RXIGNORE) == 0)
+            {
+                const uint32_t rx_value = rx_data | ((m_start_of_frame == true) ? RXDAT_SOT : 0);
+
+                m_start_of_frame = false;
+
+                if(m_rx_ready == true)
+                {
+                    // Master mode: the transmitter stalls until the receiver is read
+                    m_pending_rx = rx_value;
+                    m_stalled    = true;
+                }
+                else
+                {
+                    m_rx_data  = rx_value;
+                    m_rx_ready = true;
+                }
+            }
+
+            if((m_shift & TXCTL_EOT) != 0)
+            {
+                deassert_ssel();
+            }
+        }
+
+        uint32_t read_rx_data()
+        {
+            const uint32_t value = m_rx_data;
+
+            if(m_stalled == true)
+            {
+                m_rx_data = m_pending_rx;
+                m_stalled = false;
+            }
+            else
+            {
+                m_rx_ready = false;
+            }
+
+            return value;
+        }
+
+        void deassert_ssel()
+        {
+            if(m_ssel_asserted == true)
+            {
+                m_ssel_asserted  = false;
+                m_flags         |= STAT_SSD;
+            }
+        }
+
+        IRQn_Type                  m_irqn           { SPI0_IRQn };
+        HostSimulator::SpiResponder m_responder;
+
+        uint32_t                   m_cfg            { 0 };
+        uint32_t                   m_dly            { 0 };
+        uint32_t                   m_div            { 0 };
+        uint32_t                   m_txctl          { 0 };
+        uint32_t                   m_flags          { 0 };      // Latched (W1C) status flags
+        uint32_t                   m_inten          { 0 };
+
+        uint32_t                   m_holding        { 0 };      // Data and control bits
+        bool                       m_holding_full   { false };
+        uint32_t                   m_shift          { 0 };
+        int64_t                    m_remaining      { 0 };      // Cycles until the frame is shifted
+        bool                       m_ssel_asserted  { false };
+        bool                       m_start_of_frame { false };
+
+        uint32_t                   m_rx_data        { 0 };
+        bool                       m_rx_ready       { false };
+        uint32_t                   m_pending_rx     { 0 };
+        bool                       m_stalled        { false };
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// MULTI-RATE TIMER MODEL
+// ----------------------------------------------------------------------------
+
+class MrtModel
+{
+    public:
+
+        void reset() { *this = MrtModel {}; }
+
+        bool is_irq_asserted() const
+        {
+            for(const auto& channel : m_channels)
+            {
+                if(channel.flag == true && (channel.ctrl & CTRL_INTEN) != 0) return true;
+            }
+
+            return false;
+        }
+
+        int64_t get_cycles_to_next_event() const
+        {
+            int64_t cycles = NO_EVENT;
+
+            for(const auto& channel : m_channels)
+            {
+                if(channel.running == true && channel.remaining < cycles) cycles = channel.remaining;
+            }
+
+            return cycles;
+        }
+
+        void advance(const int64_t cycles)
+        {
+            for(auto& channel : m_channels)
+            {
+                if(channel.running == false)
+                {
+                    continue;
+                }
+
+                channel.remaining -= cycles;
+
+                if(channel.remaining <= 0)
+                {
+                    channel.flag = true;
+
+                    if((channel.ctrl & CTRL_MODE_MASK) == 0 && channel.interval != 0)
+                    {
+                        // Repeat mode: reload the (possibly updated) interval
+                        channel.remaining = channel.interval;
+                    }
+                    else
+                    {
+                        channel.remaining = 0;
+                        channel.running   = false;
+                    }
+                }
+            }
+        }
+
+        uint32_t read(const uint32_t offset)
+        {
+            if(offset < sizeof(LPC_MRT_T::CHANNEL))
+            {
+                const auto& channel = m_channels[offset / sizeof(LPC_MRT_CHANNEL_T)];
+
+                switch(offset % sizeof(LPC_MRT_CHANNEL_T))
+                {
+                    case offsetof(LPC_MRT_CHANNEL_T, INTVAL): return channel.interval;
+                    case offsetof(LPC_MRT_CHANNEL_T, TIMER):  return (channel.running == true) ? static_cast<uint32_t>(channel.remaining - 1) : 0x7FFFFFFF;
+                    case offsetof(LPC_MRT_CHANNEL_T, CTRL):   return channel.ctrl;
+                    case offsetof(LPC_MRT_CHANNEL_T, STAT):   return ((channel.flag    == true) ? STAT_INTFLAG : 0)
+                                                                   | ((channel.running == true) ? STAT_RUN     : 0);
+                    default:                                  return 0;
+                }
+            }
+
+            switch(offset)
+            {
+                case offsetof(LPC_MRT_T, IDLE_CH):
+                {
+                    for(std::size_t index = 0; index < 4; ++index)
+                    {
+                        if(m_channels[index].running == false) return index << 4;
+                    }
+
+                    return 4 << 4;
+                }
+                case offsetof(LPC_MRT_T, IRQ_FLAG):
+                {
+                    uint32_t flags = 0;
+
+                    for(std::size_t index = 0; index < 4; ++index)
+                    {
+                        if(m_channels[index].flag == true) flags |= (1 << index);
+                    }
+
+                    return flags;
+                }
+                default: return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            if(offset < sizeof(LPC_MRT_T::CHANNEL))
+            {
+                auto& channel = m_channels[offset / sizeof(LPC_MRT_CHANNEL_T)];
+
+                switch(offset % sizeof(LPC_MRT_CHANNEL_T))
+                {
+                    case offsetof(LPC_MRT_CHANNEL_T, INTVAL): write_interval(channel, value); break;
+                    case offsetof(LPC_MRT_CHANNEL_T, CTRL):   channel.ctrl = value & 0x07;    break;
+                    case offsetof(LPC_MRT_CHANNEL_T, STAT):   if((value & STAT_INTFLAG) != 0) channel.flag = false;
+                                                              break;
+                    default:                                                                  break;
+                }
+            }
+            else if(offset == offsetof(LPC_MRT_T, IRQ_FLAG))
+            {
+                for(std::size_t index = 0; index < 4; ++index)
+                {
+                    if((value & (1 << index)) != 0) m_channels[index].flag = false;
+                }
+            }
+        }
+
+    private:
+
+        enum : uint32_t
+        {
+            INTVAL_LOAD    = (1UL << 31),
+            CTRL_INTEN     = (1 << 0),
+            CTRL_MODE_MASK = (3 << 1),
+            STAT_INTFLAG   = (1 << 0),
+            STAT_RUN       = (1 << 1)
+        };
+
+        struct Channel
+        {
+            uint32_t interval  { 0 };
+            uint32_t ctrl      { 0 };
+            bool     flag      { false };
+            bool     running   { false };
+            int64_t  remaining { 0 };       // Cycles until the channel reaches zero
+        };
+
+        static void write_interval(Channel& channel, const uint32_t value)
+        {
+            channel.interval = value & 0x7FFFFFFF;
+
+            // Loaded immediately when forced or idle (otherwise on the next reload)
+            if((value & INTVAL_LOAD) != 0 || channel.running == false)
+            {
+                channel.remaining = channel.interval;
+                channel.running   = (channel.interval != 0);
+            }
+        }
+
+        Channel m_channels[4];
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// STATE CONFIGURABLE TIMER MODEL (UNIFIED COUNTER)
+// ----------------------------------------------------------------------------
+
+class SctModel
+{
+    public:
+
+        void reset() { *this = SctModel {}; }
+
+        bool is_irq_asserted() const { return (m_evflag & m_even) != 0; }
+
+        int64_t get_cycles_to_next_event() const
+        {
+            if(is_running() == false)
+            {
+                return NO_EVENT;
+            }
+
+            int64_t cycles = NO_EVENT;
+
+            for(std::size_t event = 0; event < SCT_NUM_EVENTS; ++event)
+            {
+                if(is_match_event(event) == true)
+                {
+                    // Counter ticks until the match value is reached (a full turn when already there)
+                    const uint32_t match = m_match[get_match_select(event)];
+                    const int64_t  ticks = (match == m_count) ? (1LL << 32) : static_cast<uint32_t>(match - m_count);
+                    const int64_t  event_cycles = ticks * get_prescaler() - m_prescaler_phase;
+
+                    if(event_cycles < cycles) cycles = event_cycles;
+                }
+            }
+
+            return cycles;
+        }
+
+        void advance(const int64_t cycles)
+        {
+            if(is_running() == false)
+            {
+                return;
+            }
+
+            m_prescaler_phase += cycles;
+
+            const int64_t ticks = m_prescaler_phase / get_prescaler();
+
+            m_prescaler_phase %= get_prescaler();
+
+            // NOTE: The engine never advances past the next event, so at most
+            //       the last tick of this step can match
+            if(ticks > 0)
+            {
+                m_count = static_cast<uint32_t>(m_count + ticks);
+
+                for(std::size_t event = 0; event < SCT_NUM_EVENTS; ++event)
+                {
+                    if(is_match_event(event) == true && m_count == m_match[get_match_select(event)])
+                    {
+                        m_evflag |= (1 << event);
+
+                        if((m_limit & (1 << event)) != 0)
+                        {
+                            m_count = 0;
+                        }
+                    }
+                }
+            }
+        }
+
+        uint32_t read(const uint32_t offset)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_SCT_T, CONFIG): return m_config;
+                case offsetof(LPC_SCT_T, CTRL):   return m_ctrl;
+                case offsetof(LPC_SCT_T, LIMIT):  return m_limit;
+                case offsetof(LPC_SCT_T, COUNT):  return m_count;
+                case offsetof(LPC_SCT_T, EVEN):   return m_even;
+                case offsetof(LPC_SCT_T, EVFLAG): return m_evflag;
+                default:                          break;
+            }
+
+            if(offset >= offsetof(LPC_SCT_T, MATCH) && offset < offsetof(LPC_SCT_T, MATCH) + SCT_NUM_REGISTERS * sizeof(uint32_t))
+            {
+                return m_match[(offset - offsetof(LPC_SCT_T, MATCH)) / sizeof(uint32_t)];
+            }
+
+            return get_word(xarmlib_host_ahb_memory, 0x04000 + offset);
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_SCT_T, CONFIG): m_config  = value;                     return;
+                case offsetof(LPC_SCT_T, CTRL):   m_ctrl    = value & ~CTRL_CLRCTR_L;
+                                                  if((value & CTRL_CLRCTR_L) != 0)
+                                                  {
+                                                      m_count           = 0;
+                                                      m_prescaler_phase = 0;
+                                                  }
+                                                  return;
+                case offsetof(LPC_SCT_T, LIMIT):  m_limit   = value;                     return;
+                case offsetof(LPC_SCT_T, COUNT):  m_count   = value;                     return;
+                case offsetof(LPC_SCT_T, EVEN):   m_even    = value;                     return;
+                case offsetof(LPC_SCT_T, EVFLAG): m_evflag &= ~value;                    return;
+                default:                                                                 break;
+            }
+
+            if(offset >= offsetof(LPC_SCT_T, MATCH) && offset < offsetof(LPC_SCT_T, MATCH) + SCT_NUM_REGISTERS * sizeof(uint32_t))
+            {
+                m_match[(offset - offsetof(LPC_SCT_T, MATCH)) / sizeof(uint32_t)] = value;
+            }
+
+            // Event configuration (and the remaining registers) kept in memory
+            get_word(xarmlib_host_ahb_memory, 0x04000 + offset) = value;
+        }
+
+    private:
+
+        enum CTRL : uint32_t
+        {
+            CTRL_STOP_L   = (1 << 1),
+            CTRL_HALT_L   = (1 << 2),
+            CTRL_CLRCTR_L = (1 << 3)
+        };
+
+        bool is_running() const { return (m_ctrl & (CTRL_STOP_L | CTRL_HALT_L)) == 0; }
+
+        int64_t get_prescaler() const { return ((m_ctrl >> 5) & 0xFF) + 1; }
+
+        static uint32_t get_event_word(const std::size_t event, const std::size_t field)
+        {
+            return get_word(xarmlib_host_ahb_memory, 0x04000 + offsetof(LPC_SCT_T, EVENT) + event * 8 + field * 4);
+        }
+
+        // Event enabled in state 0 with a match only condition (COMBMODE = 1)
+        static bool is_match_event(const std::size_t event)
+        {
+            return (get_event_word(event, 0) & 0x01) != 0 && ((get_event_word(event, 1) >> 12) & 0x03) == 1;
+        }
+
+        static std::size_t get_match_select(const std::size_t event)
+        {
+            return (get_event_word(event, 1) & 0x0F) % SCT_NUM_REGISTERS;
+        }
+
+        uint32_t m_config          { 0 };
+        uint32_t m_ctrl            { CTRL_HALT_L };
+        uint32_t m_limit           { 0 };
+        uint32_t m_count           { 0 };
+        uint32_t m_even            { 0 };
+        uint32_t m_evflag          { 0 };
+        uint32_t m_match[SCT_NUM_REGISTERS] {};
+        int64_t  m_prescaler_phase { 0 };
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// CRC ENGINE MODEL
+// ----------------------------------------------------------------------------
+
+// MSB first shift register of the selected polynomial. The data is fed in
+// bytes (word writes are processed as 4 bytes in little-endian order) with
+// the optional per byte bit reversal / complement, and the sum is read with
+// the optional bit reversal / complement.
+class CrcModel
+{
+    public:
+
+        void reset() { *this = CrcModel {}; }
+
+        uint32_t read(const uint32_t offset) const
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_CRC_T, MODE): return m_mode;
+                case offsetof(LPC_CRC_T, SEED): return m_sum;
+                case offsetof(LPC_CRC_T, SUM):  return get_sum();
+                default:                        return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_CRC_T, MODE):    m_mode = value & 0x3F;                 break;
+                case offsetof(LPC_CRC_T, SEED):    m_sum  = value & get_mask();           break;
+                case offsetof(LPC_CRC_T, WR_DATA): for(std::size_t byte = 0; byte < 4; ++byte)
+                                                   {
+                                                       write_byte(static_cast<uint8_t>(value >> (byte * 8)));
+                                                   }
+                                                   break;
+                default:                                                                  break;
+            }
+        }
+
+        void write_byte(uint8_t data)
+        {
+            if((m_mode & MODE_BIT_RVS_WR) != 0) data = static_cast<uint8_t>(reverse(data, 8));
+            if((m_mode & MODE_CMPL_WR)    != 0) data = static_cast<uint8_t>(~data);
+
+            const uint32_t width = get_width();
+
+            m_sum ^= static_cast<uint32_t>(data) << (width - 8);
+
+            for(std::size_t bit = 0; bit < 8; ++bit)
+            {
+                const bool msb = (m_sum & (1UL << (width - 1))) != 0;
+
+                m_sum = ((m_sum << 1) ^ (msb ? get_polynomial() : 0)) & get_mask();
+            }
+        }
+
+    private:
+
+        enum MODE : uint32_t
+        {
+            MODE_POLY_MASK   = (3 << 0),
+            MODE_BIT_RVS_WR  = (1 << 2),
+            MODE_CMPL_WR     = (1 << 3),
+            MODE_BIT_RVS_SUM = (1 << 4),
+            MODE_CMPL_SUM    = (1 << 5)
+        };
+
+        static uint32_t reverse(uint32_t value, const uint32_t width)
+        {
+            uint32_t reversed = 0;
+
+            for(uint32_t bit = 0; bit < width; ++bit, value >>= 1)
+            {
+                reversed = (reversed << 1) | (value & 0x01);
+            }
+
+            return reversed;
+        }
+
+        // CRC-CCITT (0), CRC-16 (1) and CRC-32 (2 / 3)
+        uint32_t get_width()      const { return ((m_mode & MODE_POLY_MASK) >= 2) ? 32 : 16; }
+        uint32_t get_mask()       const { return (get_width() == 32) ? 0xFFFFFFFF : 0xFFFF; }
+        uint32_t get_polynomial() const
+        {
+            switch(m_mode & MODE_POLY_MASK)
+            {
+                case 0:  return 0x1021;
+                case 1:  return 0x8005;
+                default: return 0x04C11DB7;
+            }
+        }
+
+        uint32_t get_sum() const
+        {
+            uint32_t sum = m_sum;
+
+            if((m_mode & MODE_BIT_RVS_SUM) != 0) sum = reverse(sum, get_width());
+            if((m_mode & MODE_CMPL_SUM)    != 0) sum = ~sum & get_mask();
+
+            return sum;
+        }
+
+        uint32_t m_mode { 0 };
+        uint32_t m_sum  { 0xFFFF };     // Reset value of the SEED register
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// GPIO MODEL
+// ----------------------------------------------------------------------------
+
+class GpioModel
+{
+    public:
+
+        void reset()
+        {
+            *this = GpioModel {};
+
+            // Inputs pulled-up by default
+            m_input[0] = 0xFFFFFFFF;
+            m_input[1] = 0xFFFFFFFF;
+        }
+
+        void set_input_level(const std::size_t pin, const bool level)
+        {
+            const uint32_t mask = 1UL << (pin % 32);
+
+            m_input[pin / 32] = (level == true) ? (m_input[pin / 32] | mask) : (m_input[pin / 32] & ~mask);
+        }
+
+        bool get_level(const std::size_t pin) const
+        {
+            return (get_levels(pin / 32) & (1UL << (pin % 32))) != 0;
+        }
+
+        uint32_t read(const uint32_t offset)
+        {
+            if(offset >= offsetof(LPC_GPIO_T, W0) && offset < offsetof(LPC_GPIO_T, W0) + 64 * sizeof(uint32_t))
+            {
+                const std::size_t pin = (offset - offsetof(LPC_GPIO_T, W0)) / sizeof(uint32_t);
+
+                return (get_level(pin) == true) ? 0xFFFFFFFF : 0;
+            }
+
+            const std::size_t port = (offset / sizeof(uint32_t)) & 0x01;
+
+            switch(offset & ~0x07)
+            {
+                case offsetof(LPC_GPIO_T, DIR):  return m_dir[port];
+                case offsetof(LPC_GPIO_T, MASK): return m_mask[port];
+                case offsetof(LPC_GPIO_T, PIN):  return get_levels(port);
+                case offsetof(LPC_GPIO_T, MPIN): return get_levels(port) & ~m_mask[port];
+                case offsetof(LPC_GPIO_T, SET):  return m_output[port];
+                default:                         return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            if(offset >= offsetof(LPC_GPIO_T, W0) && offset < offsetof(LPC_GPIO_T, W0) + 64 * sizeof(uint32_t))
+            {
+                const std::size_t pin  = (offset - offsetof(LPC_GPIO_T, W0)) / sizeof(uint32_t);
+                const uint32_t    mask = 1UL << (pin % 32);
+
+                m_output[pin / 32] = (value != 0) ? (m_output[pin / 32] | mask) : (m_output[pin / 32] & ~mask);
+                return;
+            }
+
+            const std::size_t port = (offset / sizeof(uint32_t)) & 0x01;
+
+            switch(offset & ~0x07)
+            {
+                case offsetof(LPC_GPIO_T, DIR):    m_dir[port]     = value;                                                break;
+                case offsetof(LPC_GPIO_T, MASK):   m_mask[port]    = value;                                                break;
+                case offsetof(LPC_GPIO_T, PIN):    m_output[port]  = value;                                                break;
+                case offsetof(LPC_GPIO_T, MPIN):   m_output[port]  = (m_output[port] & m_mask[port]) | (value & ~m_mask[port]); break;
+                case offsetof(LPC_GPIO_T, SET):    m_output[port] |=  value;                                               break;
+                case offsetof(LPC_GPIO_T, CLR):    m_output[port] &= ~value;                                               break;
+                case offsetof(LPC_GPIO_T, NOT):    m_output[port] ^=  value;                                               break;
+                case offsetof(LPC_GPIO_T, DIRSET): m_dir[port]    |=  value;                                               break;
+                case offsetof(LPC_GPIO_T, DIRCLR): m_dir[port]    &= ~value;                                               break;
+                case offsetof(LPC_GPIO_T, DIRNOT): m_dir[port]    ^=  value;                                               break;
+                default:                                                                                                   break;
+            }
+        }
+
+    private:
+
+        uint32_t get_levels(const std::size_t port) const
+        {
+            return (m_output[port] & m_dir[port]) | (m_input[port] & ~m_dir[port]);
+        }
+
+        uint32_t m_dir[2]    {};
+        uint32_t m_mask[2]   {};
+        uint32_t m_output[2] {};
+        uint32_t m_input[2]  {};
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// PIN INTERRUPT MODEL
+// ----------------------------------------------------------------------------
+
+// The eight channels sample the GPIO level of the pins selected in SYSCON
+// PINTSEL. The standard function latches the edges in RISE / FALL (or checks
+// the active level) and requests the channel IRQ through IST. With PMCTRL
+// SEL_PMATCH set the IRQs are driven by the pattern match product terms
+// instead and IST is not set. Sticky slice edges are cleared by a PMCFG write
+// and an EVENT slice is only true at the edge (the IRQ is pulsed).
+class PinIntModel
+{
+    public:
+
+        void reset() { *this = PinIntModel {}; }
+
+        // Sample the channel inputs, returning the IRQs pulsed by EVENT slices
+        uint32_t update(const GpioModel& gpio)
+        {
+            uint32_t levels     = 0;
+            uint32_t reselected = 0;
+
+            for(std::size_t channel = 0; channel < 8; ++channel)
+            {
+                const uint32_t pin = get_syscon_word(offsetof(LPC_SYSCON_T, PINTSEL) + channel * sizeof(uint32_t)) & 0x3F;
+
+                if(pin != m_pin[channel])
+                {
+                    // New input selected: no edge
+                    m_pin[channel] = pin;
+                    reselected    |= 1UL << channel;
+                }
+
+                if(gpio.get_level(pin) == true) levels |= 1UL << channel;
+            }
+
+            const uint32_t rising  =  levels & ~m_levels & ~reselected;
+            const uint32_t falling = ~levels &  m_levels & ~reselected;
+
+            m_levels = levels;
+
+            m_rise |= rising  & 0xFF;
+            m_fall |= falling & 0xFF;
+
+            uint32_t events = 0;
+
+            for(std::size_t slice = 0; slice < 8; ++slice)
+            {
+                const uint32_t source = 1UL << get_slice_source(slice);
+
+                if((rising  & source) != 0) m_sticky_rise |= 1UL << slice;
+                if((falling & source) != 0) m_sticky_fall |= 1UL << slice;
+                if(((rising | falling) & source) != 0) events |= 1UL << slice;
+            }
+
+            if(is_pattern_match() == false)
+            {
+                return 0;
+            }
+
+            return get_product_terms(events) & ~get_product_terms(0);
+        }
+
+        // IRQs requested by the channels (bit 0 = PININT0)
+        uint32_t get_irq_lines() const
+        {
+            return is_pattern_match() ? get_product_terms(0) : get_ist();
+        }
+
+        uint32_t read(const uint32_t offset) const
+        {
+            switch(offset)
+            {
+                case offsetof(LPC_PIN_INT_T, ISEL):   return m_isel;
+                case offsetof(LPC_PIN_INT_T, IENR):   return m_ienr;
+                case offsetof(LPC_PIN_INT_T, IENF):   return m_ienf;
+                case offsetof(LPC_PIN_INT_T, RISE):   return m_rise;
+                case offsetof(LPC_PIN_INT_T, FALL):   return m_fall;
+                case offsetof(LPC_PIN_INT_T, IST):    return is_pattern_match() ? 0 : get_ist();
+                case offsetof(LPC_PIN_INT_T, PMCTRL): return m_pmctrl | (get_product_terms(0) << 24);
+                case offsetof(LPC_PIN_INT_T, PMSRC):  return m_pmsrc;
+                case offsetof(LPC_PIN_INT_T, PMCFG):  return m_pmcfg;
+                default:                              return 0;
+            }
+        }
+
+        void write(const uint32_t offset, uint32_t value)
+        {
+            value &= (offset < offsetof(LPC_PIN_INT_T, PMCTRL)) ? 0xFF : 0xFFFFFFFF;
+
+            switch(offset)
+            {
+                case offsetof(LPC_PIN_INT_T, ISEL):   m_isel   =  value; break;
+                case offsetof(LPC_PIN_INT_T, IENR):   m_ienr   =  value; break;
+                case offsetof(LPC_PIN_INT_T, SIENR):  m_ienr  |=  value; break;
+                case offsetof(LPC_PIN_INT_T, CIENR):  m_ienr  &= ~value; break;
+                case offsetof(LPC_PIN_INT_T, IENF):   m_ienf   =  value; break;
+                case offsetof(LPC_PIN_INT_T, SIENF):  m_ienf  |=  value; break;
+                case offsetof(LPC_PIN_INT_T, CIENF):  m_ienf  &= ~value; break;
+                case offsetof(LPC_PIN_INT_T, RISE):   m_rise  &= ~value; break;
+                case offsetof(LPC_PIN_INT_T, FALL):   m_fall  &= ~value; break;
+                // Edge mode: clear the detected edges, level mode: toggle the active level
+                case offsetof(LPC_PIN_INT_T, IST):    m_rise  &= ~(value & ~m_isel);
+                                                      m_fall  &= ~(value & ~m_isel);
+                                                      m_ienf  ^=  (value &  m_isel);
+                                                      break;
+                case offsetof(LPC_PIN_INT_T, PMCTRL): m_pmctrl =  value & 0x03; break;
+                case offsetof(LPC_PIN_INT_T, PMSRC):  m_pmsrc  =  value & 0xFFFFFF00; break;
+                case offsetof(LPC_PIN_INT_T, PMCFG):  m_pmcfg  =  value;
+                                                      m_sticky_rise = 0;
+                                                      m_sticky_fall = 0;
+                                                      break;
+                default:                                                    break;
+            }
+        }
+
+    private:
+
+        static constexpr uint32_t NO_PIN { 0xFF };    // Input not sampled yet
+
+        bool is_pattern_match() const { return (m_pmctrl & 0x01) != 0; }
+
+        uint32_t get_slice_source(const std::size_t slice) const { return (m_pmsrc >> (8 + 3 * slice)) & 0x07; }
+        uint32_t get_slice_config(const std::size_t slice) const { return (m_pmcfg >> (8 + 3 * slice)) & 0x07; }
+
+        // Standard function status: edge channels latch the enabled edges,
+        // level channels follow the active level (IENF) when enabled (IENR)
+        uint32_t get_ist() const
+        {
+            const uint32_t edge  = ((m_rise & m_ienr) | (m_fall & m_ienf)) & ~m_isel;
+            const uint32_t level = m_ienr & ~(m_levels ^ m_ienf) & m_isel;
+
+            return (edge | level) & 0xFF;
+        }
+
+        // Product terms state (bit n set if the term ending in slice n is true)
+        uint32_t get_product_terms(const uint32_t events) const
+        {
+            uint32_t terms = 0;
+            bool     term  = true;
+
+            for(std::size_t slice = 0; slice < 8; ++slice)
+            {
+                const bool input = (m_levels & (1UL << get_slice_source(slice))) != 0;
+                const bool rise  = (m_sticky_rise & (1UL << slice)) != 0;
+                const bool fall  = (m_sticky_fall & (1UL << slice)) != 0;
+
+                switch(get_slice_config(slice))
+                {
+                    case 0:                                            break;  // Constant high
+                    case 1: term = term && rise;                       break;
+                    case 2: term = term && fall;                       break;
+                    case 3: term = term && (rise || fall);             break;
+                    case 4: term = term && input;                      break;
+                    case 5: term = term && !input;                     break;
+                    case 6: term = false;                              break;  // Constant low
+                    case 7: term = term && (events & (1UL << slice));  break;  // Event
+                }
+
+                // Endpoint slice: the term requests the IRQ with the slice number
+                if(slice == 7 || (m_pmcfg & (1UL << slice)) != 0)
+                {
+                    if(term == true) terms |= 1UL << slice;
+
+                    term = true;
+                }
+            }
+
+            return terms;
+        }
+
+        uint32_t m_isel        { 0 };
+        uint32_t m_ienr        { 0 };
+        uint32_t m_ienf        { 0 };
+        uint32_t m_rise        { 0 };
+        uint32_t m_fall        { 0 };
+        uint32_t m_pmctrl      { 0 };
+        uint32_t m_pmsrc       { 0 };
+        uint32_t m_pmcfg       { 0 };
+
+        uint32_t m_pin[8]      { NO_PIN, NO_PIN, NO_PIN, NO_PIN, NO_PIN, NO_PIN, NO_PIN, NO_PIN };  // Sampled inputs
+        uint32_t m_levels      { 0 };
+        uint32_t m_sticky_rise { 0 };                       // Sticky edges of each slice
+        uint32_t m_sticky_fall { 0 };
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// DMA MODEL
+// ----------------------------------------------------------------------------
+
+// Register file access without advancing the virtual clock (defined after
+// the simulator state, also used by the DMA model to move data)
+bool     is_register_address(const uintptr_t addr);
+uint32_t read_register(const uintptr_t addr);
+void     write_register(const uintptr_t addr, const uint32_t value);
+
+// NOTE: Descriptors and buffers are addressed with 32 bits (as on the target),
+//       so the host program is linked without PIE and the DMA buffers must be
+//       static (the stack and the heap are above 4 GB).
+class DmaModel
+{
+    public:
+
+        void reset() { *this = DmaModel {}; }
+
+        bool is_irq_asserted() const { return get_intstat() != 0; }
+
+        uint32_t read(const uint32_t offset)
+        {
+            if(offset >= offsetof(LPC_DMA_T, CHANNEL))
+            {
+                const std::size_t channel_index = (offset - offsetof(LPC_DMA_T, CHANNEL)) / sizeof(LPC_DMA_CHANNEL_T);
+
+                if(channel_index >= DMA_NUM_CHANNELS)
+                {
+                    return 0;
+                }
+
+                const Channel& channel = m_channel[channel_index];
+
+                switch(offset % sizeof(LPC_DMA_CHANNEL_T))
+                {
+                    case offsetof(LPC_DMA_CHANNEL_T, CFG):     return channel.cfg;
+                    case offsetof(LPC_DMA_CHANNEL_T, CTLSTAT): return ((channel.valid     == true) ? CTLSTAT_VALIDPENDING : 0)
+                                                                    | ((channel.triggered == true) ? CTLSTAT_TRIG         : 0);
+                    case offsetof(LPC_DMA_CHANNEL_T, XFERCFG): return channel.xfercfg;
+                    default:                                   return 0;
+                }
+            }
+
+            switch(offset)
+            {
+                case offsetof(LPC_DMA_T, CTRL):       return m_ctrl;
+                case offsetof(LPC_DMA_T, INTSTAT):    return get_intstat();
+                case offsetof(LPC_DMA_T, SRAMBASE):   return m_srambase;
+                case offsetof(LPC_DMA_T, ENABLESET0): return m_enabled;
+                case offsetof(LPC_DMA_T, ACTIVE0):    return get_mask([](const Channel& channel) { return channel.valid; });
+                case offsetof(LPC_DMA_T, BUSY0):      return get_mask([](const Channel& channel) { return channel.valid && channel.triggered; });
+                case offsetof(LPC_DMA_T, ERRINT0):    return m_errint;
+                case offsetof(LPC_DMA_T, INTENSET0):  return m_inten;
+                case offsetof(LPC_DMA_T, INTA0):      return m_inta;
+                case offsetof(LPC_DMA_T, INTB0):      return m_intb;
+                default:                              return 0;
+            }
+        }
+
+        void write(const uint32_t offset, const uint32_t value)
+        {
+            if(offset >= offsetof(LPC_DMA_T, CHANNEL))
+            {
+                const std::size_t channel_index = (offset - offsetof(LPC_DMA_T, CHANNEL)) / sizeof(LPC_DMA_CHANNEL_T);
+
+                if(channel_index >= DMA_NUM_CHANNELS)
+                {
+                    return;
+                }
+
+                Channel& channel = m_channel[channel_index];
+
+                switch(offset % sizeof(LPC_DMA_CHANNEL_T))
+                {
+                    case offsetof(LPC_DMA_CHANNEL_T, CFG):     channel.cfg = value; break;
+                    case offsetof(LPC_DMA_CHANNEL_T, XFERCFG): write_xfercfg(channel_index, value); break;
+                    default:                                   break;
+                }
+                return;
+            }
+
+            switch(offset)
+            {
+                case offsetof(LPC_DMA_T, CTRL):       m_ctrl     = value & CTRL_ENABLE; break;
+                case offsetof(LPC_DMA_T, SRAMBASE):   m_srambase = value & ~0x1FFUL;    break;
+                case offsetof(LPC_DMA_T, ENABLESET0): m_enabled |=  value;              break;
+                case offsetof(LPC_DMA_T, ENABLECLR0): m_enabled &= ~value;              break;
+                case offsetof(LPC_DMA_T, ERRINT0):    m_errint  &= ~value;              break;
+                case offsetof(LPC_DMA_T, INTENSET0):  m_inten   |=  value;              break;
+                case offsetof(LPC_DMA_T, INTENCLR0):  m_inten   &= ~value;              break;
+                case offsetof(LPC_DMA_T, INTA0):      m_inta    &= ~value;              break;
+                case offsetof(LPC_DMA_T, INTB0):      m_intb    &= ~value;              break;
+                case offsetof(LPC_DMA_T, SETVALID0):  for_each_channel(value, [](Channel& channel) { channel.valid     = true; }); break;
+                case offsetof(LPC_DMA_T, SETTRIG0):   for_each_channel(value, [](Channel& channel) { channel.triggered = true; }); break;
+                case offsetof(LPC_DMA_T, ABORT0):     for_each_channel(value, [](Channel& channel) { channel.valid     = false;
+                                                                                                     channel.triggered = false; }); break;
+                default:                              break;
+            }
+        }
+
+        // Move every element whose request is asserted (a transfer takes no time)
+        void service()
+        {
+            if((m_ctrl & CTRL_ENABLE) == 0)
+            {
+                return;
+            }
+
+            bool moved;
+
+            do
+            {
+                moved = false;
+
+                for(std::size_t channel_index = 0; channel_index < DMA_NUM_CHANNELS; ++channel_index)
+                {
+                    const Channel& channel = m_channel[channel_index];
+
+                    if((m_enabled & (1UL << channel_index)) != 0 && channel.valid == true && channel.triggered == true
+                       && ((channel.cfg & CFG_PERIPHREQEN) == 0 || is_request_asserted(channel_index) == true))
+                    {
+                        move_element(channel_index);
+                        moved = true;
+                    }
+                }
+            } while(moved == true);
+        }
+
+    private:
+
+        enum Register : uint32_t
+        {
+            CTRL_ENABLE          = (1 << 0),
+            INTSTAT_ACTIVEINT    = (1 << 1),
+            INTSTAT_ACTIVEERRINT = (1 << 2),
+            CFG_PERIPHREQEN      = (1 << 0),
+            CTLSTAT_VALIDPENDING = (1 << 0),
+            CTLSTAT_TRIG         = (1 << 2),
+            XFERCFG_CFGVALID     = (1 << 0),
+            XFERCFG_RELOAD       = (1 << 1),
+            XFERCFG_SWTRIG       = (1 << 2),
+            XFERCFG_CLRTRIG      = (1 << 3),
+            XFERCFG_SETINTA      = (1 << 4),
+            XFERCFG_SETINTB      = (1 << 5)
+        };
+
+        struct Channel
+        {
+            uint32_t cfg             { 0 };
+            uint32_t xfercfg         { 0 };     // XFERCOUNT decrements after each element
+            uint32_t source_end      { 0 };
+            uint32_t destination_end { 0 };
+            uint32_t next            { 0 };
+            bool     valid           { false };
+            bool     triggered       { false };
+        };
+
+        // Descriptor in simulated memory (see lpc84x_dma.hpp)
+        struct Descriptor
+        {
+            uint32_t xfercfg;
+            uint32_t source_end;
+            uint32_t destination_end;
+            uint32_t next;
+        };
+
+        static const Descriptor& get_descriptor(const uint32_t address)
+        {
+            return *reinterpret_cast<const Descriptor*>(static_cast<uintptr_t>(address));
+        }
+
+        uint32_t get_intstat() const
+        {
+            return ((((m_inta | m_intb) & m_inten) != 0) ? INTSTAT_ACTIVEINT    : 0)
+                 | (((m_errint          & m_inten) != 0) ? INTSTAT_ACTIVEERRINT : 0);
+        }
+
+        template <typename Predicate>
+        uint32_t get_mask(Predicate predicate) const
+        {
+            uint32_t mask = 0;
+
+            for(std::size_t channel_index = 0; channel_index < DMA_NUM_CHANNELS; ++channel_index)
+            {
+                if(predicate(m_channel[channel_index]) == true) mask |= 1UL << channel_index;
+            }
+
+            return mask;
+        }
+
+        template <typename Function>
+        void for_each_channel(const uint32_t mask, Function function)
+        {
+            for(std::size_t channel_index = 0; channel_index < DMA_NUM_CHANNELS; ++channel_index)
+            {
+                if((mask & (1UL << channel_index)) != 0) function(m_channel[channel_index]);
+            }
+        }
+
+        // A valid configuration starts from the channel descriptor table entry
+        void write_xfercfg(const std::size_t channel_index, const uint32_t value)
+        {
+            Channel& channel = m_channel[channel_index];
+
+            channel.xfercfg = value;
+
+            if((value & XFERCFG_CFGVALID) != 0)
+            {
+                const Descriptor& entry = get_descriptor(m_srambase + channel_index * sizeof(Descriptor));
+
+                channel.source_end      = entry.source_end;
+                channel.destination_end = entry.destination_end;
+                channel.next            = entry.next;
+                channel.valid           = true;
+            }
+
+            if((value & XFERCFG_SWTRIG) != 0)
+            {
+                channel.triggered = true;
+            }
+        }
+
+        // Peripheral DMA requests: USARTn RX / TX on channels 2n / 2n + 1, SPIn RX / TX on 10 + 2n / 11 + 2n
+        static bool is_request_asserted(const std::size_t channel_index)
+        {
+            constexpr uint32_t USART_STAT_RXRDY = (1 << 0);
+            constexpr uint32_t USART_STAT_TXRDY = (1 << 2);
+            constexpr uint32_t SPI_STAT_RXRDY   = (1 << 0);
+            constexpr uint32_t SPI_STAT_TXRDY   = (1 << 1);
+
+            const bool is_tx = (channel_index % 2) != 0;
+
+            if(channel_index < 10)
+            {
+                const uint32_t stat = read_register(LPC_USART0_BASE + (channel_index / 2) * 0x4000 + offsetof(LPC_USART_T, STAT));
+
+                return (stat & (is_tx ? USART_STAT_TXRDY : USART_STAT_RXRDY)) != 0;
+            }
+
+            if(channel_index < 14)
+            {
+                const uint32_t stat = read_register(LPC_SPI0_BASE + ((channel_index - 10) / 2) * 0x4000 + offsetof(LPC_SPI_T, STAT));
+
+                return (stat & (is_tx ? SPI_STAT_TXRDY : SPI_STAT_RXRDY)) != 0;
+            }
+
+            return false;
+        }
+
+        static uint32_t read_element(const uint32_t address, const uint32_t width_bytes)
+        {
+            if(is_register_address(address) == true)
+            {
+                return read_register(address) & static_cast<uint32_t>((1ULL << (width_bytes * 8)) - 1);
+            }
+
+            uint32_t value = 0;
+            std::memcpy(&value, reinterpret_cast<const void*>(static_cast<uintptr_t>(address)), width_bytes);
+
+            return value;
+        }
+
+        static void write_element(const uint32_t address, const uint32_t width_bytes, const uint32_t value)
+        {
+            if(is_register_address(address) == true)
+            {
+                write_register(address, value);
+                return;
+            }
+
+            std::memcpy(reinterpret_cast<void*>(static_cast<uintptr_t>(address)), &value, width_bytes);
+        }
+
+        // Move one element, reloading the next descriptor (or stopping) when the count is exhausted
+        void move_element(const std::size_t channel_index)
+        {
+            Channel& channel = m_channel[channel_index];
+
+            const uint32_t remaining   = (channel.xfercfg >> 16) & 0x3FF;   // Elements left after this one
+            const uint32_t width_bytes = 1UL << ((channel.xfercfg >> 8) & 0x03);
+
+            const auto get_step = [width_bytes](const uint32_t increment) -> uint32_t
+            {
+                return (increment == 0) ? 0 : width_bytes << (increment - 1);
+            };
+
+            const uint32_t source      = channel.source_end      - remaining * get_step((channel.xfercfg >> 12) & 0x03);
+            const uint32_t destination = channel.destination_end - remaining * get_step((channel.xfercfg >> 14) & 0x03);
+
+            write_element(destination, width_bytes, read_element(source, width_bytes));
+
+            if(remaining > 0)
+            {
+                channel.xfercfg -= 1UL << 16;
+                return;
+            }
+
+            const uint32_t mask = 1UL << channel_index;
+
+            if((channel.xfercfg & XFERCFG_SETINTA) != 0) m_inta |= mask;
+            if((channel.xfercfg & XFERCFG_SETINTB) != 0) m_intb |= mask;
+
+            if((channel.xfercfg & XFERCFG_CLRTRIG) != 0)
+            {
+                channel.triggered = false;
+            }
+
+            if((channel.xfercfg & XFERCFG_RELOAD) != 0 && channel.next != 0)
+            {
+                const Descriptor& next = get_descriptor(channel.next);
+
+                channel.xfercfg         = next.xfercfg;
+                channel.source_end      = next.source_end;
+                channel.destination_end = next.destination_end;
+                channel.next            = next.next;
+                channel.valid           = (next.xfercfg & XFERCFG_CFGVALID) != 0;
+
+                if((next.xfercfg & XFERCFG_SWTRIG) != 0) channel.triggered = true;
+            }
+            else
+            {
+                channel.valid = false;
+            }
+        }
+
+        uint32_t m_ctrl     { 0 };
+        uint32_t m_srambase { 0 };
+        uint32_t m_enabled  { 0 };
+        uint32_t m_inten    { 0 };
+        uint32_t m_inta     { 0 };
+        uint32_t m_intb     { 0 };
+        uint32_t m_errint   { 0 };
+
+        Channel  m_channel[DMA_NUM_CHANNELS];
+};
+
+
+
+
+// ----------------------------------------------------------------------------
+// SIMULATOR STATE
+// ----------------------------------------------------------------------------
+
+__attribute__ ((init_priority(101))) UsartModel  g_usart[5];
+__attribute__ ((init_priority(101))) SpiModel    g_spi[2];
+__attribute__ ((init_priority(101))) MrtModel    g_mrt;
+__attribute__ ((init_priority(101))) SctModel    g_sct;
+__attribute__ ((init_priority(101))) CrcModel    g_crc;
+__attribute__ ((init_priority(101))) GpioModel   g_gpio;
+__attribute__ ((init_priority(101))) PinIntModel g_pin_int;
+__attribute__ ((init_priority(101))) DmaModel    g_dma;
+
+int64_t    g_cycles           { 0 };
+uint64_t   g_time_ns          { 0 };
+uint64_t   g_time_remainder   { 0 };    // Fraction of nanosecond (in cycles * 1e9 units)
+
+uint32_t   g_primask          { 0 };
+uint32_t   g_nvic_enabled     { 0 };
+uint32_t   g_nvic_pending     { 0 };    // Software (and edge) pending interrupts
+uint32_t   g_nvic_active      { 0 };
+int32_t    g_execution_priority { 256 }; // Thread mode (lower than any interrupt priority)
+
+UsartModel* get_usart_model(const uint32_t apb_block)
+{
+    const uint32_t first = static_cast<uint32_t>(ApbBlock::USART0);
+    const uint32_t last  = static_cast<uint32_t>(ApbBlock::USART4);
+
+    return (apb_block >= first && apb_block <= last) ? &g_usart[apb_block - first] : nullptr;
+}
+
+SpiModel* get_spi_model(const uint32_t apb_block)
+{
+    if(apb_block == static_cast<uint32_t>(ApbBlock::SPI0)) return &g_spi[0];
+    if(apb_block == static_cast<uint32_t>(ApbBlock::SPI1)) return &g_spi[1];
+
+    return nullptr;
+}
+
+// Sample the pin interrupt inputs after a pin level change (EVENT slice
+// pulses are latched by the NVIC)
+void update_pin_interrupts()
+{
+    g_nvic_pending |= g_pin_int.update(g_gpio) << PININT0_IRQn;
+}
+
+uint32_t get_irq_lines()
+{
+    uint32_t lines = 0;
+
+    for(const auto& usart : g_usart)
+    {
+        if(usart.is_irq_asserted() == true) lines |= 1UL << usart.get_irqn();
+    }
+
+    for(const auto& spi : g_spi)
+    {
+        if(spi.is_irq_asserted() == true) lines |= 1UL << spi.get_irqn();
+    }
+
+    if(g_mrt.is_irq_asserted() == true) lines |= 1UL << MRT_IRQn;
+    if(g_sct.is_irq_asserted() == true) lines |= 1UL << SCT_IRQn;
+    if(g_dma.is_irq_asserted() == true) lines |= 1UL << DMA_IRQn;
+
+    lines |= g_pin_int.get_irq_lines() << PININT0_IRQn;
+
+    return lines;
+}
+
+int32_t get_irq_priority(const uint32_t irq)
+{
+    const uint32_t ip = get_word(xarmlib_host_scs_memory, 0x100 + offsetof(NVIC_Type, IP) + (irq / 4) * sizeof(uint32_t));
+
+    return static_cast<int32_t>((ip >> ((irq % 4) * 8)) & 0xFF);
+}
+
+// Take every enabled pending interrupt with enough priority (nesting by priority)
+void dispatch_interrupts()
+{
+    while(g_primask == 0)
+    {
+        const uint32_t pending = (get_irq_lines() | g_nvic_pending) & g_nvic_enabled & ~g_nvic_active;
+
+        int32_t selected_irq      = -1;
+        int32_t selected_priority = g_execution_priority;
+
+        for(uint32_t irq = 0; irq < 32; ++irq)
+        {
+            if((pending & (1UL << irq)) != 0 && get_irq_priority(irq) < selected_priority)
+            {
+                selected_irq      = static_cast<int32_t>(irq);
+                selected_priority = get_irq_priority(irq);
+            }
+        }
+
+        if(selected_irq < 0)
+        {
+            return;
+        }
+
+        const uint32_t mask               = 1UL << selected_irq;
+        const int32_t  preempted_priority = g_execution_priority;
+
+        g_nvic_pending       &= ~mask;
+        g_nvic_active        |=  mask;
+        g_execution_priority  =  selected_priority;
+
+        // Handlers installed in the RAM vector table take precedence (the
+        // flash vector table of the host program is empty)
+        const IrqHandler handler = VectorTable::get_handler(static_cast<IRQn_Type>(selected_irq));
+
+        if(handler != nullptr)
+        {
+            handler();
+        }
+        else
+        {
+            IRQ_HANDLERS[selected_irq]();
+        }
+
+        g_execution_priority  =  preempted_priority;
+        g_nvic_active        &= ~mask;
+    }
+}
+
+int64_t get_cycles_to_next_event()
+{
+    int64_t cycles = NO_EVENT;
+
+    for(const auto& usart : g_usart)
+    {
+        const int64_t usart_cycles = usart.get_cycles_to_next_event();
+        if(usart_cycles < cycles) cycles = usart_cycles;
+    }
+
+    for(const auto& spi : g_spi)
+    {
+        const int64_t spi_cycles = spi.get_cycles_to_next_event();
+        if(spi_cycles < cycles) cycles = spi_cycles;
+    }
+
+    const int64_t mrt_cycles = g_mrt.get_cycles_to_next_event();
+    if(mrt_cycles < cycles) cycles = mrt_cycles;
+
+    const int64_t sct_cycles = g_sct.get_cycles_to_next_event();
+    if(sct_cycles < cycles) cycles = sct_cycles;
+
+    return cycles;
+}
+
+void advance_models(const int64_t cycles)
+{
+    for(auto& usart : g_usart) usart.advance(cycles);
+    for(auto& spi   : g_spi)   spi.advance(cycles);
+
+    g_mrt.advance(cycles);
+    g_sct.advance(cycles);
+
+    // DMA requests follow the peripheral state
+    g_dma.service();
+
+    update_pin_interrupts();
+
+    // Virtual time (the core clock frequency may change at runtime)
+    const uint64_t frequency = (SystemCoreClock != 0) ? SystemCoreClock : 12000000;
+
+    g_time_remainder += static_cast<uint64_t>(cycles) * 1000000000ULL;
+    g_time_ns        += g_time_remainder / frequency;
+    g_time_remainder %= frequency;
+
+    g_cycles += cycles;
+}
+
+// Advance the virtual clock event by event, dispatching the interrupts on time
+void run(int64_t cycles)
+{
+    while(cycles > 0)
+    {
+        int64_t step = get_cycles_to_next_event();
+
+        if(step > cycles) step = cycles;
+        if(step < 1)      step = 1;
+
+        advance_models(step);
+        cycles -= step;
+
+        dispatch_interrupts();
+    }
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// REGISTER FILE
+// ----------------------------------------------------------------------------
+
+bool is_register_address(const uintptr_t addr)
+{
+    return (addr >= LPC_APB_BASE  && addr < LPC_APB_BASE  + sizeof(xarmlib_host_apb_memory))
+        || (addr >= LPC_AHB_BASE  && addr < LPC_AHB_BASE  + sizeof(xarmlib_host_ahb_memory))
+        || (addr >= LPC_GPIO_BASE && addr < LPC_GPIO_BASE + sizeof(xarmlib_host_gpio_memory))
+        || (addr >= SCS_BASE      && addr < SCS_BASE      + sizeof(xarmlib_host_scs_memory));
+}
+
+uint32_t read_register(const uintptr_t addr)
+{
+    uint32_t value;
+
+    if(addr >= LPC_APB_BASE && addr < LPC_APB_BASE + sizeof(xarmlib_host_apb_memory))
+    {
+        const uint32_t offset    = static_cast<uint32_t>(addr - LPC_APB_BASE);
+        const uint32_t block     = offset >> 14;
+        const uint32_t block_reg = offset & 0x3FFF;
+
+        if(UsartModel* usart = get_usart_model(block))
+        {
+            value = usart->read(block_reg);
+        }
+        else if(SpiModel* spi = get_spi_model(block))
+        {
+            value = spi->read(block_reg);
+        }
+        else if(block == static_cast<uint32_t>(ApbBlock::MRT))
+        {
+            value = g_mrt.read(block_reg);
+        }
+        else if(block == static_cast<uint32_t>(ApbBlock::SYSCON) && block_reg == offsetof(LPC_SYSCON_T, SYSPLLSTAT))
+        {
+            value = 1;      // System PLL always locked
+        }
+        else
+        {
+            value = get_word(xarmlib_host_apb_memory, offset);
+        }
+    }
+    else if(addr >= LPC_AHB_BASE && addr < LPC_AHB_BASE + sizeof(xarmlib_host_ahb_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - LPC_AHB_BASE);
+
+        if((offset >> 14) == static_cast<uint32_t>(AhbBlock::CRC))
+        {
+            value = g_crc.read(offset & 0x3FFF);
+        }
+        else if((offset >> 14) == static_cast<uint32_t>(AhbBlock::SCT))
+        {
+            value = g_sct.read(offset & 0x3FFF);
+        }
+        else if((offset >> 14) == static_cast<uint32_t>(AhbBlock::DMA))
+        {
+            value = g_dma.read(offset & 0x3FFF);
+        }
+        else
+        {
+            value = get_word(xarmlib_host_ahb_memory, offset);
+        }
+    }
+    else if(addr >= LPC_GPIO_BASE && addr < LPC_GPIO_BASE + sizeof(xarmlib_host_gpio_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - LPC_GPIO_BASE);
+
+        value = (offset < 0x4000) ? g_gpio.read(offset) : g_pin_int.read(offset - 0x4000);
+    }
+    else if(addr >= SCS_BASE && addr < SCS_BASE + sizeof(xarmlib_host_scs_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - SCS_BASE);
+
+        switch(offset)
+        {
+            case SCS_NVIC_ISER:
+            case SCS_NVIC_ICER: value = g_nvic_enabled;                    break;
+            case SCS_NVIC_ISPR:
+            case SCS_NVIC_ICPR: value = get_irq_lines() | g_nvic_pending;  break;
+            default:            value = get_word(xarmlib_host_scs_memory, offset); break;
+        }
+    }
+    else
+    {
+        std::fprintf(stderr, "xarmlib host simulator: read from unmapped register %p\n", reinterpret_cast<void*>(addr));
+        std::abort();
+    }
+
+    return value;
+}
+
+void write_register(const uintptr_t addr, const uint32_t value)
+{
+    if(addr >= LPC_APB_BASE && addr < LPC_APB_BASE + sizeof(xarmlib_host_apb_memory))
+    {
+        const uint32_t offset    = static_cast<uint32_t>(addr - LPC_APB_BASE);
+        const uint32_t block     = offset >> 14;
+        const uint32_t block_reg = offset & 0x3FFF;
+
+        if(UsartModel* usart = get_usart_model(block))
+        {
+            usart->write(block_reg, value);
+        }
+        else if(SpiModel* spi = get_spi_model(block))
+        {
+            spi->write(block_reg, value);
+        }
+        else if(block == static_cast<uint32_t>(ApbBlock::MRT))
+        {
+            g_mrt.write(block_reg, value);
+        }
+        else
+        {
+            get_word(xarmlib_host_apb_memory, offset) = value;
+        }
+    }
+    else if(addr >= LPC_AHB_BASE && addr < LPC_AHB_BASE + sizeof(xarmlib_host_ahb_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - LPC_AHB_BASE);
+
+        if((offset >> 14) == static_cast<uint32_t>(AhbBlock::CRC))
+        {
+            g_crc.write(offset & 0x3FFF, value);
+        }
+        else if((offset >> 14) == static_cast<uint32_t>(AhbBlock::SCT))
+        {
+            g_sct.write(offset & 0x3FFF, value);
+        }
+        else if((offset >> 14) == static_cast<uint32_t>(AhbBlock::DMA))
+        {
+            g_dma.write(offset & 0x3FFF, value);
+        }
+        else
+        {
+            get_word(xarmlib_host_ahb_memory, offset) = value;
+        }
+    }
+    else if(addr >= LPC_GPIO_BASE && addr < LPC_GPIO_BASE + sizeof(xarmlib_host_gpio_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - LPC_GPIO_BASE);
+
+        if(offset < 0x4000)
+        {
+            g_gpio.write(offset, value);
+        }
+        else
+        {
+            g_pin_int.write(offset - 0x4000, value);
+        }
+
+        update_pin_interrupts();
+    }
+    else if(addr >= SCS_BASE && addr < SCS_BASE + sizeof(xarmlib_host_scs_memory))
+    {
+        const uint32_t offset = static_cast<uint32_t>(addr - SCS_BASE);
+
+        switch(offset)
+        {
+            case SCS_NVIC_ISER: g_nvic_enabled |=  value;                      break;
+            case SCS_NVIC_ICER: g_nvic_enabled &= ~value;                      break;
+            case SCS_NVIC_ISPR: g_nvic_pending |=  value;                      break;
+            case SCS_NVIC_ICPR: g_nvic_pending &= ~value;                      break;
+            default:            get_word(xarmlib_host_scs_memory, offset) = value; break;
+        }
+    }
+    else
+    {
+        std::fprintf(stderr, "xarmlib host simulator: write to unmapped register %p\n", reinterpret_cast<void*>(addr));
+        std::abort();
+    }
+}
+
+
+
+
+// ----------------------------------------------------------------------------
+// ROM API
+// ----------------------------------------------------------------------------
+
+void rom_set_pll(uint32_t[], uint32_t resp[]) { resp[0] = 0; }
+void rom_set_power(uint32_t[], uint32_t resp[]) { resp[0] = 0; }
+void rom_power_mode_configure(uint32_t, uint32_t) {}
+void rom_set_aclkgate(uint32_t) {}
+uint32_t rom_get_aclkgate() { return 0; }
+
+// FRO oscillator control register FRO frequency selection (FROOSCCTRL[1:0])
+void rom_set_fro_frequency(uint32_t frequency)
+{
+    const uint32_t selection = (frequency == 18000) ? 0 : ((frequency == 30000) ? 2 : 1);
+
+    uint32_t& frooscctrl = get_syscon_word(offsetof(LPC_SYSCON_T, FROOSCCTRL));
+
+    frooscctrl = (frooscctrl & ~0x03UL) | selection;
+}
+
+int32_t  rom_idiv(int32_t numerator, int32_t denominator)   { return numerator / denominator; }
+uint32_t rom_uidiv(uint32_t numerator, uint32_t denominator) { return numerator / denominator; }
+
+LPC_IDIV_RETURN_T rom_idivmod(int32_t numerator, int32_t denominator)
+{
+    return { numerator / denominator, numerator % denominator };
+}
+
+LPC_UIDIV_RETURN_T rom_uidivmod(uint32_t numerator, uint32_t denominator)
+{
+    return { numerator / denominator, numerator % denominator };
+}
+
+const LPC_ROM_PWR_API_T g_rom_pwr_api { rom_set_pll, rom_set_power, rom_set_fro_frequency, rom_power_mode_configure, rom_set_aclkgate, rom_get_aclkgate };
+const LPC_ROM_DIV_API_T g_rom_div_api { rom_idiv, rom_uidiv, rom_idivmod, rom_uidivmod };
+const LPC_ROM_API_T     g_rom_api     { {}, &g_rom_pwr_api, &g_rom_div_api, {} };
+
+
+
+
+// ----------------------------------------------------------------------------
+// STARTUP
+// ----------------------------------------------------------------------------
+
+// Reset the simulated MCU and run the startup hooks (clock setup and ticker)
+void reset_mcu()
+{
+    std::fill(std::begin(xarmlib_host_scs_memory),  std::end(xarmlib_host_scs_memory),  0);
+    std::fill(std::begin(xarmlib_host_apb_memory),  std::end(xarmlib_host_apb_memory),  0);
+    std::fill(std::begin(xarmlib_host_ahb_memory),  std::end(xarmlib_host_ahb_memory),  0);
+    std::fill(std::begin(xarmlib_host_gpio_memory), std::end(xarmlib_host_gpio_memory), 0);
+
+    constexpr IRQn_Type usart_irqns[5] = { USART0_IRQn, USART1_IRQn, USART2_IRQn, PININT6_USART3_IRQn, PININT7_USART4_IRQn };
+
+    for(std::size_t index = 0; index < 5; ++index)
+    {
+        g_usart[index].reset(index, usart_irqns[index]);
+    }
+
+    g_spi[0].reset(SPI0_IRQn);
+    g_spi[1].reset(SPI1_IRQn);
+    g_mrt.reset();
+    g_sct.reset();
+    g_crc.reset();
+    g_gpio.reset();
+    g_pin_int.reset();
+    g_dma.reset();
+
+    g_cycles               = 0;
+    g_time_ns              = 0;
+    g_time_remainder       = 0;
+    g_primask              = 0;
+    g_nvic_enabled         = 0;
+    g_nvic_pending         = 0;
+    g_nvic_active          = 0;
+    g_execution_priority   = 256;
+
+    // Reset value: FRO at 24 MHz (FRO direct output disabled)
+    get_syscon_word(offsetof(LPC_SYSCON_T, FROOSCCTRL)) = 0x01;
+
+    SystemCoreClock = 0;
+
+    mcu_startup_initialize_hardware_early();
+    mcu_startup_initialize_hardware();
+}
+
+// The target runs the startup hooks before the static constructors (that may
+// already use the drivers), so do the same ahead of the default priority ones
+struct Startup
+{
+    Startup() { reset_mcu(); }
+};
+
+__attribute__ ((init_priority(102))) const Startup g_startup;
+
+
+
+
+} // namespace
+
+
+
+
+// ----------------------------------------------------------------------------
+// PUBLIC MEMBER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+void HostSimulator::run_for(const std::chrono::microseconds duration)
+{
+    const uint64_t frequency = (SystemCoreClock != 0) ? SystemCoreClock : 12000000;
+
+    run(static_cast<int64_t>(duration.count() * frequency / 1000000));
+}
+
+void HostSimulator::run_cycles(const int64_t cycles)
+{
+    run(cycles);
+}
+
+int64_t HostSimulator::get_cycles()
+{
+    return g_cycles;
+}
+
+std::chrono::microseconds HostSimulator::get_time()
+{
+    return std::chrono::microseconds(static_cast<int64_t>(g_time_ns / 1000));
+}
+
+void HostSimulator::receive_usart_data(const std::size_t usart_index, const gsl::span<const uint8_t> data)
+{
+    assert(usart_index < 5);
+
+    for(const auto character : data)
+    {
+        g_usart[usart_index].receive(character);
+    }
+}
+
+void HostSimulator::receive_usart_address(const std::size_t usart_index, const uint8_t address)
+{
+    assert(usart_index < 5);
+
+    g_usart[usart_index].receive(0x100 | address);
+}
+
+int32_t HostSimulator::read_usart_transmitted(const std::size_t usart_index, gsl::span<uint8_t> buffer)
+{
+    assert(usart_index < 5);
+
+    return g_usart[usart_index].read_transmitted(buffer);
+}
+
+void HostSimulator::set_spi_responder(const std::size_t spi_index, const SpiResponder& responder)
+{
+    assert(spi_index < 2);
+
+    g_spi[spi_index].set_responder(responder);
+}
+
+bool HostSimulator::is_spi_selected(const std::size_t spi_index)
+{
+    assert(spi_index < 2);
+
+    return g_spi[spi_index].is_ssel_asserted();
+}
+
+void HostSimulator::set_pin_input_level(const Pin::Name pin_name, const bool level)
+{
+    assert(pin_name != Pin::Name::NC);
+
+    g_gpio.set_input_level(static_cast<std::size_t>(pin_name), level);
+
+    update_pin_interrupts();
+}
+
+bool HostSimulator::get_pin_level(const Pin::Name pin_name)
+{
+    assert(pin_name != Pin::Name::NC);
+
+    return g_gpio.get_level(static_cast<std::size_t>(pin_name));
+}
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
+
+
+
+using namespace xarmlib::targets::lpc84x;
+
+// ----------------------------------------------------------------------------
+// SIMULATOR HOOKS (C FUNCTIONS CALLED BY THE HOST CORE AND CMSIS HEADERS)
+// ----------------------------------------------------------------------------
+
+extern "C"
+{
+
+const LPC_ROM_API_T* const xarmlib_host_rom_api = &g_rom_api;
+
+uint32_t xarmlib_host_read_register(const volatile void* address)
+{
+    const uint32_t value = read_register(reinterpret_cast<uintptr_t>(address));
+
+    run(HostSimulator::REGISTER_ACCESS_CYCLES);
+
+    return value;
+}
+
+void xarmlib_host_write_register(volatile void* address, uint32_t value)
+{
+    write_register(reinterpret_cast<uintptr_t>(address), value);
+
+    run(HostSimulator::REGISTER_ACCESS_CYCLES);
+}
+
+// NOTE: Only the CRC engine WR_DATA register takes byte wide writes
+void xarmlib_host_write_register_byte(volatile void* address, uint8_t value)
+{
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(address);
+
+    if(addr == reinterpret_cast<uintptr_t>(&LPC_CRC->WR_DATA))
+    {
+        g_crc.write_byte(value);
+    }
+    else
+    {
+        std::fprintf(stderr, "xarmlib host simulator: byte write to unsupported register %p\n", address);
+        std::abort();
+    }
+
+    run(HostSimulator::REGISTER_ACCESS_CYCLES);
+}
+
+uint32_t xarmlib_host_get_primask(void)
+{
+    return g_primask;
+}
+
+void xarmlib_host_set_primask(uint32_t primask)
+{
+    g_primask = primask & 0x01;
+
+    dispatch_interrupts();
+}
+
+void xarmlib_host_consume_cycles(uint32_t cycles)
+{
+    run(cycles);
+}
+
+// NOTE: Returns after one cycle when no event is scheduled (WFI may wake up spuriously)
+void xarmlib_host_wait_for_interrupt(void)
+{
+    const int64_t cycles = get_cycles_to_next_event();
+
+    run((cycles == NO_EVENT) ? 1 : cycles);
+}
+
+void xarmlib_host_system_reset(void)
+{
+    std::fprintf(stderr, "xarmlib host simulator: system reset requested\n");
+    std::abort();
+}
+
+// NOTE: IAP (flash / FAIM programming) isn't simulated
+void xarmlib_host_iap_entry(uint32_t[], uint32_t result[])
+{
+    result[0] = 1;  // INVALID_COMMAND
+}
+
+// Reset handler entry point (referenced by the vector table only, the host
+// program starts at 'main()' after the startup above)
+__attribute__ ((noreturn))
+void mcu_startup()
+{
+    extern int main(void);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+    // ISO C++ forbids taking address of function '::main' [-Wpedantic]
+    std::exit(main());
+#pragma GCC diagnostic pop
+}
+
+} // extern "C"
+
+
+
+
+// The host program allocates from the host heap (the heap operators of
+// 'heap_operators.cpp' aren't built), so there are no statistics to report
+xarmlib::MemoryStats xarmlib::get_heap_stats()
+{
+    return MemoryStats {};
+}
+
+
+
+
+#endif // __TARGET_HOST_SIMULATION__
@@ -34,6 +34,7 @@
 #ifdef __LPC84X__
 
 #include "targets/LPC84x/lpc84x_syscon_clock.hpp"
+#include "targets/LPC84x/lpc84x_timer.hpp"
 
 extern "C"
 {
@@ -54,6 +55,9 @@ void SystemCoreClockUpdate()
 {
     // Store the clock frequency in the SystemCoreClock global RAM location
     SystemCoreClock = xarmlib::targets::lpc84x::Clock::get_system_clock_frequency();
+
+    // Timer conversions of the new clock frequency
+    xarmlib::targets::lpc84x::Timer::update_tick_converter();
 }
 
 
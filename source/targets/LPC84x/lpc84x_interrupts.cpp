@@ -80,38 +80,38 @@ void SysTick_Handler   (void);
 // ----------------------------------------------------------------------------
 
 // Chip level (LPC84x) peripheral handlers
-void SPI0_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void SPI1_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void DAC0_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void USART0_IRQHandler        (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void USART1_IRQHandler        (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void USART2_IRQHandler        (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void FAIM_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void I2C1_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void I2C0_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void SCT_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void MRT_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void CMP_CAPT_IRQHandler      (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void WDT_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void BOD_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void FLASH_IRQHandler         (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void WKT_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void ADC_SEQA_IRQHandler      (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void ADC_SEQB_IRQHandler      (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void ADC_THCMP_IRQHandler     (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void ADC_OVR_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void DMA_IRQHandler           (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void I2C2_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void I2C3_IRQHandler          (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void CTIMER_IRQHandler        (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT0_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT1_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT2_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT3_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT4_IRQHandler       (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT5_DAC1_IRQHandler  (void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT6_USART3_IRQHandler(void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
-void PININT7_USART4_IRQHandler(void) __attribute__ ((weak, alias("IRQ_DefaultHandler")));
+void SPI0_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void SPI1_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void DAC0_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void USART0_IRQHandler        (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void USART1_IRQHandler        (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void USART2_IRQHandler        (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void FAIM_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void I2C1_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void I2C0_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void SCT_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void MRT_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void CMP_CAPT_IRQHandler      (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void WDT_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void BOD_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void FLASH_IRQHandler         (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void WKT_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void ADC_SEQA_IRQHandler      (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void ADC_SEQB_IRQHandler      (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void ADC_THCMP_IRQHandler     (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void ADC_OVR_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void DMA_IRQHandler           (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void I2C2_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void I2C3_IRQHandler          (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void CTIMER_IRQHandler        (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT0_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT1_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT2_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT3_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT4_IRQHandler       (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT5_DAC1_IRQHandler  (void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT6_USART3_IRQHandler(void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
+void PININT7_USART4_IRQHandler(void) __attribute__ ((weak, nothrow, alias("IRQ_DefaultHandler")));
 
 
 
@@ -185,7 +185,9 @@ const IRQ_HandlerPtr __interrupts[] =
 
 
 // Define breakpoint macro for debug
-#ifdef DEBUG
+#if defined DEBUG && defined __TARGET_HOST_SIMULATION__
+#define __DEBUG_BKPT()      __builtin_trap()
+#elif defined DEBUG
 #define __DEBUG_BKPT()      asm volatile ("bkpt 0")
 #else
 #define __DEBUG_BKPT()
@@ -199,9 +201,12 @@ const IRQ_HandlerPtr __interrupts[] =
 // a specific handler is not present in the application code.
 // When in DEBUG, triggers a debug exception to clearly notify
 // the user of the exception and help identify the cause.
+// NOTE: Not declared 'noreturn', since the weak handlers aliased to it (and
+//       the application handlers that replace them) do return. The aliases
+//       are declared 'nothrow' like the handler (no exceptions are used).
 // ----------------------------------------------------------------------------
 
-__attribute__ ((section(".after_vectors"), noreturn))
+__attribute__ ((section(".after_vectors")))
 void IRQ_DefaultHandler(void)
 {
     __DEBUG_BKPT();
@@ -33,6 +33,7 @@
 
 #ifdef __LPC84X__
 
+#include "targets/LPC84x/lpc84x_pin_interrupt.hpp"
 #include "targets/LPC84x/lpc84x_usart.hpp"
 
 
@@ -53,18 +54,26 @@ extern "C" void CMP_CAPT_IRQHandler(void)
 
 // Pin Interrupt 5 / DAC1 shared handler
 extern "C" void PININT5_DAC1_IRQHandler(void)
-{}
+{
+    const int32_t yield = PinInterrupt::irq_handler(PinInterrupt::Channel::CH5);
+
+#ifdef XARMLIB_USE_FREERTOS
+    portEND_SWITCHING_ISR(yield);
+#else
+    (void)yield;
+#endif
+}
 
 
 
 
 // Pin Interrupt 6 / USART3 shared handler
-extern "C" void PININT6_USART3_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void PININT6_USART3_IRQHandler(void)
 {
-    int32_t yield = 0;
+    int32_t yield = PinInterrupt::irq_handler(PinInterrupt::Channel::CH6);
 
 #ifdef __LPC845__
-    yield = Usart::irq_handler(Usart::Name::USART3);
+    yield |= Usart::irq_handler(Usart::Name::USART3);
 #endif
 
 #ifdef XARMLIB_USE_FREERTOS
@@ -78,12 +87,12 @@ extern "C" void PININT6_USART3_IRQHandler(void)
 
 
 // Pin Interrupt 7 / USART4 shared handler
-extern "C" void PININT7_USART4_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void PININT7_USART4_IRQHandler(void)
 {
-    int32_t yield = 0;
+    int32_t yield = PinInterrupt::irq_handler(PinInterrupt::Channel::CH7);
 
 #ifdef __LPC845__
-    yield = Usart::irq_handler(Usart::Name::USART4);
+    yield |= Usart::irq_handler(Usart::Name::USART4);
 #endif
 
 #ifdef XARMLIB_USE_FREERTOS
@@ -39,6 +39,7 @@
 #include "targets/LPC84x/lpc84x_swm.hpp"
 #include "targets/LPC84x/lpc84x_syscon_clock.hpp"
 #include "targets/LPC84x/lpc84x_syscon_power.hpp"
+#include "targets/LPC84x/lpc84x_us_ticker.hpp"
 
 namespace xarmlib
 {
@@ -164,13 +165,12 @@ static inline void mcu_startup_set_xtal_clock()
 // PUBLIC FUNCTIONS
 // ----------------------------------------------------------------------------
 
+// NOTE: Runs right after reset, before the .data / .bss sections are
+//       initialized, so it must not use any RAM variable. The clock is
+//       ramped up here to run the memory initialization and the static
+//       constructors at full speed (SystemCoreClock is only updated in
+//       'mcu_startup_initialize_hardware()').
 void mcu_startup_initialize_hardware_early()
-{}
-
-
-
-
-void mcu_startup_initialize_hardware()
 {
     // ------------------------------------------------------------------------
     // Helder Parracho @ 20 March 2018
@@ -193,6 +193,29 @@ void mcu_startup_initialize_hardware()
     BrownOut::enable_reset(BrownOut::Level::LEVEL_3);
     // ------------------------------------------------------------------------
 
+    // Enable Switch Matrix clock
+    Clock::enable(Clock::Peripheral::SWM);
+    // Enable IOCON clock
+    Clock::enable(Clock::Peripheral::IOCON);
+
+    if(XARMLIB_SYSTEM_CLOCK <= System::Clock::OSC_30MHZ)
+    {
+        mcu_startup_set_fro_clock();
+    }
+    else
+    {
+        mcu_startup_set_xtal_clock();
+    }
+}
+
+
+
+
+void mcu_startup_initialize_hardware()
+{
+    // NOTE: The host simulator has no ROM integer divide routines
+    //       and no FAIM, so these steps only run on the target.
+#if !defined __TARGET_HOST_SIMULATION__
     // Patch the AEABI integer divide functions to use MCU's romdivide library
     ROMDIVIDE_PatchAeabiIntegerDivide();
 
@@ -205,6 +228,7 @@ void mcu_startup_initialize_hardware()
                   XARMLIB_CONFIG_FAIM_ISP_UART0_TX_PIN,
                   XARMLIB_CONFIG_FAIM_ISP_UART0_RX_PIN,
                   XARMLIB_CONFIG_FAIM_GPIO_PINS);
+#endif
 
     // Disable clock input sources that aren't needed
     Clock::set_clockout_source(Clock::ClockoutSource::NONE);
@@ -213,23 +237,12 @@ void mcu_startup_initialize_hardware()
     Clock::set_frg_clock_source(Clock::FrgClockSelect::FRG0, Clock::FrgClockSource::NONE);
     Clock::set_frg_clock_source(Clock::FrgClockSelect::FRG1, Clock::FrgClockSource::NONE);
 
-    // Enable Switch Matrix clock
-    Clock::enable(Clock::Peripheral::SWM);
-    // Enable IOCON clock
-    Clock::enable(Clock::Peripheral::IOCON);
-
-    if(XARMLIB_SYSTEM_CLOCK <= System::Clock::OSC_30MHZ)
-    {
-        mcu_startup_set_fro_clock();
-    }
-    else
-    {
-        mcu_startup_set_xtal_clock();
-    }
-
     // Call the CSMSIS system clock routine to store the clock
     // frequency in the SystemCoreClock global RAM location.
     SystemCoreClockUpdate();
+
+    // Start the microseconds ticker (depends on the system clock frequency)
+    UsTicker::initialize();
 }
 
 
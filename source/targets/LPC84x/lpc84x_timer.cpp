@@ -35,6 +35,29 @@
 
 #include "targets/LPC84x/lpc84x_timer.hpp"
 
+namespace xarmlib
+{
+namespace targets
+{
+namespace lpc84x
+{
+
+
+
+
+// ----------------------------------------------------------------------------
+// PRIVATE STATIC MEMBER VARIABLES
+// ----------------------------------------------------------------------------
+
+TickConverter Timer::m_tick_converter;
+
+
+
+
+} // namespace lpc84x
+} // namespace targets
+} // namespace xarmlib
+
 
 
 
@@ -44,7 +67,7 @@ using namespace xarmlib::targets::lpc84x;
 // IRQ HANDLER
 // ----------------------------------------------------------------------------
 
-extern "C" void MRT_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void MRT_IRQHandler(void)
 {
     const int32_t yield = Timer::irq_handler();
 
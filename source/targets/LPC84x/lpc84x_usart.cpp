@@ -1,6 +1,6 @@
 // ----------------------------------------------------------------------------
 // @file    lpc84x_usart.cpp
-// @brief   NXP LPC84x USART class (takes control of FRG0).
+// @brief   NXP LPC84x USART class (clocked by FRG0, FRG1 or the main clock).
 // @notes   Synchronous mode not implemented.
 // @date    28 June 2018
 // ----------------------------------------------------------------------------
@@ -34,66 +34,15 @@
 
 #ifdef __LPC84X__
 
-#include "xarmlib_config.hpp"
 #include "targets/LPC84x/lpc84x_usart.hpp"
 
-namespace xarmlib
-{
-namespace targets
-{
-namespace lpc84x
-{
-
-
-
-
-// ----------------------------------------------------------------------------
-// PRIVATE MEMBER FUNCTIONS
-// ----------------------------------------------------------------------------
-
-void Usart::initialize_frg0()
-{
-    constexpr int32_t main_clk_freq = System::get_main_clock_frequency(XARMLIB_SYSTEM_CLOCK);
-    constexpr int32_t usart_freq = get_max_standard_frequency(main_clk_freq);
-
-    constexpr uint8_t mul = get_frg_mul(usart_freq, main_clk_freq);
-    constexpr uint8_t div = 0xFF; // Fixed value to use with the fractional baudrate generator
-
-    // Select main clock as the source for FRG0
-    Clock::set_frg_clock_source(Clock::FrgClockSelect::FRG0, Clock::FrgClockSource::MAIN_CLK);
-
-    // Set the FRG0 fractional divider
-    Clock::set_frg_clock_divider(Clock::FrgClockSelect::FRG0, mul, div);
-}
-
-
-
-
-int32_t Usart::get_baudrate_generator_div(const int32_t baudrate)
-{
-    constexpr int32_t main_clk_freq = System::get_main_clock_frequency(XARMLIB_SYSTEM_CLOCK);
-    constexpr int32_t usart_freq = get_max_standard_frequency(main_clk_freq);
-
-    return usart_freq / 16 / baudrate;
-}
-
-
-
-
-} // namespace lpc84x
-} // namespace targets
-} // namespace xarmlib
-
-
-
-
 using namespace xarmlib::targets::lpc84x;
 
 // ----------------------------------------------------------------------------
 // IRQ HANDLERS
 // ----------------------------------------------------------------------------
 
-extern "C" void USART0_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void USART0_IRQHandler(void)
 {
     const int32_t yield = Usart::irq_handler(Usart::Name::USART0);
 
@@ -107,7 +56,7 @@ extern "C" void USART0_IRQHandler(void)
 
 
 
-extern "C" void USART1_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void USART1_IRQHandler(void)
 {
     const int32_t yield = Usart::irq_handler(Usart::Name::USART1);
 
@@ -123,7 +72,7 @@ extern "C" void USART1_IRQHandler(void)
 
 #ifdef __LPC845__
 
-extern "C" void USART2_IRQHandler(void)
+extern "C" __TARGET_IRQ_RAMFUNC void USART2_IRQHandler(void)
 {
     const int32_t yield = Usart::irq_handler(Usart::Name::USART2);
 
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+# ----------------------------------------------------------------------------
+# @file    binary_log_decoder.py
+# @brief   Host decoder for the records sent by the BinaryLogger API class.
+# @date    15 July 2018
+# ----------------------------------------------------------------------------
+#
+# Xarmlib 0.1.0 - https://github.com/hparracho/Xarmlib
+# Copyright (c) 2018 Helder Parracho (hparracho@gmail.com)
+#
+# See README.md file for additional credits and acknowledgments.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+#
+# ----------------------------------------------------------------------------
+#
+# Usage: binary_log_decoder.py firmware.elf log_stream
+#
+# The format strings are read from the '.xarmlib_log' section of the ELF file
+# (record format described in include/api/api_binary_logger.hpp). The log
+# stream is any file holding the received bytes: a capture file or a serial
+# port already configured with stty (e.g. /dev/ttyUSB0).
+
+import re
+import struct
+import sys
+
+SECTION_NAME = '.xarmlib_log'
+SYNC_BYTE    = 0xA5
+
+INT32, INT64, FLOAT, DOUBLE = range(4)
+ARGUMENT_SIZES = { INT32: 4, INT64: 8, FLOAT: 4, DOUBLE: 8 }
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|j|z|t|L)?([diouxXcfFeEgGaAp%])')
+
+
+
+
+def read_strings_section(elf_path):
+    with open(elf_path, 'rb') as elf_file:
+        elf = elf_file.read()
+
+    if elf[0:4] != b'\x7fELF' or elf[5] != 1:
+        raise ValueError('not a little endian ELF file')
+
+    if elf[4] == 1:
+        shoff, = struct.unpack_from('<I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2E)
+        section_header = '<IIIIIIIIII'
+    else:
+        shoff, = struct.unpack_from('<Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x3A)
+        section_header = '<IIQQQQIIQQ'
+
+    sections = [struct.unpack_from(section_header, elf, shoff + index * shentsize) for index in range(shnum)]
+    names_offset = sections[shstrndx][4]
+
+    for name, _, _, _, offset, size, _, _, _, _ in sections:
+        section_name = elf[names_offset + name:elf.index(b'\0', names_offset + name)].decode()
+
+        if section_name == SECTION_NAME:
+            return elf[offset:offset + size]
+
+    raise ValueError('section ' + SECTION_NAME + ' not found')
+
+
+
+
+def get_format_string(strings, string_id):
+    if string_id >= len(strings):
+        return None
+
+    return strings[string_id:strings.index(b'\0', string_id)].decode(errors='replace')
+
+
+
+
+def format_message(format_string, arguments):
+    remaining = list(arguments)
+
+    def convert(match):
+        flags, _, conversion = match.groups()
+
+        if conversion == '%':
+            return '%'
+
+        if not remaining:
+            return '<missing>'
+
+        argument_type, value = remaining.pop(0)
+
+        if conversion in 'di':
+            return ('%' + flags + 'd') % value
+
+        if conversion in 'ouxX':
+            bits = 64 if argument_type == INT64 else 32
+            return ('%' + flags + conversion.replace('u', 'd')) % (value & ((1 << bits) - 1))
+
+        if conversion == 'c':
+            return chr(value & 0xFF)
+
+        if conversion == 'p':
+            return '0x%08x' % (value & 0xFFFFFFFFFFFFFFFF)
+
+        return ('%' + flags + conversion) % value
+
+    return CONVERSION.sub(convert, format_string)
+
+
+
+
+def decode_records(strings, stream):
+    data       = bytearray()
+    last_low   = 0
+    high       = 0
+
+    while True:
+        chunk = stream.read(256)
+
+        if chunk:
+            data += chunk
+
+        while True:
+            start = data.find(SYNC_BYTE)
+
+            if start < 0:
+                data.clear()
+                break
+
+            del data[:start]
+
+            if len(data) < 9:
+                break
+
+            header, timestamp = struct.unpack_from('<II', data, 1)
+            string_id = header & 0xFFFF
+            count     = (header >> 16) & 0x07
+            types     = [(header >> (19 + index * 2)) & 0x03 for index in range(count)]
+            size      = 9 + sum(ARGUMENT_SIZES[argument_type] for argument_type in types) + 1
+
+            format_string = get_format_string(strings, string_id)
+
+            if count > 6 or (header >> 31) != 0 or format_string is None:
+                # Not a record start
+                del data[:1]
+                continue
+
+            if len(data) < size:
+                break
+
+            if sum(data[1:size - 1]) & 0xFF != data[size - 1]:
+                del data[:1]
+                continue
+
+            arguments = []
+            offset    = 9
+
+            for argument_type in types:
+                if argument_type == INT32:
+                    value, = struct.unpack_from('<i', data, offset)
+                elif argument_type == INT64:
+                    value, = struct.unpack_from('<q', data, offset)
+                elif argument_type == FLOAT:
+                    value, = struct.unpack_from('<f', data, offset)
+                else:
+                    value, = struct.unpack_from('<d', data, offset)
+
+                arguments.append((argument_type, value))
+                offset += ARGUMENT_SIZES[argument_type]
+
+            del data[:size]
+
+            # Extend the 32 bit microseconds timestamp (only a large backward
+            # step is a wrap around, not a slightly out of order record)
+            if last_low - timestamp > 1 << 31:
+                high += 1 << 32
+            last_low = timestamp
+
+            yield (high | timestamp, format_message(format_string, arguments))
+
+        if not chunk:
+            break
+
+
+
+
+def main():
+    if len(sys.argv) != 3:
+        print('Usage: ' + sys.argv[0] + ' firmware.elf log_stream', file=sys.stderr)
+        return 1
+
+    strings = read_strings_section(sys.argv[1])
+
+    with open(sys.argv[2], 'rb', buffering=0) as stream:
+        for timestamp, message in decode_records(strings, stream):
+            print('[%12.6f] %s' % (timestamp / 1e6, message), flush=True)
+
+    return 0
+
+
+
+
+if __name__ == '__main__':
+    sys.exit(main())